@@ -4,16 +4,17 @@
  *
  * @brief Demonstrates the parameter registry for generic, type-agnostic operations.
  *
- * The registry (g_nvsconfig_params[]) provides a vtable for every parameter,
- * enabling code that works on all parameters without knowing their concrete
- * types at compile time.
+ * The registry (g_nvsconfig_params[]) describes every parameter and the
+ * NvsConfig_*ByIndex() functions operate on any of them, enabling code that
+ * works on all parameters without knowing their concrete types at compile
+ * time. Both work with or without CONFIG_NVS_CONFIG_GENERIC_ENGINE.
  *
  * This example shows:
  *   1. Iterating all parameters and printing metadata + values
  *   2. Looking up a parameter by name
- *   3. Setting a value via the generic set(void*, size) interface
+ *   3. Setting a value via the generic SetByIndex(void*, size) interface
  *   4. Resetting all parameters to defaults in one call
- *   5. Checking dirty/default flags through the vtable
+ *   5. Listing only dirty / non-default parameters with the bitset iterators
  */
 
 #include <stdio.h>
@@ -46,7 +47,7 @@ void app_main(void)
     for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
         const NvsConfigParamEntry_t *p = &g_nvsconfig_params[i];
 
-        p->print(buf, sizeof(buf));
+        NvsConfig_PrintByIndex((NvsConfigParamIndex_t)i, buf, sizeof(buf));
         ESP_LOGI(TAG, "[%d] %-12s = %-20s  type=%s  elem_size=%d  count=%d  desc=\"%s\"",
                  (int)i,
                  p->name,
@@ -61,13 +62,13 @@ void app_main(void)
     ESP_LOGI(TAG, "");
     ESP_LOGI(TAG, "--- Find by name ---");
 
-    const NvsConfigParamEntry_t *vol = NvsConfig_FindParam("Volume");
-    if (vol) {
-        vol->print(buf, sizeof(buf));
+    const NvsConfigParamIndex_t vol = NvsConfig_Resolve("Volume");
+    if (vol < PARAM_INDEX_COUNT) {
+        NvsConfig_PrintByIndex(vol, buf, sizeof(buf));
         ESP_LOGI(TAG, "Found 'Volume': value=%s, is_default=%s, is_dirty=%s",
                  buf,
-                 vol->is_default() ? "yes" : "no",
-                 vol->is_dirty() ? "yes" : "no");
+                 NvsConfig_IsDefaultByIndex(vol) ? "yes" : "no",
+                 NvsConfig_IsDirtyByIndex(vol) ? "yes" : "no");
     }
 
     const NvsConfigParamEntry_t *missing = NvsConfig_FindParam("NonExistent");
@@ -75,38 +76,38 @@ void app_main(void)
 
     /* --- 3. Generic set via void pointer --- */
     ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "--- Generic set() via void* ---");
+    ESP_LOGI(TAG, "--- Generic SetByIndex() via void* ---");
 
     // Set a scalar: Volume = 90
     uint8_t new_volume = 90;
-    err = vol->set(&new_volume, sizeof(new_volume));
+    err = NvsConfig_SetByIndex(vol, &new_volume, sizeof(new_volume));
     ESP_LOGI(TAG, "Set Volume to 90: %s", esp_err_to_name(err));
-    vol->print(buf, sizeof(buf));
+    NvsConfig_PrintByIndex(vol, buf, sizeof(buf));
     ESP_LOGI(TAG, "Volume is now: %s", buf);
 
     // Set an array: RGBColor = {0, 255, 128}
-    const NvsConfigParamEntry_t *rgb = NvsConfig_FindParam("RGBColor");
-    if (rgb) {
+    const NvsConfigParamIndex_t rgb = NvsConfig_Resolve("RGBColor");
+    if (rgb < PARAM_INDEX_COUNT) {
         uint8_t new_color[3] = {0, 255, 128};
-        err = rgb->set(new_color, sizeof(new_color));
+        err = NvsConfig_SetByIndex(rgb, new_color, sizeof(new_color));
         ESP_LOGI(TAG, "Set RGBColor to {0, 255, 128}: %s", esp_err_to_name(err));
-        rgb->print(buf, sizeof(buf));
+        NvsConfig_PrintByIndex(rgb, buf, sizeof(buf));
         ESP_LOGI(TAG, "RGBColor is now: %s", buf);
     }
 
     /* --- 4. Generic get via void pointer --- */
     ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "--- Generic get() via void* ---");
+    ESP_LOGI(TAG, "--- Generic GetByIndex() via void* ---");
 
     // Read a scalar back into a typed buffer without knowing the name at compile time.
     uint8_t volume_copy = 0;
-    err = vol->get(&volume_copy, sizeof(volume_copy));
+    err = NvsConfig_GetByIndex(vol, &volume_copy, sizeof(volume_copy));
     ESP_LOGI(TAG, "Get Volume: %s -> %u", esp_err_to_name(err), (unsigned)volume_copy);
 
     // Read an array back into a local buffer.
-    if (rgb) {
+    if (rgb < PARAM_INDEX_COUNT) {
         uint8_t color_copy[3] = {0};
-        err = rgb->get(color_copy, sizeof(color_copy));
+        err = NvsConfig_GetByIndex(rgb, color_copy, sizeof(color_copy));
         ESP_LOGI(TAG, "Get RGBColor: %s -> {%u, %u, %u}",
                  esp_err_to_name(err),
                  (unsigned)color_copy[0],
@@ -115,22 +116,25 @@ void app_main(void)
 
         // A buffer smaller than the array yields a partial read (ESP_ERR_INVALID_SIZE).
         uint8_t partial[2] = {0};
-        err = rgb->get(partial, sizeof(partial));
+        err = NvsConfig_GetByIndex(rgb, partial, sizeof(partial));
         ESP_LOGI(TAG, "Get RGBColor (partial 2 of 3): %s -> {%u, %u}",
                  esp_err_to_name(err),
                  (unsigned)partial[0],
                  (unsigned)partial[1]);
     }
 
-    /* --- 5. Check flags --- */
+    /* --- 5. Walk only the changed parameters --- */
     ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "--- Dirty/default flags after changes ---");
-    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
-        const NvsConfigParamEntry_t *p = &g_nvsconfig_params[i];
-        ESP_LOGI(TAG, "  %-12s  dirty=%s  default=%s",
-                 p->name,
-                 p->is_dirty() ? "yes" : "no",
-                 p->is_default() ? "yes" : "no");
+    ESP_LOGI(TAG, "--- Dirty parameters (unsaved) ---");
+    for (size_t i = NvsConfig_NextDirty(0); i < g_nvsconfig_param_count; i = NvsConfig_NextDirty(i + 1)) {
+        NvsConfig_PrintByIndex((NvsConfigParamIndex_t)i, buf, sizeof(buf));
+        ESP_LOGI(TAG, "  %-12s = %s", g_nvsconfig_params[i].name, buf);
+    }
+
+    ESP_LOGI(TAG, "--- Non-default parameters ---");
+    for (size_t i = NvsConfig_NextNonDefault(0); i < g_nvsconfig_param_count; i = NvsConfig_NextNonDefault(i + 1)) {
+        NvsConfig_PrintByIndex((NvsConfigParamIndex_t)i, buf, sizeof(buf));
+        ESP_LOGI(TAG, "  %-12s = %s", g_nvsconfig_params[i].name, buf);
     }
 
     /* --- 6. Reset all --- */
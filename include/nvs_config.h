@@ -9,15 +9,16 @@
  *   - Initializing the NVS flash storage and handling necessary erasures.
  *   - Loading configuration parameters using macros defined in an external parameter table (param_table.inc).
  *   - Marking parameters as “dirty” if their values are modified relative to defaults.
- *   - Periodically saving any modified parameters using a FreeRTOS timer to ensure persistence.
+ *   - Saving modified parameters from a background task shortly after they change.
  *   - Managing security levels for accessing or modifying parameters.
  *
- * The library utilizes two macro definitions:
+ * The library utilizes three macro definitions:
  *   - PARAM: For standard configuration parameters.
  *   - ARRAY: For configuration parameters that are arrays.
+ *   - STRING: For bounded, NUL-terminated string parameters.
  *
  * These macros create structure definitions for storing the parameters, and also generate prototype functions
- * for setting, getting, copying (for arrays), and resetting default values.
+ * for setting, getting, copying (for arrays and strings), and resetting default values.
  *
  * @note The actual parameter definitions and associated functions are further generated from "param_table.inc",
  *       making it easy to expand or customize the configuration parameters without modifying the core library code.
@@ -34,6 +35,7 @@
 #include <string.h>
 
 #include "esp_err.h"
+#include "sdkconfig.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,14 +50,27 @@ extern "C" {
  *    Each parameter is loaded from flash; if unavailable, it is set to its default value and marked as dirty.
  *  - Closes the NVS handle after reading.
  *  - Calls a function to save any dirty parameters.
- *  - Creates and starts a periodic FreeRTOS timer (30 seconds interval) to trigger saving of dirty parameters.
+ *  - Creates the background save task (once). The task sleeps until a parameter becomes dirty, then
+ *    saves once no change has arrived for CONFIG_NVS_CONFIG_SAVE_QUIET_MS, the oldest unsaved change
+ *    is CONFIG_NVS_CONFIG_SAVE_MAX_LATENCY_MS old, or CONFIG_NVS_CONFIG_SAVE_DIRTY_BYTES are dirty.
+ *    After a failed save it retries once per quiet period, ignoring the byte threshold until a save
+ *    succeeds or another change arrives.
+ *    While nothing is dirty it blocks without a timeout, so it never wakes the chip.
  *
- * @return esp_err_t ESP_OK if initialization and timer creation were successful; otherwise, ESP_FAIL.
+ * @return esp_err_t ESP_OK if initialization and task creation were successful; otherwise, ESP_FAIL.
  */
 esp_err_t NvsConfig_Init(void);
 
 /**
  * @brief Identifies parameters that have been modified (marked as dirty) and saves them to nvs
+ *
+ * The save runs in two phases so getters and setters are not stalled by flash I/O:
+ *  - Dirty values are copied into a staging buffer while holding the config mutex.
+ *  - The staged values are written and committed without holding the config mutex.
+ * Afterwards a parameter's dirty flag is only cleared if it was not written again
+ * while the flash I/O ran; otherwise the newer value is picked up by the next save.
+ * Dirty values that already match what is on flash are not rewritten; see
+ * NvsConfig_GetSuppressedWriteCount().
  */
 void NvsConfig_SaveDirtyParameters(void);
 
@@ -77,65 +92,196 @@ esp_err_t NvsConfig_SecureLevelChange(uint8_t new_secure_level);
 /*
  * @brief Non-Volatile Storage (NVS) Configuration Macros and Master Controller.
  *
+ * The controller only holds what changes at run time. Everything fixed at
+ * compile time lives in const tables that stay in flash: defaults in
+ * g_nvsconfig_defaults, and name, NVS key, sizes and security level in the
+ * g_nvsconfig_params registry. Dirty and default status live in internal
+ * bitsets; query them through the registry or the NvsConfig_NextDirty() /
+ * NvsConfig_NextNonDefault() iterators.
+ *
  * - PARAM:
- *   Creates a structure representing a single configuration parameter.
- *   The structure contains a secure level, parameter name, current value,
- *   default value, status flags (is_dirty and is_default), and a constant key.
+ *   The current value of a single configuration parameter.
  *
  * - ARRAY:
- *   Similar to PARAM, but designed for parameters that are arrays.
- *   In addition to the fields in PARAM, it includes a size field and
- *   appropriately sized arrays for both the current and default values.
+ *   The current elements of an array parameter.
+ *
+ * - STRING:
+ *   A NUL-terminated string of at most maxlen characters in a buffer of
+ *   maxlen + 1 bytes. Bytes after the terminator are always zero. The length
+ *   is tracked internally, so that compare, copy, print and storage only
+ *   touch the characters in use.
+ *
+ * Every member has the size and alignment of its value, so the controller
+ * has the same layout as NvsConfigValues_t and snapshots are a single copy.
+ * Members follow param_table.inc, or with CONFIG_NVS_CONFIG_LAYOUT_SORTED,
+ * are grouped by size (see nvs_config_layout.inc) to remove the padding
+ * between them.
+ */
+
+/**
+ * @brief Size class of each value type param_table.inc may use: expands to
+ *        the argument for its size in bytes (8, 4, 2 or 1).
  */
+#define _NVS_SIZE_CLASS_char(s8_, s4_, s2_, s1_)     s1_
+#define _NVS_SIZE_CLASS_bool(s8_, s4_, s2_, s1_)     s1_
+#define _NVS_SIZE_CLASS_int8_t(s8_, s4_, s2_, s1_)   s1_
+#define _NVS_SIZE_CLASS_uint8_t(s8_, s4_, s2_, s1_)  s1_
+#define _NVS_SIZE_CLASS_int16_t(s8_, s4_, s2_, s1_)  s2_
+#define _NVS_SIZE_CLASS_uint16_t(s8_, s4_, s2_, s1_) s2_
+#define _NVS_SIZE_CLASS_int32_t(s8_, s4_, s2_, s1_)  s4_
+#define _NVS_SIZE_CLASS_uint32_t(s8_, s4_, s2_, s1_) s4_
+#define _NVS_SIZE_CLASS_float(s8_, s4_, s2_, s1_)    s4_
+#define _NVS_SIZE_CLASS_int64_t(s8_, s4_, s2_, s1_)  s8_
+#define _NVS_SIZE_CLASS_uint64_t(s8_, s4_, s2_, s1_) s8_
+#define _NVS_SIZE_CLASS_double(s8_, s4_, s2_, s1_)   s8_
+
+#if CONFIG_NVS_CONFIG_LAYOUT_SORTED
+#define _NVS_LAYOUT_SCALAR(type_, name_) \
+    struct {                             \
+        type_ value;                     \
+    } name_;
+#define _NVS_LAYOUT_ARRAY(type_, count_, name_) \
+    struct {                                    \
+        type_ value[count_];                    \
+    } name_;
+typedef struct ParamMasterControl_s {
+#include "nvs_config_layout.inc"
+} NvsConfigMasterController_t;
+#undef _NVS_LAYOUT_SCALAR
+#undef _NVS_LAYOUT_ARRAY
+#else
 #define PARAM(secure_lvl_, type_, name_, default_value_, description_) \
     struct {                                                           \
-        const uint8_t secure_level;                                    \
-        const char* name;                                              \
         type_ value;                                                   \
-        const type_ default_value;                                     \
-        bool is_dirty;                                                 \
-        bool is_default;                                               \
-        const char* const key;                                         \
     } name_;
 #define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) \
     struct {                                                                  \
-        const uint8_t secure_level;                                           \
-        const char* name;                                                     \
         type_ value[size_];                                                   \
-        const size_t size;                                                    \
-        const type_ default_value[size_];                                     \
-        bool is_dirty;                                                        \
-        bool is_default;                                                      \
-        const char* const key;                                                \
+    } name_;
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_) \
+    struct {                                                              \
+        char value[(maxlen_) + 1];                                        \
     } name_;
 typedef struct ParamMasterControl_s {
 #include "param_table.inc"
 } NvsConfigMasterController_t;
 #undef PARAM
 #undef ARRAY
+#undef STRING
+#endif
 
 /**
  * Global Non-Volatile Storage configuration controller.
  *
- * This variable holds program settings in SRAM. upon calling NvsConfig_Init, it
- * loads settings from NVS Flash; if not present, default values are used.
+ * This variable holds the current values in SRAM. upon calling NvsConfig_Init,
+ * it loads settings from NVS Flash; if not present, default values are used.
  */
 extern NvsConfigMasterController_t g_nvsconfig_controller;
 
+/**
+ * @brief Parameter index, one enumerator per entry of param_table.inc.
+ *
+ * PARAM_INDEX_<name> is the position of the parameter in g_nvsconfig_params
+ * and serves as a handle for the *ByIndex functions below, so a name only has
+ * to be resolved once (at compile time, or with NvsConfig_Resolve() at
+ * startup). PARAM_INDEX_COUNT is the number of parameters and doubles as the
+ * "not found" value.
+ */
+typedef enum {
+#define PARAM(s, t, name, d, desc)      PARAM_INDEX_##name,
+#define ARRAY(s, t, sz, name, d, desc)  PARAM_INDEX_##name,
+#define STRING(s, len, name, d, desc)   PARAM_INDEX_##name,
+#include "param_table.inc"
+#undef PARAM
+#undef ARRAY
+#undef STRING
+    PARAM_INDEX_COUNT
+} NvsConfigParamIndex_t;
+
+/**
+ * @brief Plain mirror of NvsConfigMasterController_t.
+ *
+ * One field per parameter, in the same order and at the same offsets as the
+ * controller. Filled by NvsConfig_Snapshot() to read many parameters
+ * consistently at once, and the layout of g_nvsconfig_defaults and of the
+ * packed storage image.
+ */
+#if CONFIG_NVS_CONFIG_LAYOUT_SORTED
+#define _NVS_LAYOUT_SCALAR(type_, name_)        type_ name_;
+#define _NVS_LAYOUT_ARRAY(type_, count_, name_) type_ name_[count_];
+typedef struct {
+#include "nvs_config_layout.inc"
+} NvsConfigValues_t;
+#undef _NVS_LAYOUT_SCALAR
+#undef _NVS_LAYOUT_ARRAY
+#else
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_) type_ name_;
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) type_ name_[size_];
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)    char name_[(maxlen_) + 1];
+typedef struct {
+#include "param_table.inc"
+} NvsConfigValues_t;
+#undef PARAM
+#undef ARRAY
+#undef STRING
+#endif
+
+/**
+ * @brief Default value of every parameter, in the NvsConfigValues_t layout.
+ *
+ * Const, so it is placed in flash rather than RAM.
+ */
+extern const NvsConfigValues_t g_nvsconfig_defaults;
+
+/**
+ * @brief Value types param_table.inc may use, as X(type, Name), in the order
+ *        of src/format.inc. Name is used in the typed *ByIndex functions.
+ */
+#define NVS_CONFIG_TYPES(X) \
+    X(char, Char)           \
+    X(bool, Bool)           \
+    X(int8_t, I8)           \
+    X(uint8_t, U8)          \
+    X(int16_t, I16)         \
+    X(uint16_t, U16)        \
+    X(int32_t, I32)         \
+    X(uint32_t, U32)        \
+    X(int64_t, I64)         \
+    X(uint64_t, U64)        \
+    X(float, Float)         \
+    X(double, Double)
+
+/** Element type of a parameter, NVS_CONFIG_TYPE_<type>; strings use NVS_CONFIG_TYPE_char. */
+typedef enum {
+#define _NVS_TYPE_ENUM(type_, name_) NVS_CONFIG_TYPE_##type_,
+    NVS_CONFIG_TYPES(_NVS_TYPE_ENUM)
+#undef _NVS_TYPE_ENUM
+    NVS_CONFIG_TYPE_COUNT
+} NvsConfigType_t;
+
 /**
  * @brief Parameter registry entry with function pointers for runtime introspection.
  *
  * Each parameter in param_table.inc gets one entry in the global registry array.
  * This enables generic iteration, lookup-by-name, and polymorphic operations
  * without knowing the parameter's concrete type at the call site.
+ *
+ * With CONFIG_NVS_CONFIG_GENERIC_ENGINE the entry only describes the
+ * parameter and has no function pointers. NvsConfig_IsDirtyByIndex(),
+ * NvsConfig_IsDefaultByIndex(), NvsConfig_ResetByIndex(),
+ * NvsConfig_PrintByIndex(), NvsConfig_SetByIndex() and NvsConfig_GetByIndex()
+ * do the same in either mode.
  */
 typedef struct {
     const char* name;
     const char* description;
     uint8_t secure_level;
     bool is_array;
+    bool is_string;         /**< STRING parameter; element_size is 1 */
+    NvsConfigType_t type;   /**< Type of one element; parse, print and store can switch on it */
     size_t element_size;    /**< sizeof(type) for one element */
-    size_t element_count;   /**< 1 for scalars, array size for arrays */
+    size_t element_count;   /**< 1 for scalars, array size for arrays, maxlen + 1 for strings */
+#if !CONFIG_NVS_CONFIG_GENERIC_ENGINE
     bool (*is_dirty)(void);
     bool (*is_default)(void);
     esp_err_t (*reset)(void);
@@ -150,6 +296,9 @@ typedef struct {
      *              is returned as a warning (the write still occurs).
      *              If data_size > full array size, ESP_ERR_INVALID_SIZE is returned
      *              and no write occurs.
+     * For strings: data points to the characters, which end at the first NUL
+     *              or after data_size bytes. More than maxlen characters
+     *              return ESP_ERR_INVALID_SIZE and no write occurs.
      *
      * @param data      Pointer to the value(s) to write.
      * @param data_size Total size in bytes of the data pointed to.
@@ -169,6 +318,9 @@ typedef struct {
      *              (extra space in data is left untouched). If data_size < the full
      *              array size, only data_size bytes are copied (partial read) and
      *              ESP_ERR_INVALID_SIZE is returned as a warning.
+     * For strings: the string and its terminator are copied. If it does not
+     *              fit, it is truncated to data_size - 1 characters and
+     *              ESP_ERR_INVALID_SIZE is returned as a warning.
      *
      * Reads are not gated by the security level.
      *
@@ -178,6 +330,7 @@ typedef struct {
      *         or an array partial read (warning).
      */
     esp_err_t (*get)(void* data, size_t data_size);
+#endif
 } NvsConfigParamEntry_t;
 
 /** Array of registry entries, one per parameter (order matches param_table.inc). */
@@ -193,6 +346,132 @@ extern const size_t g_nvsconfig_param_count;
  */
 const NvsConfigParamEntry_t* NvsConfig_FindParam(const char* name);
 
+/**
+ * @brief Resolve a parameter name to its index.
+ *
+ * Intended to be called once at startup; the result can then be passed to the
+ * *ByIndex functions or used as g_nvsconfig_params[idx] without further
+ * string handling.
+ *
+ * @param name The parameter name (case-sensitive).
+ * @return The parameter's index, or PARAM_INDEX_COUNT if not found.
+ */
+NvsConfigParamIndex_t NvsConfig_Resolve(const char* name);
+
+/**
+ * @brief Copy a parameter value by index.
+ *
+ * Same contract as NvsConfigParamEntry_t::get().
+ *
+ * @param idx       Parameter index.
+ * @param data      Destination buffer.
+ * @param data_size Size in bytes of @p data.
+ * @return The get() result, or ESP_ERR_INVALID_ARG for an out-of-range index
+ *         or NULL @p data.
+ */
+esp_err_t NvsConfig_GetByIndex(NvsConfigParamIndex_t idx, void* data, size_t data_size);
+
+/**
+ * @brief Set a parameter value by index.
+ *
+ * Same contract as NvsConfigParamEntry_t::set().
+ *
+ * @param idx       Parameter index.
+ * @param data      Value(s) to write.
+ * @param data_size Size in bytes of @p data.
+ * @return The set() result, or ESP_ERR_INVALID_ARG for an out-of-range index
+ *         or NULL @p data.
+ */
+esp_err_t NvsConfig_SetByIndex(NvsConfigParamIndex_t idx, const void* data, size_t data_size);
+
+/**
+ * @brief Whether a parameter has unsaved changes, by index.
+ *
+ * Same as NvsConfigParamEntry_t::is_dirty().
+ *
+ * @return false for an out-of-range index.
+ */
+bool NvsConfig_IsDirtyByIndex(NvsConfigParamIndex_t idx);
+
+/**
+ * @brief Whether a parameter holds its default value, by index.
+ *
+ * Same as NvsConfigParamEntry_t::is_default().
+ *
+ * @return false for an out-of-range index.
+ */
+bool NvsConfig_IsDefaultByIndex(NvsConfigParamIndex_t idx);
+
+/**
+ * @brief Reset a parameter to its default value, by index.
+ *
+ * Same as NvsConfigParamEntry_t::reset() and Param_Reset<name>().
+ *
+ * @return ESP_OK, ESP_FAIL if the value already was the default, or
+ *         ESP_ERR_INVALID_ARG for an out-of-range index.
+ */
+esp_err_t NvsConfig_ResetByIndex(NvsConfigParamIndex_t idx);
+
+/**
+ * @brief Print a parameter value, by index.
+ *
+ * Same as NvsConfigParamEntry_t::print() and Param_Print<name>().
+ *
+ * @param idx      Parameter index.
+ * @param buf      Output buffer.
+ * @param buf_size Size of @p buf in bytes.
+ * @return The print() result, or -1 for an out-of-range index.
+ */
+int NvsConfig_PrintByIndex(NvsConfigParamIndex_t idx, char* buf, size_t buf_size);
+
+/**
+ * @brief Typed scalar access by index: NvsConfig_Set<Name>ByIndex() and
+ *        NvsConfig_Get<Name>ByIndex() for each X(type, Name) in
+ *        NVS_CONFIG_TYPES, e.g. NvsConfig_SetFloatByIndex(idx, 1.5f).
+ *
+ * The value is passed by type, so unlike NvsConfig_SetByIndex() there is no
+ * size to check and no copy through a void* buffer. The getters read without
+ * the mutex like Param_Get<name>() when CONFIG_NVS_CONFIG_LOCKFREE_GETTERS
+ * is enabled.
+ *
+ * @return Set: the Param_Set<name>() result. Get: ESP_OK. Both return
+ *         ESP_ERR_INVALID_ARG for an out-of-range index, a NULL @p out, or
+ *         a parameter that is not a scalar of that type.
+ */
+#define _NVS_TYPED_BY_INDEX(type_, name_)                                            \
+    esp_err_t NvsConfig_Set##name_##ByIndex(NvsConfigParamIndex_t idx, type_ value); \
+    esp_err_t NvsConfig_Get##name_##ByIndex(NvsConfigParamIndex_t idx, type_* out);
+NVS_CONFIG_TYPES(_NVS_TYPED_BY_INDEX)
+#undef _NVS_TYPED_BY_INDEX
+
+/**
+ * @brief Find the next parameter with unsaved changes.
+ *
+ * Scans the dirty bitset a word at a time, so walking a large table with few
+ * dirty entries costs one step per set bit rather than one per parameter:
+ * @code
+ * for (size_t i = NvsConfig_NextDirty(0); i < g_nvsconfig_param_count; i = NvsConfig_NextDirty(i + 1)) {
+ *     ESP_LOGI(TAG, "%s is dirty", g_nvsconfig_params[i].name);
+ * }
+ * @endcode
+ *
+ * @param from Index into g_nvsconfig_params to start searching at (inclusive).
+ * @return Index of the first dirty parameter at or after @p from, or
+ *         g_nvsconfig_param_count if there is none.
+ */
+size_t NvsConfig_NextDirty(size_t from);
+
+/**
+ * @brief Find the next parameter whose value differs from its default.
+ *
+ * Same iteration contract as NvsConfig_NextDirty().
+ *
+ * @param from Index into g_nvsconfig_params to start searching at (inclusive).
+ * @return Index of the first non-default parameter at or after @p from, or
+ *         g_nvsconfig_param_count if there is none.
+ */
+size_t NvsConfig_NextNonDefault(size_t from);
+
 /**
  * @brief Reset all parameters to their default values.
  */
@@ -210,17 +489,138 @@ void NvsConfig_PrintAll(void);
  */
 typedef void (*NvsConfigOnChange_t)(const char* param_name, void* user_data);
 
+/**
+ * @brief Handle for one callback registration, returned by NvsConfig_Subscribe().
+ *
+ * Handles are never reused for a later registration of the same slot, so
+ * unsubscribing twice is detected. NVS_CONFIG_SUBSCRIPTION_NONE is never a
+ * valid handle.
+ */
+typedef uint32_t NvsConfigSubscription_t;
+
+#define NVS_CONFIG_SUBSCRIPTION_NONE ((NvsConfigSubscription_t)0)
+
+/** NvsConfig_Subscribe() flag: deliver through the dispatcher task (see NvsConfig_RegisterOnChangeAsync()). */
+#define NVS_CONFIG_SUBSCRIBE_ASYNC (1u << 0)
+
+/**
+ * @brief Register a change callback and get a handle to remove it later.
+ *
+ * Registration is thread-safe and may happen at any time, including from
+ * inside a callback. Subscriptions come from a static pool of
+ * CONFIG_NVS_CONFIG_MAX_CALLBACKS entries shared by all Register and
+ * Subscribe functions.
+ *
+ * @param param_name Parameter name to watch (case-sensitive), or NULL for
+ *                   every parameter.
+ * @param cb Callback function.
+ * @param user_data Passed to callback on invocation.
+ * @param flags 0 for synchronous delivery, or NVS_CONFIG_SUBSCRIBE_ASYNC.
+ * @param[out] out_sub Receives the subscription handle; may be NULL.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the pool is exhausted,
+ *         ESP_ERR_NOT_FOUND if @p param_name is not a parameter,
+ *         ESP_ERR_INVALID_ARG if @p cb is NULL, ESP_FAIL if the dispatcher
+ *         task could not be created.
+ */
+esp_err_t NvsConfig_Subscribe(const char* param_name,
+                              NvsConfigOnChange_t cb,
+                              void* user_data,
+                              uint32_t flags,
+                              NvsConfigSubscription_t* out_sub);
+
+/**
+ * @brief One parameter change, as seen by a value subscriber.
+ *
+ * old_value and new_value each point to @c count elements of the parameter's
+ * type, starting at element @c first: the span from the first to the last
+ * element that changed (elements in between may be unchanged). Scalars have
+ * first = 0 and count = 1. Both were copied under the same lock as the write,
+ * so they describe exactly this transition even if the parameter has changed
+ * again since. The pointers are only valid during the callback. If the values
+ * could not be captured (no memory, or the subscription was added during the
+ * change), both are NULL and the span is the whole parameter.
+ */
+typedef struct {
+    NvsConfigParamIndex_t index;
+    const char* name;
+    size_t first;         /**< First element of the changed span. */
+    size_t count;         /**< Number of elements in the span. */
+    size_t element_size;  /**< sizeof one element. */
+    const void* old_value;
+    const void* new_value;
+} NvsConfigChange_t;
+
+/**
+ * @brief Callback type for value subscribers.
+ * @param change The change; valid only for the duration of the call.
+ * @param user_data User-supplied context pointer.
+ */
+typedef void (*NvsConfigOnValueChange_t)(const NvsConfigChange_t* change, void* user_data);
+
+/**
+ * @brief Register a synchronous callback that receives old and new values.
+ *
+ * Values are only captured for parameters that have a value subscriber, so
+ * other setters pay nothing. Value subscribers run in the setter's task
+ * alongside the other synchronous callbacks; async delivery coalesces
+ * changes and cannot carry a single transition, so it is not offered.
+ *
+ * @param param_name Parameter name to watch (case-sensitive), or NULL for
+ *                   every parameter.
+ * @param cb Callback function.
+ * @param user_data Passed to callback on invocation.
+ * @param[out] out_sub Receives the subscription handle; may be NULL.
+ * @return Same as NvsConfig_Subscribe().
+ */
+esp_err_t NvsConfig_SubscribeValues(const char* param_name,
+                                    NvsConfigOnValueChange_t cb,
+                                    void* user_data,
+                                    NvsConfigSubscription_t* out_sub);
+
+/**
+ * @brief Remove a subscription.
+ *
+ * Safe to call from any task, including from inside a callback. A
+ * notification already running in another task may still invoke the
+ * callback once; its slot is only reused after every such notification has
+ * finished.
+ *
+ * @param sub Handle from NvsConfig_Subscribe().
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the subscription was already removed,
+ *         ESP_ERR_INVALID_ARG for a malformed handle.
+ */
+esp_err_t NvsConfig_Unsubscribe(NvsConfigSubscription_t sub);
+
 /**
  * @brief Register a callback that fires when a specific parameter changes.
- * @param param_name Parameter name to watch (case-sensitive).
+ *
+ * The name is resolved to its index here, once; a change then only visits the
+ * parameter's own subscribers and the global ones. Per-parameter callbacks run
+ * before global callbacks, each group in registration order.
+ *
+ * @param param_name Parameter name to watch (case-sensitive), or NULL to
+ *                   register a global callback.
  * @param cb Callback function.
  * @param user_data Passed to callback on invocation.
- * @return ESP_OK on success, ESP_ERR_NO_MEM if callback slots full.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if callback slots full,
+ *         ESP_ERR_NOT_FOUND if @p param_name is not a parameter.
  */
 esp_err_t NvsConfig_RegisterOnChange(const char* param_name,
                                      NvsConfigOnChange_t cb,
                                      void* user_data);
 
+/**
+ * @brief Register a callback for a parameter identified by index.
+ * @param idx Parameter index to watch.
+ * @param cb Callback function.
+ * @param user_data Passed to callback on invocation.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if callback slots full,
+ *         ESP_ERR_INVALID_ARG for an out-of-range index.
+ */
+esp_err_t NvsConfig_RegisterOnChangeByIndex(NvsConfigParamIndex_t idx,
+                                            NvsConfigOnChange_t cb,
+                                            void* user_data);
+
 /**
  * @brief Register a callback that fires when any parameter changes.
  * @param cb Callback function.
@@ -230,11 +630,188 @@ esp_err_t NvsConfig_RegisterOnChange(const char* param_name,
 esp_err_t NvsConfig_RegisterGlobalOnChange(NvsConfigOnChange_t cb,
                                            void* user_data);
 
+/**
+ * @brief Register a callback that is delivered asynchronously.
+ *
+ * Instead of running in the setter's task, the change is queued and a
+ * dispatcher task (created on the first async registration) delivers it
+ * after CONFIG_NVS_CONFIG_CALLBACK_COALESCE_MS. Repeated changes to the same
+ * parameter within that window produce one call. Use this for slow
+ * subscribers so they do not add their run time to Param_Set*().
+ *
+ * @param param_name Parameter name to watch (case-sensitive), or NULL for
+ *                   every parameter.
+ * @param cb Callback function; runs in the dispatcher task.
+ * @param user_data Passed to callback on invocation.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if callback slots full,
+ *         ESP_ERR_NOT_FOUND if @p param_name is not a parameter, ESP_FAIL if
+ *         the dispatcher task could not be created.
+ */
+esp_err_t NvsConfig_RegisterOnChangeAsync(const char* param_name,
+                                          NvsConfigOnChange_t cb,
+                                          void* user_data);
+
+/**
+ * @brief Deliver queued async notifications now, in the caller's task.
+ *
+ * The dispatcher task calls this after each coalescing window; it can also be
+ * called directly, e.g. before sleeping. Only notifications queued when the
+ * call starts are delivered.
+ */
+void NvsConfig_DispatchPending(void);
+
+/**
+ * @brief Number of async notifications dropped because the queue was full.
+ *
+ * Counted since the last NvsConfig_ClearCallbacks(). A non-zero value means
+ * CONFIG_NVS_CONFIG_CALLBACK_QUEUE_LEN is too small for the change rate.
+ */
+uint32_t NvsConfig_GetCallbackOverflowCount(void);
+
 /**
  * @brief Remove all registered callbacks (useful for testing).
+ *
+ * Queued async notifications are discarded and the overflow count is reset.
  */
 void NvsConfig_ClearCallbacks(void);
 
+/**
+ * @brief Multi-parameter transaction.
+ *
+ * Writes staged with NvsConfig_TxnSet() are invisible until NvsConfig_Commit()
+ * applies all of them under a single s_nvs_mutex acquisition. Readers that
+ * take the mutex (array getters, registry get(), the save path) therefore see
+ * either none or all of the group, and a background save persists the group
+ * in one nvs_commit(). Change callbacks fire once per changed parameter, after
+ * the whole group has been applied and the lock released.
+ * @code
+ * NvsConfigTxn_t* txn = NvsConfig_Begin();
+ * NvsConfig_TxnSet(txn, "CalibPoints", points, sizeof(points));
+ * NvsConfig_TxnSet(txn, "CalibOffset", &offset, sizeof(offset));
+ * esp_err_t err = NvsConfig_Commit(txn);
+ * @endcode
+ */
+typedef struct NvsConfigTxn_s NvsConfigTxn_t;
+
+/**
+ * @brief Start a transaction.
+ * @return A new transaction, or NULL if it could not be allocated. It must be
+ *         finished with NvsConfig_Commit() or NvsConfig_Abort().
+ */
+NvsConfigTxn_t* NvsConfig_Begin(void);
+
+/**
+ * @brief Stage a write in a transaction.
+ *
+ * Size rules match NvsConfigParamEntry_t::set(): scalars need an exact size;
+ * a short array write zero-fills the remaining elements and returns
+ * ESP_ERR_INVALID_SIZE as a warning (the write is still staged); a string
+ * may not exceed its maxlen. Staging the same parameter again replaces the
+ * earlier value.
+ *
+ * @param txn       Transaction from NvsConfig_Begin().
+ * @param name      Parameter name (case-sensitive).
+ * @param data      Value(s) to write.
+ * @param data_size Size in bytes of @p data.
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE (see above), ESP_ERR_NOT_FOUND for an
+ *         unknown name, ESP_ERR_INVALID_STATE if the security level does not
+ *         allow writing the parameter, ESP_ERR_INVALID_ARG for NULL arguments.
+ */
+esp_err_t NvsConfig_TxnSet(NvsConfigTxn_t* txn, const char* name, const void* data, size_t data_size);
+
+/**
+ * @brief Apply every staged write atomically and free the transaction.
+ *
+ * The security level is checked again under the lock; if any staged
+ * parameter is no longer writable nothing is applied.
+ *
+ * @param txn Transaction from NvsConfig_Begin(); invalid after the call.
+ * @return ESP_OK if the group was applied (values equal to the current ones
+ *         are skipped), ESP_ERR_INVALID_STATE if the security level changed,
+ *         ESP_ERR_INVALID_ARG if @p txn is NULL.
+ */
+esp_err_t NvsConfig_Commit(NvsConfigTxn_t* txn);
+
+/**
+ * @brief Discard every staged write and free the transaction.
+ * @param txn Transaction from NvsConfig_Begin(), or NULL.
+ */
+void NvsConfig_Abort(NvsConfigTxn_t* txn);
+
+/**
+ * @brief Copy every parameter value in one critical section.
+ *
+ * The copy is consistent: it reflects the configuration between two writes,
+ * never a mix of the values before and after one (transactions included).
+ * @code
+ * NvsConfigValues_t cfg;
+ * uint32_t gen = NvsConfig_Snapshot(&cfg);
+ * build_frame(cfg.SampleRate, cfg.CalibPoints, ...);
+ * @endcode
+ *
+ * @param out Destination.
+ * @return The configuration generation the copy corresponds to. It grows
+ *         by at least one with every change (wrapping at 2^32).
+ */
+uint32_t NvsConfig_Snapshot(NvsConfigValues_t* out);
+
+/**
+ * @brief Refresh a snapshot, copying only parameters changed since @p since.
+ *
+ * @p out must hold a snapshot taken at generation @p since (by
+ * NvsConfig_Snapshot() or an earlier call to this function); afterwards it is
+ * equivalent to a full snapshot at the returned generation.
+ *
+ * @param out   Snapshot to update in place.
+ * @param since Generation of @p out.
+ * @return The new generation; equal to @p since if nothing changed.
+ */
+uint32_t NvsConfig_SnapshotSince(NvsConfigValues_t* out, uint32_t since);
+
+/**
+ * @brief Current configuration epoch, a single atomic load.
+ *
+ * Advances with every change to any parameter, so an unchanged epoch means
+ * nothing changed. Generations are the epoch values at which parameters
+ * last changed, and wrap at 2^32. Take the epoch before reading values so
+ * that a change made while reading is seen on the next check:
+ * @code
+ * static uint32_t seen;
+ * static const NvsConfigParamIndex_t deps[] = {PARAM_INDEX_SampleRate, PARAM_INDEX_CalibOffset};
+ * if (NvsConfig_AnyChangedSince(deps, 2, seen)) {
+ *     seen = NvsConfig_Epoch();
+ *     rate = Param_GetSampleRate();
+ *     offset = Param_GetCalibOffset();
+ * }
+ * @endcode
+ */
+uint32_t NvsConfig_Epoch(void);
+
+/**
+ * @brief Epoch at which a parameter last changed (0 if never since boot).
+ * @param idx Parameter index.
+ * @return The generation, or 0 for an out-of-range index.
+ */
+uint32_t NvsConfig_GetGeneration(NvsConfigParamIndex_t idx);
+
+/**
+ * @brief Whether a parameter changed after generation @p gen. Lock-free.
+ * @param idx Parameter index.
+ * @param gen An epoch previously returned by NvsConfig_Epoch() or a snapshot.
+ */
+bool NvsConfig_ChangedSince(NvsConfigParamIndex_t idx, uint32_t gen);
+
+/**
+ * @brief Whether any of a set of parameters changed after generation @p gen.
+ *
+ * Returns after one load when nothing at all has changed. Lock-free.
+ *
+ * @param indices Parameter indices to test.
+ * @param count   Number of entries in @p indices.
+ * @param gen     An epoch previously returned by NvsConfig_Epoch() or a snapshot.
+ */
+bool NvsConfig_AnyChangedSince(const NvsConfigParamIndex_t* indices, size_t count, uint32_t gen);
+
 /**
  * @brief Get the number of successful writes to a parameter since init.
  * @param name Parameter name (case-sensitive).
@@ -242,6 +819,13 @@ void NvsConfig_ClearCallbacks(void);
  */
 uint32_t NvsConfig_GetWriteCount(const char* name);
 
+/**
+ * @brief Get the number of successful writes to a parameter since init.
+ * @param idx Parameter index.
+ * @return Write count, or 0 for an out-of-range index.
+ */
+uint32_t NvsConfig_GetWriteCountByIndex(NvsConfigParamIndex_t idx);
+
 /**
  * @brief Get the total number of successful writes across all parameters.
  * @return Sum of all per-parameter write counts.
@@ -249,7 +833,31 @@ uint32_t NvsConfig_GetWriteCount(const char* name);
 uint32_t NvsConfig_GetTotalWriteCount(void);
 
 /**
- * @brief Reset all write counters to zero (useful for testing).
+ * @brief Get the number of flash writes skipped for a parameter since init.
+ *
+ * A save skips a dirty parameter whose value already matches what is on
+ * flash (e.g. it went A -> B -> A, or was reset to the stored value).
+ *
+ * @param name Parameter name (case-sensitive).
+ * @return Suppressed write count, or 0 if parameter not found.
+ */
+uint32_t NvsConfig_GetSuppressedWriteCount(const char* name);
+
+/**
+ * @brief Get the number of flash writes skipped for a parameter since init.
+ * @param idx Parameter index.
+ * @return Suppressed write count, or 0 for an out-of-range index.
+ */
+uint32_t NvsConfig_GetSuppressedWriteCountByIndex(NvsConfigParamIndex_t idx);
+
+/**
+ * @brief Get the total number of suppressed flash writes across all parameters.
+ * @return Sum of all per-parameter suppressed write counts.
+ */
+uint32_t NvsConfig_GetTotalSuppressedWriteCount(void);
+
+/**
+ * @brief Reset all write and suppressed-write counters to zero (useful for testing).
  */
 void NvsConfig_ResetWriteCounts(void);
 
@@ -300,10 +908,150 @@ uint32_t NvsConfig_GetSchemaVersion(void);
  *
  * - The ARRAY macro creates functions for array parameters:
  *     • Param_Set<name> to set an array of values with its length.
- *     • Param_Get<name> to retrieve the array and its length.
+ *     • Param_Get<name> to retrieve the array and its length. The pointer
+ *       refers to live storage and is not protected against concurrent
+ *       setters; use Param_Acquire<name> or Param_Copy<name> instead when
+ *       another task may write the array.
  *     • Param_Copy<name> to copy array contents into a provided buffer.
+ *     • Param_SetElement<name> / Param_SetRange<name> to update single
+ *       elements or a contiguous range; only the touched elements are
+ *       compared and copied, and only their chunks are marked dirty.
+ *     • Param_GetRange<name> to copy a contiguous range of elements.
+ *     • Param_Acquire<name> / Param_Release<name> to read the array in place
+ *       without copying. Acquire returns with the config mutex held, so no
+ *       setter, reset, commit or save can modify the array until Release.
+ *       Keep the section short and do not call other Param_* or NvsConfig_*
+ *       functions that take the mutex (setters, Copy, Print, Acquire) inside it.
  *     • Param_Reset<name> to reset the array to its default.
+ *
+ * - The STRING macro creates functions for string parameters:
+ *     • Param_Set<name> to set the string from a NUL-terminated value;
+ *       ESP_ERR_INVALID_SIZE if it is longer than maxlen.
+ *     • Param_Get<name> to retrieve the string and its length. Like the
+ *       array getter, the pointer refers to live storage, which a concurrent
+ *       setter rewrites in place; use Param_Acquire<name> or Param_Copy<name>
+ *       instead when another task may write the string.
+ *     • Param_Copy<name> to copy the string and its terminator into a buffer.
+ *     • Param_Acquire<name> / Param_Release<name> to read the string in place
+ *       with the config mutex held, under the same rules as for arrays.
+ *     • Param_Reset<name> to reset the string to its default.
+ */
+/*
+ * Table-driven scalar access behind the typed *ByIndex functions and, with
+ * CONFIG_NVS_CONFIG_GENERIC_ENGINE, the Param_* wrappers below.
  */
+esp_err_t _nvsconfig_set_scalar(NvsConfigParamIndex_t idx, const void* value);
+void _nvsconfig_get_scalar(NvsConfigParamIndex_t idx, void* out);
+
+#if CONFIG_NVS_CONFIG_GENERIC_ENGINE
+/*
+ * Table-driven mode: the Param_* functions are inline wrappers that pass
+ * PARAM_INDEX_<name> to one implementation per kind of parameter, so the
+ * code size no longer grows with the number of parameters. The functions
+ * below are that implementation; call the Param_* or *ByIndex functions
+ * instead.
+ */
+esp_err_t _nvsconfig_set_array(NvsConfigParamIndex_t idx, const void* value, size_t length);
+esp_err_t _nvsconfig_set_range(NvsConfigParamIndex_t idx, size_t first, const void* values, size_t count);
+esp_err_t _nvsconfig_get_range(NvsConfigParamIndex_t idx, size_t first, void* buffer, size_t count);
+const void* _nvsconfig_get_array(NvsConfigParamIndex_t idx, size_t* out_length);
+const void* _nvsconfig_acquire(NvsConfigParamIndex_t idx, size_t* out_length);
+void _nvsconfig_release(void);
+esp_err_t _nvsconfig_copy(NvsConfigParamIndex_t idx, void* buffer, size_t buffer_size);
+esp_err_t _nvsconfig_set_string(NvsConfigParamIndex_t idx, const char* value);
+
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)     \
+    static inline esp_err_t Param_Set##name_(const type_ value)            \
+    {                                                                      \
+        return _nvsconfig_set_scalar(PARAM_INDEX_##name_, &value);         \
+    }                                                                      \
+    static inline type_ Param_Get##name_(void)                             \
+    {                                                                      \
+        type_ _value;                                                      \
+        _nvsconfig_get_scalar(PARAM_INDEX_##name_, &_value);               \
+        return _value;                                                     \
+    }                                                                      \
+    static inline esp_err_t Param_Reset##name_(void)                       \
+    {                                                                      \
+        return NvsConfig_ResetByIndex(PARAM_INDEX_##name_);                \
+    }                                                                      \
+    static inline int Param_Print##name_(char* buf, size_t buf_size)       \
+    {                                                                      \
+        return NvsConfig_PrintByIndex(PARAM_INDEX_##name_, buf, buf_size); \
+    }
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_)             \
+    static inline esp_err_t Param_Set##name_(const type_* value, size_t length)           \
+    {                                                                                     \
+        return _nvsconfig_set_array(PARAM_INDEX_##name_, value, length);                  \
+    }                                                                                     \
+    static inline esp_err_t Param_SetElement##name_(size_t index, const type_ value)      \
+    {                                                                                     \
+        return _nvsconfig_set_range(PARAM_INDEX_##name_, index, &value, 1);               \
+    }                                                                                     \
+    static inline esp_err_t Param_SetRange##name_(size_t first, const type_* values,      \
+                                                  size_t count)                           \
+    {                                                                                     \
+        return _nvsconfig_set_range(PARAM_INDEX_##name_, first, values, count);           \
+    }                                                                                     \
+    static inline esp_err_t Param_GetRange##name_(size_t first, type_* buffer,            \
+                                                  size_t count)                           \
+    {                                                                                     \
+        return _nvsconfig_get_range(PARAM_INDEX_##name_, first, buffer, count);           \
+    }                                                                                     \
+    static inline const type_* Param_Get##name_(size_t* out_array_length)                 \
+    {                                                                                     \
+        return (const type_*)_nvsconfig_get_array(PARAM_INDEX_##name_, out_array_length); \
+    }                                                                                     \
+    static inline esp_err_t Param_Copy##name_(type_* buffer, size_t buffer_size)          \
+    {                                                                                     \
+        return _nvsconfig_copy(PARAM_INDEX_##name_, buffer, buffer_size);                 \
+    }                                                                                     \
+    static inline const type_* Param_Acquire##name_(size_t* out_array_length)             \
+    {                                                                                     \
+        return (const type_*)_nvsconfig_acquire(PARAM_INDEX_##name_, out_array_length);   \
+    }                                                                                     \
+    static inline void Param_Release##name_(void)                                         \
+    {                                                                                     \
+        _nvsconfig_release();                                                             \
+    }                                                                                     \
+    static inline esp_err_t Param_Reset##name_(void)                                      \
+    {                                                                                     \
+        return NvsConfig_ResetByIndex(PARAM_INDEX_##name_);                               \
+    }                                                                                     \
+    static inline int Param_Print##name_(char* buf, size_t buf_size)                      \
+    {                                                                                     \
+        return NvsConfig_PrintByIndex(PARAM_INDEX_##name_, buf, buf_size);                \
+    }
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)          \
+    static inline esp_err_t Param_Set##name_(const char* value)                    \
+    {                                                                              \
+        return _nvsconfig_set_string(PARAM_INDEX_##name_, value);                  \
+    }                                                                              \
+    static inline const char* Param_Get##name_(size_t* out_length)                 \
+    {                                                                              \
+        return (const char*)_nvsconfig_get_array(PARAM_INDEX_##name_, out_length); \
+    }                                                                              \
+    static inline esp_err_t Param_Copy##name_(char* buffer, size_t buffer_size)    \
+    {                                                                              \
+        return _nvsconfig_copy(PARAM_INDEX_##name_, buffer, buffer_size);          \
+    }                                                                              \
+    static inline const char* Param_Acquire##name_(size_t* out_length)             \
+    {                                                                              \
+        return (const char*)_nvsconfig_acquire(PARAM_INDEX_##name_, out_length);   \
+    }                                                                              \
+    static inline void Param_Release##name_(void)                                  \
+    {                                                                              \
+        _nvsconfig_release();                                                      \
+    }                                                                              \
+    static inline esp_err_t Param_Reset##name_(void)                               \
+    {                                                                              \
+        return NvsConfig_ResetByIndex(PARAM_INDEX_##name_);                        \
+    }                                                                              \
+    static inline int Param_Print##name_(char* buf, size_t buf_size)               \
+    {                                                                              \
+        return NvsConfig_PrintByIndex(PARAM_INDEX_##name_, buf, buf_size);         \
+    }
+#else
 #define PARAM(secure_lvl_, type_, name_, default_value_, description_) \
     esp_err_t Param_Set##name_(const type_ value);                     \
     type_ Param_Get##name_(void);                                      \
@@ -311,13 +1059,30 @@ uint32_t NvsConfig_GetSchemaVersion(void);
     int Param_Print##name_(char* buf, size_t buf_size);
 #define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) \
     esp_err_t Param_Set##name_(const type_* value, size_t length);            \
+    esp_err_t Param_SetElement##name_(size_t index, const type_ value);       \
+    esp_err_t Param_SetRange##name_(size_t first, const type_* values,        \
+                                    size_t count);                            \
+    esp_err_t Param_GetRange##name_(size_t first, type_* buffer,              \
+                                    size_t count);                            \
     const type_* Param_Get##name_(size_t* out_array_length);                  \
     esp_err_t Param_Copy##name_(type_* buffer, size_t buffer_size);           \
+    const type_* Param_Acquire##name_(size_t* out_array_length);              \
+    void Param_Release##name_(void);                                          \
     esp_err_t Param_Reset##name_(void);                                       \
     int Param_Print##name_(char* buf, size_t buf_size);
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_) \
+    esp_err_t Param_Set##name_(const char* value);                        \
+    const char* Param_Get##name_(size_t* out_length);                     \
+    esp_err_t Param_Copy##name_(char* buffer, size_t buffer_size);        \
+    const char* Param_Acquire##name_(size_t* out_length);                 \
+    void Param_Release##name_(void);                                      \
+    esp_err_t Param_Reset##name_(void);                                   \
+    int Param_Print##name_(char* buf, size_t buf_size);
+#endif
 #include "param_table.inc"
 #undef PARAM
 #undef ARRAY
+#undef STRING
 
 #ifdef __cplusplus
 }
@@ -13,24 +13,23 @@
 
 #include <esp_err.h>
 #include <inttypes.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "esp_err.h"
 #include "esp_log.h"
-#if defined(ESP_IDF_VERSION_MAJOR) && (ESP_IDF_VERSION_MAJOR >= 5)
-#include "esp_timer/esp_timer.h"
-#else
-#include "esp_timer.h"
-#endif
+#include "sdkconfig.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
-#include "freertos/timers.h"
+#include "freertos/task.h"
 #include "nvs.h"
 #include "nvs_flash.h"
+#include "nvs_format.h"
 
 static const char *TAG = "NVS_CONFIG";
 
@@ -39,216 +38,1285 @@ static const char *TAG = "NVS_CONFIG";
 /** Mutex protecting all access to g_nvsconfig_controller. */
 static SemaphoreHandle_t s_nvs_mutex = NULL;
 
+/** Serializes NvsConfig_SaveDirtyParameters() runs; never held with s_nvs_mutex across flash I/O. */
+static SemaphoreHandle_t s_save_mutex = NULL;
+
+/* Use compiler to verify that the array is initialized properly.
+    Char arrays are exept from this check */
+#define ARRAY(s, type, size, name, default, d)                           \
+    static const type name##_init[] = default;                           \
+    _Static_assert(__builtin_types_compatible_p(type, char) ||           \
+                       ((sizeof(name##_init) / sizeof(type)) == (size)), \
+                   "Initializer count mismatch for " #name);
+/* String defaults must fit, and nvs_set_str() stores at most 4000 bytes */
+#define STRING(s, maxlen, name, default, d)                                          \
+    _Static_assert(sizeof(default) <= (maxlen) + 1, "Default too long for " #name);  \
+    _Static_assert((maxlen) + 1 <= 4000, "maxlen too large for " #name);
+#include "param_table.inc"
+#undef ARRAY
+#undef STRING
+
+/*
+ * Current values, filled in by NvsConfig_Init(). Zero-initialised (.bss): the
+ * defaults and metadata live in the const tables below and in the registry.
+ */
+NvsConfigMasterController_t g_nvsconfig_controller;
+
+/* Snapshots and the packed image copy the controller as a whole */
+_Static_assert(sizeof(NvsConfigMasterController_t) == sizeof(NvsConfigValues_t),
+               "Controller and NvsConfigValues_t layouts differ");
+#define _NVS_SAME_OFFSET(name_)                                                                        \
+    _Static_assert(offsetof(NvsConfigMasterController_t, name_) == offsetof(NvsConfigValues_t, name_), \
+                   "Controller and NvsConfigValues_t layouts differ at " #name_);
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)        _NVS_SAME_OFFSET(name_)
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) _NVS_SAME_OFFSET(name_)
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)    _NVS_SAME_OFFSET(name_)
+#include "param_table.inc"
+#undef PARAM
+#undef ARRAY
+#undef STRING
+#undef _NVS_SAME_OFFSET
+
+/*
+ * Characters in use of each STRING parameter, kept out of the controller so
+ * that it has the NvsConfigValues_t layout. Guarded by s_nvs_mutex.
+ */
+enum {
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_) _NVS_STRING_##name_,
+#include "param_table.inc"
+#undef STRING
+    _NVS_STRING_COUNT
+};
+static uint16_t s_string_lengths[_NVS_STRING_COUNT + 1]; /* + 1: a table may have no strings */
+#define _NVS_STRLEN(name_) s_string_lengths[_NVS_STRING_##name_]
+
+/*
+ * Populating 'g_nvsconfig_defaults'
+ */
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)        .name_ = default_value_,
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) .name_ = default_value_,
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)    .name_ = default_value_,
+const NvsConfigValues_t g_nvsconfig_defaults = {
+#include "param_table.inc"
+};
+#undef PARAM
+#undef ARRAY
+#undef STRING
+
 /**
- * @brief Change callback storage.
+ * Per-type print functions, e.g. _nvs_print_float(), over the snprintf()-like
+ * formatters in nvs_format.c
  */
-#define NVS_CONFIG_MAX_CALLBACKS 16
+#define PRINT_FORMAT(type, formatter) \
+    static inline int _nvs_print_##type(type value, char* buf, size_t buf_size) { return formatter(value, buf, buf_size); }
+#include "format.inc"
+#undef PRINT_FORMAT
 
-typedef struct {
-    const char* param_name;  /* NULL = global (fires for any param) */
-    NvsConfigOnChange_t cb;
-    void* user_data;
-} _NvsConfigCallbackEntry_t;
+/* The sorted layout groups members by _NVS_SIZE_CLASS_<type> */
+#define PRINT_FORMAT(type, formatter) \
+    _Static_assert(_NVS_SIZE_CLASS_##type(8, 4, 2, 1) == sizeof(type), "Wrong size class for " #type);
+#include "format.inc"
+#undef PRINT_FORMAT
 
-static _NvsConfigCallbackEntry_t s_callbacks[NVS_CONFIG_MAX_CALLBACKS];
-static size_t s_callback_count = 0;
+/* NvsConfigType_t lists the format.inc types in the same order */
+enum {
+#define PRINT_FORMAT(type, formatter) _NVS_FORMAT_##type,
+#include "format.inc"
+#undef PRINT_FORMAT
+    _NVS_FORMAT_COUNT
+};
+#define PRINT_FORMAT(type, formatter) \
+    _Static_assert((int)NVS_CONFIG_TYPE_##type == (int)_NVS_FORMAT_##type, "NVS_CONFIG_TYPES differs at " #type);
+#include "format.inc"
+#undef PRINT_FORMAT
+_Static_assert((int)_NVS_FORMAT_COUNT == (int)NVS_CONFIG_TYPE_COUNT, "NVS_CONFIG_TYPES and format.inc differ");
 
-esp_err_t NvsConfig_RegisterOnChange(const char* param_name,
-                                     NvsConfigOnChange_t cb,
-                                     void* user_data)
+static uint32_t s_write_counts[PARAM_INDEX_COUNT] = {0};
+static uint32_t s_suppressed_counts[PARAM_INDEX_COUNT] = {0};
+
+/**
+ * @brief Dirty and non-default state, one bit per NvsConfigParamIndex_t.
+ *
+ * Bits are only modified with s_nvs_mutex held; readers may test them without
+ * the lock. Scans skip clean words and find set bits with count-trailing-zeros,
+ * so walking the dirty set costs O(words + dirty) rather than O(params).
+ */
+#define NVS_BITSET_WORDS ((PARAM_INDEX_COUNT + 31) / 32)
+typedef _Atomic uint32_t _NvsConfigBitset_t[NVS_BITSET_WORDS];
+
+static _NvsConfigBitset_t s_dirty_bits;
+static _NvsConfigBitset_t s_nondefault_bits;
+
+static inline bool _bits_test(const _Atomic uint32_t* bits, size_t idx)
 {
-    if (s_callback_count >= NVS_CONFIG_MAX_CALLBACKS) return ESP_ERR_NO_MEM;
-    s_callbacks[s_callback_count].param_name = param_name;
-    s_callbacks[s_callback_count].cb = cb;
-    s_callbacks[s_callback_count].user_data = user_data;
-    s_callback_count++;
-    return ESP_OK;
+    return (atomic_load_explicit(&bits[idx / 32], memory_order_relaxed) >> (idx % 32)) & 1u;
 }
 
-esp_err_t NvsConfig_RegisterGlobalOnChange(NvsConfigOnChange_t cb,
-                                           void* user_data)
+/** Caller serializes writers (s_nvs_mutex, or exclusive ownership). */
+static inline void _bits_assign(_Atomic uint32_t* bits, size_t idx, bool on)
 {
-    return NvsConfig_RegisterOnChange(NULL, cb, user_data);
+    const uint32_t mask = 1u << (idx % 32);
+    uint32_t word = atomic_load_explicit(&bits[idx / 32], memory_order_relaxed);
+    word = on ? (word | mask) : (word & ~mask);
+    atomic_store_explicit(&bits[idx / 32], word, memory_order_relaxed);
 }
 
-void NvsConfig_ClearCallbacks(void)
+/** @return Index of the first set bit at or after @p from, or PARAM_INDEX_COUNT. */
+static size_t _bits_next(const _Atomic uint32_t* bits, size_t from)
 {
-    s_callback_count = 0;
-    memset(s_callbacks, 0, sizeof(s_callbacks));
+    if (from >= PARAM_INDEX_COUNT) {
+        return PARAM_INDEX_COUNT;
+    }
+    size_t word = from / 32;
+    uint32_t w = atomic_load_explicit(&bits[word], memory_order_relaxed) & (~0u << (from % 32));
+    while (w == 0) {
+        if (++word == NVS_BITSET_WORDS) {
+            return PARAM_INDEX_COUNT;
+        }
+        w = atomic_load_explicit(&bits[word], memory_order_relaxed);
+    }
+    return word * 32 + (size_t)__builtin_ctz(w);
 }
 
+#define NVS_BITS_FOREACH(bits_, idx_) \
+    for (size_t idx_ = _bits_next((bits_), 0); idx_ < PARAM_INDEX_COUNT; idx_ = _bits_next((bits_), idx_ + 1))
+
 /**
- * @brief Notify registered callbacks that a parameter changed.
+ * @brief Array chunk dirtiness.
  *
- * Called AFTER the mutex is released to prevent deadlocks
- * (callbacks may read other params).
+ * Every array is split into NVS_ARRAY_CHUNK_SIZE-byte chunks with one bit each
+ * in s_dirty_chunks, so element and range updates only mark what they touch.
+ * _NvsChunkLayout_t is never instantiated: it gives each array one byte per
+ * chunk, and offsetof() turns that into the array's first bit. A dirty array
+ * with none of its chunk bits set counts as dirty as a whole.
  */
-static void _nvsconfig_notify_change(const char* param_name)
-{
-    for (size_t i = 0; i < s_callback_count; i++) {
-        if (s_callbacks[i].param_name == NULL ||
-            strcmp(s_callbacks[i].param_name, param_name) == 0) {
-            s_callbacks[i].cb(param_name, s_callbacks[i].user_data);
-        }
-    }
-}
+#define NVS_ARRAY_CHUNK_SIZE CONFIG_NVS_CONFIG_ARRAY_CHUNK_SIZE
+#define NVS_CHUNKED_STORAGE  (CONFIG_NVS_CONFIG_ARRAY_CHUNKED && !CONFIG_NVS_CONFIG_STORAGE_PACKED)
+#define NVS_ARRAY_CHUNKS(type_, size_) (((size_) * sizeof(type_) + NVS_ARRAY_CHUNK_SIZE - 1) / NVS_ARRAY_CHUNK_SIZE)
 
-/* Use compiler to verify that the array is initialized properly.
-    Char arrays are exept from this check */
-#define ARRAY(s, type, size, name, default, d)                           \
-    static const type name##_init[] = default;                           \
-    _Static_assert(__builtin_types_compatible_p(type, char) ||           \
-                       ((sizeof(name##_init) / sizeof(type)) == (size)), \
-                   "Initializer count mismatch for " #name);
+typedef struct {
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) uint8_t name_[NVS_ARRAY_CHUNKS(type_, size_)];
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)
 #include "param_table.inc"
+#undef PARAM
 #undef ARRAY
+#undef STRING
+    uint8_t end_;
+} _NvsChunkLayout_t;
 
-/*
- * Populating 'g_nvsconfig_controller'
- */
-#define PARAM(secure_lvl_, type_, name_, default_value_, description_) \
-    .name_ = {                                                         \
-        .secure_level = secure_lvl_,                                   \
-        .name = #name_,                                                \
-        .is_dirty = false,                                             \
-        .is_default = true,                                            \
-        .default_value = default_value_,                               \
-        .key = #name_,                                                 \
-    },
+#define NVS_CHUNK_COUNT        offsetof(_NvsChunkLayout_t, end_)
+#define NVS_CHUNK_BITSET_WORDS ((NVS_CHUNK_COUNT + 32) / 32)
+typedef _Atomic uint32_t _NvsChunkBitset_t[NVS_CHUNK_BITSET_WORDS];
+
+_Static_assert(NVS_CHUNK_COUNT <= UINT16_MAX, "Too many array chunks, raise CONFIG_NVS_CONFIG_ARRAY_CHUNK_SIZE");
+
+typedef struct {
+    uint16_t first; /**< First bit in s_dirty_chunks. */
+    uint16_t count; /**< Number of chunks, 0 for scalars and strings. */
+} _NvsChunkSpan_t;
+
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_) [PARAM_INDEX_##name_] = {0, 0},
 #define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) \
-    .name_ = {                                                                \
-        .secure_level = secure_lvl_,                                          \
-        .name = #name_,                                                       \
-        .size = size_,                                                        \
-        .is_dirty = false,                                                    \
-        .is_default = true,                                                   \
-        .default_value = default_value_,                                      \
-        .key = #name_,                                                        \
-    },
-NvsConfigMasterController_t g_nvsconfig_controller = {
+    [PARAM_INDEX_##name_] = {(uint16_t)offsetof(_NvsChunkLayout_t, name_), (uint16_t)NVS_ARRAY_CHUNKS(type_, size_)},
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_) [PARAM_INDEX_##name_] = {0, 0},
+static const _NvsChunkSpan_t s_chunk_spans[PARAM_INDEX_COUNT] = {
 #include "param_table.inc"
 };
 #undef PARAM
 #undef ARRAY
+#undef STRING
+
+static _NvsChunkBitset_t s_dirty_chunks;
+
+/** @return true if any chunk bit of parameter @p idx is set in @p bits. */
+static bool _chunks_any(const _Atomic uint32_t* bits, size_t idx)
+{
+    const _NvsChunkSpan_t* span = &s_chunk_spans[idx];
+    for (size_t c = 0; c < span->count; c++) {
+        if (_bits_test(bits, span->first + c)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Set or clear the chunk bits of parameter @p idx covering bytes [@p from, @p to). */
+static void _chunks_assign(_Atomic uint32_t* bits, size_t idx, size_t from, size_t to, bool on)
+{
+    const _NvsChunkSpan_t* span = &s_chunk_spans[idx];
+    if (span->count == 0 || from >= to) {
+        return;
+    }
+    for (size_t c = from / NVS_ARRAY_CHUNK_SIZE; c <= (to - 1) / NVS_ARRAY_CHUNK_SIZE && c < span->count; c++) {
+        _bits_assign(bits, span->first + c, on);
+    }
+}
 
 /**
- * Helper Macro for Print Formats
+ * @brief Find the differing bytes of two values, at chunk granularity.
+ * @return false if the values are equal; otherwise true with [@p from, @p to)
+ *         covering every chunk that differs.
  */
-#define PRINT_FORMAT(type, format) \
-    static inline const char* GetPrintFormat_##type(void) { return format; }
-#include "format.inc"
-#undef PRINT_FORMAT
+static bool _chunks_diff(const void* a, const void* b, size_t size, size_t* from, size_t* to)
+{
+    const uint8_t* pa = (const uint8_t*)a;
+    const uint8_t* pb = (const uint8_t*)b;
+    size_t lo = 0;
+    while (lo < size) {
+        const size_t n = size - lo < NVS_ARRAY_CHUNK_SIZE ? size - lo : NVS_ARRAY_CHUNK_SIZE;
+        if (memcmp(pa + lo, pb + lo, n) != 0) break;
+        lo += n;
+    }
+    if (lo >= size) {
+        return false;
+    }
+    size_t hi = size;
+    while (hi > lo) {
+        const size_t start = ((hi - 1) / NVS_ARRAY_CHUNK_SIZE) * NVS_ARRAY_CHUNK_SIZE;
+        if (memcmp(pa + start, pb + start, hi - start) != 0) break;
+        hi = start;
+    }
+    *from = lo;
+    *to = hi;
+    return true;
+}
 
 /**
- * @brief Parameter index enum for write-count tracking.
+ * @brief Write generations.
+ *
+ * s_config_epoch is incremented under s_nvs_mutex every time a value changes
+ * (set, reset or commit), and the changed parameter's s_param_gen entry is
+ * stamped with the new epoch. Both only grow (modulo 2^32), so "did X change
+ * since generation G" is one comparison. The save path records a parameter's
+ * generation when staging its value and only clears the dirty bit afterwards
+ * if it is unchanged, so a write that races with a flash save is never lost.
  */
-typedef enum {
-#define PARAM(s, t, name, d, desc)      PARAM_INDEX_##name,
-#define ARRAY(s, t, sz, name, d, desc)  PARAM_INDEX_##name,
-#include "param_table.inc"
-#undef PARAM
-#undef ARRAY
-    PARAM_INDEX_COUNT
-} NvsConfigParamIndex_t;
+static _Atomic uint32_t s_config_epoch = 0;
+static _Atomic uint32_t s_param_gen[PARAM_INDEX_COUNT];
 
-static uint32_t s_write_counts[PARAM_INDEX_COUNT] = {0};
+/** Wrap-safe "generation @p gen is newer than @p since". */
+static inline bool _gen_after(uint32_t gen, uint32_t since)
+{
+    return (int32_t)(gen - since) > 0;
+}
 
-uint32_t NvsConfig_GetWriteCount(const char* name)
+/**
+ * @brief Background save scheduling, guarded by s_nvs_mutex.
+ *
+ * The save task sleeps without a timeout while everything is clean. The first
+ * dirty mark wakes it; it then flushes once no change has arrived for the
+ * quiet period, the oldest unsaved change reaches the maximum latency, or the
+ * dirty-byte threshold is crossed, whichever comes first. After a failed save
+ * the threshold is ignored (s_save_backoff) until a save succeeds or a new
+ * dirty mark arrives, so a full or broken NVS is retried once per quiet
+ * period instead of in a tight loop.
+ */
+static TaskHandle_t s_save_task = NULL;
+static bool s_save_armed = false;
+static bool s_save_backoff = false;
+static size_t s_dirty_bytes = 0;
+static TickType_t s_first_dirty_tick = 0;
+static TickType_t s_last_dirty_tick = 0;
+
+#define NVS_SAVE_QUIET_TICKS       pdMS_TO_TICKS(CONFIG_NVS_CONFIG_SAVE_QUIET_MS)
+#define NVS_SAVE_MAX_LATENCY_TICKS pdMS_TO_TICKS(CONFIG_NVS_CONFIG_SAVE_MAX_LATENCY_MS)
+
+/**
+ * @brief Record a dirty mark. Caller holds s_nvs_mutex.
+ *
+ * @param new_bytes Bytes that just went from clean to dirty (0 if the
+ *                  parameter was already dirty).
+ * @return true if the save task must be woken with _save_notify() once the
+ *         mutex has been released.
+ */
+static bool _save_schedule(size_t new_bytes)
 {
-    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
-        if (strcmp(g_nvsconfig_params[i].name, name) == 0) {
-            return s_write_counts[i];
-        }
+    const TickType_t now = xTaskGetTickCount();
+    const size_t before = s_dirty_bytes;
+
+    s_dirty_bytes += new_bytes;
+    s_last_dirty_tick = now;
+    s_save_backoff = false;
+    if (!s_save_armed) {
+        s_save_armed = true;
+        s_first_dirty_tick = now;
+        return true;
     }
-    return 0;
+    return CONFIG_NVS_CONFIG_SAVE_DIRTY_BYTES > 0 &&
+           before < CONFIG_NVS_CONFIG_SAVE_DIRTY_BYTES &&
+           s_dirty_bytes >= CONFIG_NVS_CONFIG_SAVE_DIRTY_BYTES;
 }
 
-uint32_t NvsConfig_GetTotalWriteCount(void)
+/**
+ * @brief Mark bytes [@p from, @p to) of a parameter dirty after they changed.
+ *        Caller holds s_nvs_mutex.
+ *
+ * @param bytes Full size of the parameter, counted towards the dirty-byte
+ *              threshold when it goes from clean to dirty.
+ * @return true if the save task must be woken (see _save_schedule()).
+ */
+static bool _mark_dirty_span(size_t idx, size_t bytes, size_t from, size_t to)
 {
-    uint32_t total = 0;
-    for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
-        total += s_write_counts[i];
+    const bool was_dirty = _bits_test(s_dirty_bits, idx);
+    if (was_dirty && !_chunks_any(s_dirty_chunks, idx)) {
+        /* Already dirty as a whole (e.g. since loading): keep it that way */
+        from = 0;
+        to = bytes;
     }
-    return total;
+    const bool wake = _save_schedule(was_dirty ? 0 : bytes);
+    _bits_assign(s_dirty_bits, idx, true);
+    _chunks_assign(s_dirty_chunks, idx, from, to, true);
+    const uint32_t gen = atomic_load_explicit(&s_config_epoch, memory_order_relaxed) + 1;
+    atomic_store_explicit(&s_param_gen[idx], gen, memory_order_release);
+    atomic_store_explicit(&s_config_epoch, gen, memory_order_release);
+    return wake;
 }
 
-void NvsConfig_ResetWriteCounts(void)
+/**
+ * @brief Mark a whole parameter dirty after its value changed. Caller holds s_nvs_mutex.
+ * @return true if the save task must be woken (see _save_schedule()).
+ */
+static bool _mark_dirty(size_t idx, size_t bytes)
 {
-    memset(s_write_counts, 0, sizeof(s_write_counts));
+    return _mark_dirty_span(idx, bytes, 0, bytes);
+}
+
+static void _save_notify(void)
+{
+    if (s_save_task != NULL) {
+        xTaskNotifyGive(s_save_task);
+    }
 }
 
 /**
- * @brief Schema versioning support.
+ * @brief Change callback storage.
+ *
+ * Subscriptions live in a fixed pool of CONFIG_NVS_CONFIG_MAX_CALLBACKS
+ * entries and are threaded into singly linked lists: one list per parameter,
+ * resolved from the name at registration, and one list of global
+ * subscribers. Notifying a change walks only the parameter's own list and
+ * the global list, in registration order, with no string comparisons. Links
+ * are pool index + 1, so zero-initialised storage is a set of empty lists.
+ *
+ * Writers (subscribe, unsubscribe, clear) serialize on s_callback_mutex.
+ * Readers take no lock: links are published with release stores and an
+ * unsubscribed entry is only unlinked, keeping its own next link, so a
+ * notification already walking the list steps over it safely. Unlinked
+ * entries wait on a retired list and return to the free list only once no
+ * notification is in flight (s_callback_readers == 0), RCU style.
  */
-static NvsConfigMigrationCb_t s_migration_cb = NULL;
-static uint32_t s_schema_version = NVS_CONFIG_SCHEMA_VERSION;
+#define NVS_CONFIG_MAX_CALLBACKS CONFIG_NVS_CONFIG_MAX_CALLBACKS
 
-#define NVS_SCHEMA_KEY "schema_ver"
+_Static_assert(NVS_CONFIG_MAX_CALLBACKS < UINT16_MAX, "callback links are uint16_t");
 
-esp_err_t NvsConfig_RegisterMigration(NvsConfigMigrationCb_t cb)
+typedef struct {
+    union {
+        NvsConfigOnChange_t cb;
+        NvsConfigOnValueChange_t value_cb;  /* with_values */
+    };
+    void* user_data;
+    _Atomic uint16_t next;   /* list link, read without the lock */
+    uint16_t free_next;      /* free/retired list link, writers only */
+    uint16_t list;           /* parameter index, or PARAM_INDEX_COUNT for global */
+    uint16_t gen;            /* bumped on every allocation; part of the handle */
+    _Atomic bool active;
+    bool async;              /* delivered by the dispatcher instead of the setter's task */
+    bool with_values;        /* value_cb, receives the captured NvsConfigChange_t */
+} _NvsConfigCallbackEntry_t;
+
+static _NvsConfigCallbackEntry_t s_callbacks[NVS_CONFIG_MAX_CALLBACKS];
+static _Atomic(SemaphoreHandle_t) s_callback_mutex = NULL;
+static _Atomic uint32_t s_callback_readers = 0;
+static bool s_callback_pool_ready = false;
+static uint16_t s_callback_free = 0;
+static uint16_t s_callback_retired = 0;
+
+/* List heads and tails; entry PARAM_INDEX_COUNT holds the global subscribers. */
+static _Atomic uint16_t s_callback_head[PARAM_INDEX_COUNT + 1];
+static uint16_t s_callback_tail[PARAM_INDEX_COUNT + 1];
+
+/* Value subscribers per list, so setters only capture old/new values when someone wants them. */
+static _Atomic uint16_t s_callback_value_subs[PARAM_INDEX_COUNT + 1];
+static _Atomic uint16_t s_callback_value_total = 0;
+
+static esp_err_t _dispatch_start(void);
+static esp_err_t _callback_add_entry(size_t list, NvsConfigOnChange_t cb, NvsConfigOnValueChange_t value_cb,
+                                     void* user_data, bool async, NvsConfigSubscription_t* out_sub);
+
+/** Take s_callback_mutex, creating it on first use (callbacks may be registered before NvsConfig_Init()). */
+static bool _callback_lock(void)
 {
-    s_migration_cb = cb;
+    SemaphoreHandle_t mutex = atomic_load(&s_callback_mutex);
+    if (mutex == NULL) {
+        SemaphoreHandle_t created = xSemaphoreCreateMutex();
+        if (created == NULL) {
+            ESP_LOGE(TAG, "Failed to create callback registry mutex");
+            return false;
+        }
+        if (atomic_compare_exchange_strong(&s_callback_mutex, &mutex, created)) {
+            mutex = created;
+        }
+        else {
+            vSemaphoreDelete(created);
+        }
+    }
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (!s_callback_pool_ready) {
+        for (uint16_t i = 0; i < NVS_CONFIG_MAX_CALLBACKS; i++) {
+            s_callbacks[i].free_next = (i + 1 < NVS_CONFIG_MAX_CALLBACKS) ? (uint16_t)(i + 2) : 0;
+        }
+        s_callback_free = 1;
+        s_callback_pool_ready = true;
+    }
+    return true;
+}
+
+static void _callback_unlock(void)
+{
+    xSemaphoreGive(atomic_load(&s_callback_mutex));
+}
+
+/** Return retired entries to the free list once no reader can still hold one. Writer lock held. */
+static void _callback_reclaim(void)
+{
+    if (s_callback_retired == 0) {
+        return;
+    }
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(&s_callback_readers) != 0) {
+        return;
+    }
+    while (s_callback_retired != 0) {
+        const uint16_t link = s_callback_retired;
+        s_callback_retired = s_callbacks[link - 1].free_next;
+        s_callbacks[link - 1].free_next = s_callback_free;
+        s_callback_free = link;
+    }
+}
+
+/** Unlink an active entry from its list and retire it. Writer lock held. */
+static void _callback_unlink(uint16_t link)
+{
+    _NvsConfigCallbackEntry_t* entry = &s_callbacks[link - 1];
+    const uint16_t next = atomic_load_explicit(&entry->next, memory_order_relaxed);
+
+    uint16_t prev = 0;
+    uint16_t cur = atomic_load_explicit(&s_callback_head[entry->list], memory_order_relaxed);
+    while (cur != link) {
+        prev = cur;
+        cur = atomic_load_explicit(&s_callbacks[cur - 1].next, memory_order_relaxed);
+    }
+    atomic_store_explicit(prev == 0 ? &s_callback_head[entry->list] : &s_callbacks[prev - 1].next,
+                          next, memory_order_release);
+    if (s_callback_tail[entry->list] == link) {
+        s_callback_tail[entry->list] = prev;
+    }
+
+    atomic_store_explicit(&entry->active, false, memory_order_relaxed);
+    if (entry->with_values) {
+        atomic_fetch_sub(&s_callback_value_subs[entry->list], 1);
+        atomic_fetch_sub(&s_callback_value_total, 1);
+    }
+    entry->free_next = s_callback_retired;
+    s_callback_retired = link;
+}
+
+/** Append a subscriber to list @p list (a parameter index, or PARAM_INDEX_COUNT for global). */
+static esp_err_t _callback_add(size_t list, NvsConfigOnChange_t cb, void* user_data, bool async,
+                               NvsConfigSubscription_t* out_sub)
+{
+    return _callback_add_entry(list, cb, NULL, user_data, async, out_sub);
+}
+
+/** Common body of _callback_add(); exactly one of @p cb and @p value_cb is set. */
+static esp_err_t _callback_add_entry(size_t list, NvsConfigOnChange_t cb, NvsConfigOnValueChange_t value_cb,
+                                     void* user_data, bool async, NvsConfigSubscription_t* out_sub)
+{
+    if (cb == NULL && value_cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!_callback_lock()) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = async ? _dispatch_start() : ESP_OK;
+    if (err == ESP_OK) {
+        _callback_reclaim();
+        err = s_callback_free != 0 ? ESP_OK : ESP_ERR_NO_MEM;
+    }
+    if (err != ESP_OK) {
+        _callback_unlock();
+        return err;
+    }
+
+    const uint16_t link = s_callback_free;
+    _NvsConfigCallbackEntry_t* entry = &s_callbacks[link - 1];
+    s_callback_free = entry->free_next;
+
+    if (value_cb != NULL) {
+        entry->value_cb = value_cb;
+        atomic_fetch_add(&s_callback_value_subs[list], 1);
+        atomic_fetch_add(&s_callback_value_total, 1);
+    }
+    else {
+        entry->cb = cb;
+    }
+    entry->user_data = user_data;
+    entry->list = (uint16_t)list;
+    entry->gen++;
+    entry->async = async;
+    entry->with_values = value_cb != NULL;
+    atomic_store_explicit(&entry->next, 0, memory_order_relaxed);
+    atomic_store_explicit(&entry->active, true, memory_order_relaxed);
+    atomic_store_explicit(s_callback_tail[list] == 0 ? &s_callback_head[list]
+                                                     : &s_callbacks[s_callback_tail[list] - 1].next,
+                          link, memory_order_release);
+    s_callback_tail[list] = link;
+
+    if (out_sub != NULL) {
+        *out_sub = ((uint32_t)entry->gen << 16) | link;
+    }
+    _callback_unlock();
     return ESP_OK;
 }
 
-uint32_t NvsConfig_GetSchemaVersion(void)
+esp_err_t NvsConfig_Subscribe(const char* param_name,
+                              NvsConfigOnChange_t cb,
+                              void* user_data,
+                              uint32_t flags,
+                              NvsConfigSubscription_t* out_sub)
 {
-    return s_schema_version;
+    size_t list = PARAM_INDEX_COUNT;
+    if (param_name != NULL) {
+        list = NvsConfig_Resolve(param_name);
+        if (list == PARAM_INDEX_COUNT) {
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+    return _callback_add(list, cb, user_data, (flags & NVS_CONFIG_SUBSCRIBE_ASYNC) != 0, out_sub);
+}
+
+esp_err_t NvsConfig_SubscribeValues(const char* param_name,
+                                    NvsConfigOnValueChange_t cb,
+                                    void* user_data,
+                                    NvsConfigSubscription_t* out_sub)
+{
+    size_t list = PARAM_INDEX_COUNT;
+    if (param_name != NULL) {
+        list = NvsConfig_Resolve(param_name);
+        if (list == PARAM_INDEX_COUNT) {
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+    if (cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return _callback_add_entry(list, NULL, cb, user_data, false, out_sub);
+}
+
+esp_err_t NvsConfig_Unsubscribe(NvsConfigSubscription_t sub)
+{
+    const uint16_t link = (uint16_t)(sub & 0xFFFFu);
+    if (link == 0 || link > NVS_CONFIG_MAX_CALLBACKS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!_callback_lock()) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    _NvsConfigCallbackEntry_t* entry = &s_callbacks[link - 1];
+    if (atomic_load_explicit(&entry->active, memory_order_relaxed) && entry->gen == (uint16_t)(sub >> 16)) {
+        _callback_unlink(link);
+        _callback_reclaim();
+        err = ESP_OK;
+    }
+    _callback_unlock();
+    return err;
+}
+
+esp_err_t NvsConfig_RegisterOnChange(const char* param_name,
+                                     NvsConfigOnChange_t cb,
+                                     void* user_data)
+{
+    return NvsConfig_Subscribe(param_name, cb, user_data, 0, NULL);
+}
+
+esp_err_t NvsConfig_RegisterOnChangeByIndex(NvsConfigParamIndex_t idx,
+                                            NvsConfigOnChange_t cb,
+                                            void* user_data)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return _callback_add(idx, cb, user_data, false, NULL);
+}
+
+esp_err_t NvsConfig_RegisterGlobalOnChange(NvsConfigOnChange_t cb,
+                                           void* user_data)
+{
+    return NvsConfig_Subscribe(NULL, cb, user_data, 0, NULL);
+}
+
+esp_err_t NvsConfig_RegisterOnChangeAsync(const char* param_name,
+                                          NvsConfigOnChange_t cb,
+                                          void* user_data)
+{
+    return NvsConfig_Subscribe(param_name, cb, user_data, NVS_CONFIG_SUBSCRIBE_ASYNC, NULL);
 }
 
 /**
- * @brief Getters and Setters ( and Reset and Print functions )
+ * @brief Run the subscribers of one parameter (its own list, then the global list).
  *
- * All functions acquire s_nvs_mutex for thread-safe access to the controller.
+ * Lock-free; see "Change callback storage" for why concurrent unsubscribes
+ * are safe. An entry unsubscribed while the walk is in progress is skipped
+ * if the walk has not reached it yet.
+ *
+ * @param async  Run the async subscribers instead of the synchronous ones.
+ * @param change Captured values for value subscribers, or NULL to skip them
+ *               (nothing was captured, or this is an async delivery).
+ * @return true if subscribers of the other kind were skipped.
  */
-#define PARAM(secure_lvl_, type_, name_, default_value_, description_)                          \
-    esp_err_t Param_Set##name_(const type_ value)                                               \
-    {                                                                                           \
-        if (NvsConfig_SecureLevel() > secure_lvl_) {                                            \
-            return ESP_ERR_INVALID_STATE;                                                       \
-        }                                                                                       \
-        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                             \
-        esp_err_t _ret;                                                                         \
-        if (g_nvsconfig_controller.name_.value != value) {                                      \
-            g_nvsconfig_controller.name_.value = value;                                         \
-            g_nvsconfig_controller.name_.is_default = false;                                    \
-            g_nvsconfig_controller.name_.is_dirty = true;                                       \
-            s_write_counts[PARAM_INDEX_##name_]++;                                              \
-            _ret = ESP_OK;                                                                      \
-        } else {                                                                                \
+static bool _callbacks_run(NvsConfigParamIndex_t idx, bool async, const NvsConfigChange_t* change)
+{
+    const char* name = g_nvsconfig_params[idx].name;
+    _Atomic uint16_t* const heads[2] = {&s_callback_head[idx], &s_callback_head[PARAM_INDEX_COUNT]};
+    bool skipped = false;
+
+    atomic_fetch_add(&s_callback_readers, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    for (size_t h = 0; h < 2; h++) {
+        uint16_t link = atomic_load_explicit(heads[h], memory_order_acquire);
+        while (link != 0) {
+            const _NvsConfigCallbackEntry_t* entry = &s_callbacks[link - 1];
+            if (atomic_load_explicit(&entry->active, memory_order_relaxed)) {
+                if (entry->async != async) {
+                    skipped = true;
+                }
+                else if (!entry->with_values) {
+                    entry->cb(name, entry->user_data);
+                }
+                else if (change != NULL) {
+                    entry->value_cb(change, entry->user_data);
+                }
+            }
+            link = atomic_load_explicit(&entry->next, memory_order_acquire);
+        }
+    }
+    atomic_fetch_sub(&s_callback_readers, 1);
+    return skipped;
+}
+
+/**
+ * @brief Asynchronous change delivery.
+ *
+ * Async subscribers do not run in the setter's task. The changed index is
+ * pushed onto a bounded ring instead, at most once while it is pending, and
+ * the dispatcher task drains the ring one coalescing window after being
+ * woken, so a burst of changes to one parameter reaches each async
+ * subscriber once. A change that finds the ring full is dropped and counted.
+ * The ring is guarded by s_dispatch_mutex, never held across a callback.
+ */
+#define NVS_DISPATCH_QUEUE_LEN     CONFIG_NVS_CONFIG_CALLBACK_QUEUE_LEN
+#define NVS_DISPATCH_COALESCE_TICKS pdMS_TO_TICKS(CONFIG_NVS_CONFIG_CALLBACK_COALESCE_MS)
+
+static SemaphoreHandle_t s_dispatch_mutex = NULL;
+static TaskHandle_t s_dispatch_task = NULL;
+static uint16_t s_dispatch_ring[NVS_DISPATCH_QUEUE_LEN];
+static size_t s_dispatch_head = 0;
+static size_t s_dispatch_len = 0;
+static _NvsConfigBitset_t s_dispatch_pending;
+static uint32_t s_dispatch_overflows = 0;
+
+static void _dispatch_post(NvsConfigParamIndex_t idx)
+{
+    bool wake = false;
+
+    xSemaphoreTake(s_dispatch_mutex, portMAX_DELAY);
+    if (!_bits_test(s_dispatch_pending, idx)) {
+        if (s_dispatch_len == NVS_DISPATCH_QUEUE_LEN) {
+            s_dispatch_overflows++;
+        }
+        else {
+            s_dispatch_ring[(s_dispatch_head + s_dispatch_len++) % NVS_DISPATCH_QUEUE_LEN] = (uint16_t)idx;
+            _bits_assign(s_dispatch_pending, idx, true);
+            wake = true;
+        }
+    }
+    xSemaphoreGive(s_dispatch_mutex);
+
+    if (wake && s_dispatch_task != NULL) {
+        xTaskNotifyGive(s_dispatch_task);
+    }
+}
+
+void NvsConfig_DispatchPending(void)
+{
+    if (s_dispatch_mutex == NULL) {
+        return;
+    }
+
+    /* Only deliver what is queued now; changes made by the callbacks wait for the next round. */
+    xSemaphoreTake(s_dispatch_mutex, portMAX_DELAY);
+    size_t remaining = s_dispatch_len;
+    xSemaphoreGive(s_dispatch_mutex);
+
+    while (remaining-- > 0) {
+        xSemaphoreTake(s_dispatch_mutex, portMAX_DELAY);
+        if (s_dispatch_len == 0) {
+            xSemaphoreGive(s_dispatch_mutex);
+            break;
+        }
+        const NvsConfigParamIndex_t idx = (NvsConfigParamIndex_t)s_dispatch_ring[s_dispatch_head];
+        s_dispatch_head = (s_dispatch_head + 1) % NVS_DISPATCH_QUEUE_LEN;
+        s_dispatch_len--;
+        _bits_assign(s_dispatch_pending, idx, false);
+        xSemaphoreGive(s_dispatch_mutex);
+
+        _callbacks_run(idx, true, NULL);
+    }
+}
+
+uint32_t NvsConfig_GetCallbackOverflowCount(void)
+{
+    return s_dispatch_overflows;
+}
+
+static void _dispatch_task(void* arg)
+{
+    (void) arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelay(NVS_DISPATCH_COALESCE_TICKS);
+        NvsConfig_DispatchPending();
+    }
+}
+
+/** Create the dispatcher on the first async registration. Caller holds s_callback_mutex. */
+static esp_err_t _dispatch_start(void)
+{
+    if (s_dispatch_mutex == NULL) {
+        s_dispatch_mutex = xSemaphoreCreateMutex();
+        if (s_dispatch_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create callback dispatch mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (s_dispatch_task == NULL) {
+        BaseType_t created = xTaskCreatePinnedToCore(_dispatch_task, "nvs_cfg_cb",
+                                                     CONFIG_NVS_CONFIG_CALLBACK_TASK_STACK_SIZE, NULL,
+                                                     CONFIG_NVS_CONFIG_CALLBACK_TASK_PRIORITY, &s_dispatch_task,
+                                                     tskNO_AFFINITY);
+        if (created != pdPASS) {
+            s_dispatch_task = NULL;
+            ESP_LOGE(TAG, "Failed to create callback dispatch task");
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+void NvsConfig_ClearCallbacks(void)
+{
+    if (!_callback_lock()) {
+        return;
+    }
+    for (uint16_t link = 1; link <= NVS_CONFIG_MAX_CALLBACKS; link++) {
+        if (atomic_load_explicit(&s_callbacks[link - 1].active, memory_order_relaxed)) {
+            _callback_unlink(link);
+        }
+    }
+    _callback_reclaim();
+    _callback_unlock();
+
+    if (s_dispatch_mutex != NULL) {
+        xSemaphoreTake(s_dispatch_mutex, portMAX_DELAY);
+        s_dispatch_head = 0;
+        s_dispatch_len = 0;
+        s_dispatch_overflows = 0;
+        memset(s_dispatch_pending, 0, sizeof(s_dispatch_pending));
+        xSemaphoreGive(s_dispatch_mutex);
+    }
+}
+
+/**
+ * @brief Old and new values of one change, for value subscribers.
+ *
+ * Filled by _capture_change() under s_nvs_mutex, right before the write, so
+ * subscribers see exactly the transition they are notified about. Ranges of
+ * up to NVS_CAPTURE_INLINE_BYTES live in the setter's stack frame; larger
+ * ones are allocated. A change without a capture (no memory, or a subscriber
+ * that registered after the write) is still delivered, as the whole
+ * parameter with NULL values; see _capture_unavailable().
+ */
+#define NVS_CAPTURE_INLINE_BYTES 16
+
+typedef struct {
+    bool active;
+    void* heap;
+    NvsConfigChange_t change;
+    uint8_t inline_buf[2 * NVS_CAPTURE_INLINE_BYTES];
+} _NvsConfigCapture_t;
+
+/** True if parameter @p idx has a value subscriber, directly or globally. */
+static inline bool _capture_wanted(NvsConfigParamIndex_t idx)
+{
+    return atomic_load_explicit(&s_callback_value_subs[idx], memory_order_relaxed) != 0 ||
+           atomic_load_explicit(&s_callback_value_subs[PARAM_INDEX_COUNT], memory_order_relaxed) != 0;
+}
+
+/** Fill @p cap with a whole-parameter change of @p idx whose values are unavailable. */
+static void _capture_unavailable(_NvsConfigCapture_t* cap, NvsConfigParamIndex_t idx)
+{
+    const NvsConfigParamEntry_t* entry = &g_nvsconfig_params[idx];
+    cap->heap = NULL;
+    cap->change.index = idx;
+    cap->change.name = entry->name;
+    cap->change.first = 0;
+    cap->change.count = entry->element_count;
+    cap->change.element_size = entry->element_size;
+    cap->change.old_value = NULL;
+    cap->change.new_value = NULL;
+    cap->active = true;
+}
+
+/**
+ * @brief Buffer for the @p bytes old and @p bytes new bytes of a change of
+ *        @p idx: the inline one, or an allocation for larger ranges.
+ *
+ * Returns NULL, leaving @p cap as an unavailable change, if the allocation
+ * fails.
+ */
+static uint8_t* _capture_buffer(_NvsConfigCapture_t* cap, NvsConfigParamIndex_t idx, size_t bytes)
+{
+    if (bytes <= NVS_CAPTURE_INLINE_BYTES) {
+        return cap->inline_buf;
+    }
+    cap->heap = malloc(2 * bytes);
+    if (cap->heap == NULL) {
+        ESP_LOGE(TAG, "No memory to capture change of %s", g_nvsconfig_params[idx].name);
+        _capture_unavailable(cap, idx);
+    }
+    return cap->heap;
+}
+
+/** Activate @p cap as the change of @p count elements from @p first, old then new values in @p buf. */
+static void _capture_fill(_NvsConfigCapture_t* cap, NvsConfigParamIndex_t idx, const uint8_t* buf,
+                          size_t first, size_t count, size_t element_size)
+{
+    cap->change.index = idx;
+    cap->change.name = g_nvsconfig_params[idx].name;
+    cap->change.first = first;
+    cap->change.count = count;
+    cap->change.element_size = element_size;
+    cap->change.old_value = buf;
+    cap->change.new_value = buf + count * element_size;
+    cap->active = true;
+}
+
+/**
+ * @brief Capture the transition @p cur -> @p next of @p count elements. Caller holds s_nvs_mutex.
+ *
+ * Does nothing unless the parameter has value subscribers. The captured
+ * range runs from the first to the last element that differs.
+ */
+static void _capture_change(_NvsConfigCapture_t* cap, NvsConfigParamIndex_t idx,
+                            const void* cur, const void* next, size_t element_size, size_t count)
+{
+    cap->active = false;
+    cap->heap = NULL;
+    if (!_capture_wanted(idx)) {
+        return;
+    }
+
+    const uint8_t* from = (const uint8_t*)cur;
+    const uint8_t* to = (const uint8_t*)next;
+    size_t first = 0;
+    size_t last = count;
+    while (first < count && memcmp(from + first * element_size, to + first * element_size, element_size) == 0) {
+        first++;
+    }
+    if (first == count) {
+        /* Changed by value but not by bits (e.g. NaN): report the whole parameter */
+        first = 0;
+    }
+    else {
+        while (memcmp(from + (last - 1) * element_size, to + (last - 1) * element_size, element_size) == 0) {
+            last--;
+        }
+    }
+
+    const size_t bytes = (last - first) * element_size;
+    uint8_t* buf = _capture_buffer(cap, idx, bytes);
+    if (buf == NULL) {
+        return;
+    }
+    memcpy(buf, from + first * element_size, bytes);
+    memcpy(buf + bytes, to + first * element_size, bytes);
+    _capture_fill(cap, idx, buf, first, last - first, element_size);
+}
+
+/**
+ * @brief _capture_change() for a string of @p cur_len chars becoming @p next
+ *        of @p next_len. Caller holds s_nvs_mutex.
+ *
+ * Compares the first max(@p cur_len, @p next_len) + 1 bytes, terminator
+ * included. @p cur is the zero-padded slot; @p next may end at its
+ * terminator and reads as zero past @p next_len, so the padded new value is
+ * only ever built in the capture buffer.
+ */
+static void _capture_string_change(_NvsConfigCapture_t* cap, NvsConfigParamIndex_t idx,
+                                   const char* cur, size_t cur_len, const char* next, size_t next_len)
+{
+    cap->active = false;
+    cap->heap = NULL;
+    if (!_capture_wanted(idx)) {
+        return;
+    }
+
+    const size_t count = (cur_len > next_len ? cur_len : next_len) + 1;
+    size_t first = 0;
+    size_t last = count;
+    while (first < count && cur[first] == (first < next_len ? next[first] : '\0')) {
+        first++;
+    }
+    if (first == count) {
+        first = 0;
+    }
+    else {
+        while (cur[last - 1] == (last - 1 < next_len ? next[last - 1] : '\0')) {
+            last--;
+        }
+    }
+
+    const size_t bytes = last - first;
+    uint8_t* buf = _capture_buffer(cap, idx, bytes);
+    if (buf == NULL) {
+        return;
+    }
+    const size_t copied = next_len > first ? (next_len < last ? next_len : last) - first : 0;
+    memcpy(buf, cur + first, bytes);
+    memcpy(buf + bytes, next + first, copied);
+    memset(buf + bytes + copied, 0, bytes - copied);
+    _capture_fill(cap, idx, buf, first, bytes, 1);
+}
+
+/**
+ * @brief Notify registered callbacks that a parameter changed.
+ *
+ * Called AFTER the mutex is released to prevent deadlocks
+ * (callbacks may read other params). Synchronous subscribers run here,
+ * per-parameter ones before global ones; async subscribers are queued for
+ * the dispatcher. Releases the capture.
+ *
+ * Value subscribers are never skipped: without a capture they receive the
+ * whole parameter with NULL values.
+ *
+ * @param cap Values captured with _capture_change(), or NULL.
+ */
+static void _nvsconfig_notify_change(NvsConfigParamIndex_t idx, _NvsConfigCapture_t* cap)
+{
+    _NvsConfigCapture_t unavailable;
+    if (cap == NULL || !cap->active) {
+        _capture_unavailable(&unavailable, idx);
+    }
+    const NvsConfigChange_t* change = (cap != NULL && cap->active) ? &cap->change : &unavailable.change;
+    if (_callbacks_run(idx, false, change)) {
+        _dispatch_post(idx);
+    }
+    if (cap != NULL) {
+        free(cap->heap);
+    }
+}
+
+/**
+ * @brief Per-parameter sequence counters for the lock-free scalar read path.
+ *
+ * Writers (always holding s_nvs_mutex) move the counter to an odd value before
+ * touching the value and back to an even value afterwards. Readers sample the
+ * counter around their copy and retry if a write was in progress or completed
+ * in between, so they never return a torn value and never take the mutex.
+ */
+static _Atomic uint32_t s_param_seq[PARAM_INDEX_COUNT];
+
+/**
+ * Retries before a reader gives up spinning and waits on s_nvs_mutex instead.
+ * Only reached when a writer was preempted mid-update (e.g. by the reader
+ * itself on a single core); taking the mutex lets the writer finish.
+ */
+#define NVS_SEQ_MAX_SPINS 64
+
+static inline void _seq_write_begin(NvsConfigParamIndex_t idx)
+{
+    atomic_store_explicit(&s_param_seq[idx],
+                          atomic_load_explicit(&s_param_seq[idx], memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void _seq_write_end(NvsConfigParamIndex_t idx)
+{
+    atomic_store_explicit(&s_param_seq[idx],
+                          atomic_load_explicit(&s_param_seq[idx], memory_order_relaxed) + 1,
+                          memory_order_release);
+}
+
+static inline uint32_t _seq_read_begin(NvsConfigParamIndex_t idx)
+{
+    return atomic_load_explicit(&s_param_seq[idx], memory_order_acquire);
+}
+
+static inline bool _seq_read_retry(NvsConfigParamIndex_t idx, uint32_t start)
+{
+    atomic_thread_fence(memory_order_acquire);
+    return (start & 1u) || atomic_load_explicit(&s_param_seq[idx], memory_order_relaxed) != start;
+}
+
+uint32_t NvsConfig_GetWriteCount(const char* name)
+{
+    return NvsConfig_GetWriteCountByIndex(NvsConfig_Resolve(name));
+}
+
+uint32_t NvsConfig_GetWriteCountByIndex(NvsConfigParamIndex_t idx)
+{
+    return (size_t)idx < PARAM_INDEX_COUNT ? s_write_counts[idx] : 0;
+}
+
+uint32_t NvsConfig_GetTotalWriteCount(void)
+{
+    uint32_t total = 0;
+    for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
+        total += s_write_counts[i];
+    }
+    return total;
+}
+
+uint32_t NvsConfig_GetSuppressedWriteCount(const char* name)
+{
+    return NvsConfig_GetSuppressedWriteCountByIndex(NvsConfig_Resolve(name));
+}
+
+uint32_t NvsConfig_GetSuppressedWriteCountByIndex(NvsConfigParamIndex_t idx)
+{
+    return (size_t)idx < PARAM_INDEX_COUNT ? s_suppressed_counts[idx] : 0;
+}
+
+uint32_t NvsConfig_GetTotalSuppressedWriteCount(void)
+{
+    uint32_t total = 0;
+    for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
+        total += s_suppressed_counts[i];
+    }
+    return total;
+}
+
+void NvsConfig_ResetWriteCounts(void)
+{
+    memset(s_write_counts, 0, sizeof(s_write_counts));
+    memset(s_suppressed_counts, 0, sizeof(s_suppressed_counts));
+}
+
+/**
+ * @brief Schema versioning support.
+ */
+static NvsConfigMigrationCb_t s_migration_cb = NULL;
+static uint32_t s_schema_version = NVS_CONFIG_SCHEMA_VERSION;
+
+#define NVS_SCHEMA_KEY "schema_ver"
+
+esp_err_t NvsConfig_RegisterMigration(NvsConfigMigrationCb_t cb)
+{
+    s_migration_cb = cb;
+    return ESP_OK;
+}
+
+uint32_t NvsConfig_GetSchemaVersion(void)
+{
+    return s_schema_version;
+}
+
+/**
+ * @brief Non-default state of an array after bytes [@p from, @p from + @p len)
+ *        were rewritten. Caller holds s_nvs_mutex.
+ *
+ * Only compares the whole array when the rewritten range matches its default
+ * and the array was non-default before.
+ */
+static bool _range_nondefault(size_t idx, const void* value, const void* def, size_t size, size_t from, size_t len)
+{
+    if (memcmp((const uint8_t*)value + from, (const uint8_t*)def + from, len) != 0) {
+        return true;
+    }
+    return _bits_test(s_nondefault_bits, idx) && memcmp(value, def, size) != 0;
+}
+
+/**
+ * @brief Shared body of the STRING setters.
+ *
+ * @p value holds @p len characters (no terminator needed) and must fit in
+ * the @p size byte buffer @p dst together with its terminator. Only the
+ * characters in use are compared and copied; when the string shrinks, the
+ * old tail is cleared so the bytes after the terminator stay zero.
+ */
+static esp_err_t _string_set(NvsConfigParamIndex_t idx, char* dst, uint16_t* length, size_t size,
+                             const char* def, const char* value, size_t len)
+{
+    if (len >= size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    esp_err_t ret;
+    bool wake = false;
+    _NvsConfigCapture_t cap;
+    const size_t old_len = *length;
+    if (len != old_len || memcmp(dst, value, len) != 0) {
+        _capture_string_change(&cap, idx, dst, old_len, value, len);
+        memcpy(dst, value, len);
+        if (old_len > len) {
+            memset(dst + len, 0, old_len - len);
+        }
+        *length = (uint16_t)len;
+        _bits_assign(s_nondefault_bits, idx, def[len] != '\0' || memcmp(dst, def, len) != 0);
+        wake = _mark_dirty(idx, len + 1);
+        s_write_counts[idx]++;
+        ret = ESP_OK;
+    } else {
+        ret = ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    if (wake) _save_notify();
+    if (ret == ESP_OK) _nvsconfig_notify_change(idx, &cap);
+    return ret;
+}
+
+/**
+ * @brief Shared body of the STRING Param_Reset functions.
+ * @return ESP_FAIL if the string already holds its default.
+ */
+static esp_err_t _string_reset(NvsConfigParamIndex_t idx, char* dst, uint16_t* length, const char* def)
+{
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    esp_err_t ret = ESP_FAIL;
+    bool wake = false;
+    if (_bits_test(s_nondefault_bits, idx)) {
+        const size_t def_len = strlen(def);
+        const size_t old_len = *length;
+        memcpy(dst, def, def_len);
+        if (old_len > def_len) {
+            memset(dst + def_len, 0, old_len - def_len);
+        }
+        *length = (uint16_t)def_len;
+        _bits_assign(s_nondefault_bits, idx, false);
+        wake = _mark_dirty(idx, def_len + 1);
+        ret = ESP_OK;
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    if (wake) _save_notify();
+    return ret;
+}
+
+/**
+ * @brief Terminate a string loaded from storage and clear its tail.
+ * @return strlen() of the result.
+ */
+static size_t _string_fix(char* s, size_t size)
+{
+    s[size - 1] = '\0';
+    const size_t len = strlen(s);
+    memset(s + len, 0, size - len);
+    return len;
+}
+
+#if !CONFIG_NVS_CONFIG_GENERIC_ENGINE
+/**
+ * @brief Getters and Setters ( and Reset and Print functions )
+ *
+ * All functions acquire s_nvs_mutex for thread-safe access to the controller,
+ * except scalar getters which read through s_param_seq when
+ * CONFIG_NVS_CONFIG_LOCKFREE_GETTERS is enabled. Param_Acquire<name> returns
+ * with s_nvs_mutex still held so the caller can read the array in place;
+ * Param_Release<name> gives it back.
+ */
+#if CONFIG_NVS_CONFIG_LOCKFREE_GETTERS
+#define _NVS_SCALAR_GETTER(type_, name_)                                                      \
+    type_ Param_Get##name_(void)                                                              \
+    {                                                                                         \
+        type_ _val;                                                                           \
+        for (int _spin = 0; _spin < NVS_SEQ_MAX_SPINS; _spin++) {                             \
+            uint32_t _seq = _seq_read_begin(PARAM_INDEX_##name_);                             \
+            _val = *(volatile const type_*)&g_nvsconfig_controller.name_.value;               \
+            if (!_seq_read_retry(PARAM_INDEX_##name_, _seq)) return _val;                     \
+        }                                                                                     \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                           \
+        _val = g_nvsconfig_controller.name_.value;                                            \
+        xSemaphoreGive(s_nvs_mutex);                                                          \
+        return _val;                                                                          \
+    }
+#else
+#define _NVS_SCALAR_GETTER(type_, name_)                                                      \
+    type_ Param_Get##name_(void)                                                              \
+    {                                                                                         \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                           \
+        type_ _val = g_nvsconfig_controller.name_.value;                                      \
+        xSemaphoreGive(s_nvs_mutex);                                                          \
+        return _val;                                                                          \
+    }
+#endif  // CONFIG_NVS_CONFIG_LOCKFREE_GETTERS
+
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)                          \
+    esp_err_t Param_Set##name_(const type_ value)                                               \
+    {                                                                                           \
+        if (NvsConfig_SecureLevel() > secure_lvl_) {                                            \
+            return ESP_ERR_INVALID_STATE;                                                       \
+        }                                                                                       \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                             \
+        esp_err_t _ret;                                                                         \
+        bool _wake = false;                                                                     \
+        _NvsConfigCapture_t _cap;                                                               \
+        if (g_nvsconfig_controller.name_.value != value) {                                      \
+            _capture_change(&_cap, PARAM_INDEX_##name_, &g_nvsconfig_controller.name_.value,    \
+                            &value, sizeof(type_), 1);                                          \
+            _seq_write_begin(PARAM_INDEX_##name_);                                              \
+            g_nvsconfig_controller.name_.value = value;                                         \
+            _seq_write_end(PARAM_INDEX_##name_);                                                \
+            _bits_assign(s_nondefault_bits, PARAM_INDEX_##name_,                                \
+                         value != g_nvsconfig_defaults.name_);                                  \
+            _wake = _mark_dirty(PARAM_INDEX_##name_, sizeof(type_));                            \
+            s_write_counts[PARAM_INDEX_##name_]++;                                              \
+            _ret = ESP_OK;                                                                      \
+        } else {                                                                                \
             _ret = ESP_FAIL;                                                                    \
         }                                                                                       \
         xSemaphoreGive(s_nvs_mutex);                                                            \
-        if (_ret == ESP_OK) _nvsconfig_notify_change(#name_);                                   \
+        if (_wake) _save_notify();                                                              \
+        if (_ret == ESP_OK) _nvsconfig_notify_change(PARAM_INDEX_##name_, &_cap);               \
         return _ret;                                                                            \
     }                                                                                           \
-    type_ Param_Get##name_(void)                                                                \
-    {                                                                                           \
-        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                             \
-        type_ _val = g_nvsconfig_controller.name_.value;                                        \
-        xSemaphoreGive(s_nvs_mutex);                                                            \
-        return _val;                                                                            \
-    }                                                                                           \
+    _NVS_SCALAR_GETTER(type_, name_)                                                            \
     esp_err_t Param_Reset##name_(void)                                                          \
     {                                                                                           \
         xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                             \
         esp_err_t _ret;                                                                         \
-        if (g_nvsconfig_controller.name_.value != g_nvsconfig_controller.name_.default_value) { \
-            g_nvsconfig_controller.name_.value = g_nvsconfig_controller.name_.default_value;    \
-            g_nvsconfig_controller.name_.is_default = true;                                     \
-            g_nvsconfig_controller.name_.is_dirty = true;                                       \
+        bool _wake = false;                                                                     \
+        if (g_nvsconfig_controller.name_.value != g_nvsconfig_defaults.name_) {                 \
+            _seq_write_begin(PARAM_INDEX_##name_);                                              \
+            g_nvsconfig_controller.name_.value = g_nvsconfig_defaults.name_;                    \
+            _seq_write_end(PARAM_INDEX_##name_);                                                \
+            _bits_assign(s_nondefault_bits, PARAM_INDEX_##name_, false);                        \
+            _wake = _mark_dirty(PARAM_INDEX_##name_, sizeof(type_));                            \
             _ret = ESP_OK;                                                                      \
         } else {                                                                                \
             _ret = ESP_FAIL;                                                                    \
         }                                                                                       \
         xSemaphoreGive(s_nvs_mutex);                                                            \
+        if (_wake) _save_notify();                                                              \
         return _ret;                                                                            \
     }                                                                                           \
     int Param_Print##name_(char* buf, size_t buf_size)                                          \
     {                                                                                           \
         xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                             \
-        int _n = snprintf(buf, buf_size, GetPrintFormat_##type_(),                              \
-                          g_nvsconfig_controller.name_.value);                                  \
+        int _n = _nvs_print_##type_(g_nvsconfig_controller.name_.value, buf, buf_size);         \
         xSemaphoreGive(s_nvs_mutex);                                                            \
         return _n;                                                                              \
     }
@@ -264,31 +1332,94 @@ uint32_t NvsConfig_GetSchemaVersion(void)
         }                                                                                                                         \
         xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
         esp_err_t _ret;                                                                                                           \
-        if (memcmp(&g_nvsconfig_controller.name_.value, value, size_ * sizeof(type_)) != 0) {                                     \
+        bool _wake = false;                                                                                                       \
+        _NvsConfigCapture_t _cap;                                                                                                 \
+        size_t _from, _to;                                                                                                        \
+        if (_chunks_diff(g_nvsconfig_controller.name_.value, value, size_ * sizeof(type_), &_from, &_to)) {                       \
+            _capture_change(&_cap, PARAM_INDEX_##name_, g_nvsconfig_controller.name_.value, value, sizeof(type_), size_);         \
             memcpy(&g_nvsconfig_controller.name_.value, value, size_ * sizeof(type_));                                            \
-            g_nvsconfig_controller.name_.is_default = false;                                                                      \
-            g_nvsconfig_controller.name_.is_dirty = true;                                                                         \
+            _bits_assign(s_nondefault_bits, PARAM_INDEX_##name_,                                                                  \
+                         memcmp(value, g_nvsconfig_defaults.name_, size_ * sizeof(type_)) != 0);                                  \
+            _wake = _mark_dirty_span(PARAM_INDEX_##name_, size_ * sizeof(type_), _from, _to);                                     \
             s_write_counts[PARAM_INDEX_##name_]++;                                                                                \
             _ret = ESP_OK;                                                                                                        \
         } else {                                                                                                                  \
             _ret = ESP_ERR_INVALID_ARG;                                                                                           \
         }                                                                                                                         \
         xSemaphoreGive(s_nvs_mutex);                                                                                              \
-        if (_ret == ESP_OK) _nvsconfig_notify_change(#name_);                                                                     \
+        if (_wake) _save_notify();                                                                                                \
+        if (_ret == ESP_OK) _nvsconfig_notify_change(PARAM_INDEX_##name_, &_cap);                                                 \
         return _ret;                                                                                                              \
     }                                                                                                                             \
-    const type_* Param_Get##name_(size_t* out_array_length)                                                                       \
+    esp_err_t Param_SetRange##name_(size_t first, const type_* values, size_t count)                                              \
+    {                                                                                                                             \
+        if (NvsConfig_SecureLevel() > secure_lvl_) {                                                                              \
+            return ESP_ERR_INVALID_STATE;                                                                                         \
+        }                                                                                                                         \
+        if (first > size_ || count > size_ - first) {                                                                             \
+            return ESP_ERR_INVALID_SIZE;                                                                                          \
+        }                                                                                                                         \
+        type_* _dst = &g_nvsconfig_controller.name_.value[first];                                                                 \
+        const size_t _from = first * sizeof(type_);                                                                               \
+        const size_t _bytes = count * sizeof(type_);                                                                              \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
+        esp_err_t _ret;                                                                                                           \
+        bool _wake = false;                                                                                                       \
+        _NvsConfigCapture_t _cap;                                                                                                 \
+        if (_bytes > 0 && memcmp(_dst, values, _bytes) != 0) {                                                                    \
+            _capture_change(&_cap, PARAM_INDEX_##name_, _dst, values, sizeof(type_), count);                                      \
+            if (_cap.active) _cap.change.first += first;                                                                          \
+            memcpy(_dst, values, _bytes);                                                                                         \
+            _bits_assign(s_nondefault_bits, PARAM_INDEX_##name_,                                                                  \
+                         _range_nondefault(PARAM_INDEX_##name_, g_nvsconfig_controller.name_.value,                               \
+                                           g_nvsconfig_defaults.name_, size_ * sizeof(type_), _from, _bytes));                    \
+            _wake = _mark_dirty_span(PARAM_INDEX_##name_, size_ * sizeof(type_), _from, _from + _bytes);                          \
+            s_write_counts[PARAM_INDEX_##name_]++;                                                                                \
+            _ret = ESP_OK;                                                                                                        \
+        } else {                                                                                                                  \
+            _ret = ESP_ERR_INVALID_ARG;                                                                                           \
+        }                                                                                                                         \
+        xSemaphoreGive(s_nvs_mutex);                                                                                              \
+        if (_wake) _save_notify();                                                                                                \
+        if (_ret == ESP_OK) _nvsconfig_notify_change(PARAM_INDEX_##name_, &_cap);                                                 \
+        return _ret;                                                                                                              \
+    }                                                                                                                             \
+    esp_err_t Param_SetElement##name_(size_t index, const type_ value)                                                            \
+    {                                                                                                                             \
+        return Param_SetRange##name_(index, &value, 1);                                                                           \
+    }                                                                                                                             \
+    esp_err_t Param_GetRange##name_(size_t first, type_* buffer, size_t count)                                                    \
+    {                                                                                                                             \
+        if (first > size_ || count > size_ - first) {                                                                             \
+            return ESP_ERR_INVALID_SIZE;                                                                                          \
+        }                                                                                                                         \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
+        memcpy(buffer, &g_nvsconfig_controller.name_.value[first], count * sizeof(type_));                                        \
+        xSemaphoreGive(s_nvs_mutex);                                                                                              \
+        return ESP_OK;                                                                                                            \
+    }                                                                                                                             \
+    const type_* Param_Get##name_(size_t* out_array_length)                                                                       \
     {                                                                                                                             \
         xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
-        if (out_array_length) *out_array_length = g_nvsconfig_controller.name_.size;                                              \
+        if (out_array_length) *out_array_length = (size_);                                                                        \
         const type_* _ptr = g_nvsconfig_controller.name_.value;                                                                   \
         xSemaphoreGive(s_nvs_mutex);                                                                                              \
         return _ptr;                                                                                                              \
     }                                                                                                                             \
+    const type_* Param_Acquire##name_(size_t* out_array_length)                                                                   \
+    {                                                                                                                             \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
+        if (out_array_length) *out_array_length = (size_);                                                                        \
+        return g_nvsconfig_controller.name_.value;                                                                                \
+    }                                                                                                                             \
+    void Param_Release##name_(void)                                                                                               \
+    {                                                                                                                             \
+        xSemaphoreGive(s_nvs_mutex);                                                                                              \
+    }                                                                                                                             \
     esp_err_t Param_Copy##name_(type_* buffer, size_t buffer_size)                                                                \
     {                                                                                                                             \
         xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
-        const size_t required_size = g_nvsconfig_controller.name_.size * sizeof(type_);                                           \
+        const size_t required_size = (size_) * sizeof(type_);                                                                     \
         if (buffer_size < required_size) {                                                                                        \
             xSemaphoreGive(s_nvs_mutex);                                                                                          \
             return ESP_ERR_INVALID_SIZE;                                                                                          \
@@ -301,216 +1432,1984 @@ uint32_t NvsConfig_GetSchemaVersion(void)
     {                                                                                                                             \
         xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
         esp_err_t _ret;                                                                                                           \
-        if (memcmp(g_nvsconfig_controller.name_.value, g_nvsconfig_controller.name_.default_value, size_ * sizeof(type_)) != 0) { \
-            memcpy(g_nvsconfig_controller.name_.value, g_nvsconfig_controller.name_.default_value, size_ * sizeof(type_));        \
-            g_nvsconfig_controller.name_.is_default = true;                                                                       \
-            g_nvsconfig_controller.name_.is_dirty = true;                                                                         \
+        bool _wake = false;                                                                                                       \
+        size_t _from, _to;                                                                                                        \
+        if (_chunks_diff(g_nvsconfig_controller.name_.value, g_nvsconfig_defaults.name_,                                          \
+                         size_ * sizeof(type_), &_from, &_to)) {                                                                  \
+            memcpy(g_nvsconfig_controller.name_.value, g_nvsconfig_defaults.name_, size_ * sizeof(type_));                        \
+            _bits_assign(s_nondefault_bits, PARAM_INDEX_##name_, false);                                                          \
+            _wake = _mark_dirty_span(PARAM_INDEX_##name_, size_ * sizeof(type_), _from, _to);                                     \
             _ret = ESP_OK;                                                                                                        \
         } else {                                                                                                                  \
             _ret = ESP_FAIL;                                                                                                      \
         }                                                                                                                         \
         xSemaphoreGive(s_nvs_mutex);                                                                                              \
+        if (_wake) _save_notify();                                                                                                \
         return _ret;                                                                                                              \
     }                                                                                                                             \
     int Param_Print##name_(char* buf, size_t buf_size)                                                                            \
     {                                                                                                                             \
-        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
-        int _result;                                                                                                              \
-        /* Special handling for char arrays (strings) */                                                                          \
-        if (strcmp(GetPrintFormat_##type_(), "%s") == 0) {                                                                        \
-            _result = snprintf(buf, buf_size, "%s", (char*)g_nvsconfig_controller.name_.value);                                   \
+        if (buf_size < 2) {                                                                                                       \
+            if (buf_size > 0) buf[0] = '\0';                                                                                      \
+            return 1;                                                                                                             \
         }                                                                                                                         \
-        else {                                                                                                                    \
-            int offset = 0;                                                                                                       \
-            size_t remaining_size = buf_size;                                                                                     \
-            offset += snprintf(buf + offset, remaining_size, "[");                                                                \
-            if (offset >= (int)buf_size) { xSemaphoreGive(s_nvs_mutex); return offset; }                                          \
-            remaining_size = buf_size - offset;                                                                                   \
-            for (size_t i = 0; i < g_nvsconfig_controller.name_.size; ++i) {                                                      \
-                int written = snprintf(buf + offset, remaining_size,                                                              \
-                                       GetPrintFormat_##type_(),                                                                  \
-                                       g_nvsconfig_controller.name_.value[i]);                                                    \
-                if (written < 0 || (size_t)written >= remaining_size) {                                                           \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                                               \
+        int offset = 0;                                                                                                           \
+        size_t remaining_size = buf_size - 1;                                                                                     \
+        buf[offset++] = '[';                                                                                                      \
+        for (size_t i = 0; i < (size_); ++i) {                                                                                    \
+            int written = _nvs_print_##type_(g_nvsconfig_controller.name_.value[i],                                               \
+                                             buf + offset, remaining_size);                                                       \
+            if ((size_t)written >= remaining_size) {                                                                              \
+                buf[buf_size - 1] = '\0';                                                                                         \
+                xSemaphoreGive(s_nvs_mutex);                                                                                      \
+                return buf_size;                                                                                                  \
+            }                                                                                                                     \
+            offset += written;                                                                                                    \
+            remaining_size -= written;                                                                                            \
+            if (i < (size_) - 1) {                                                                                                \
+                if (remaining_size > 1) {                                                                                         \
+                    buf[offset++] = ',';                                                                                          \
+                    buf[offset] = '\0';                                                                                           \
+                    remaining_size--;                                                                                             \
+                } else {                                                                                                          \
                     buf[buf_size - 1] = '\0';                                                                                     \
                     xSemaphoreGive(s_nvs_mutex);                                                                                  \
                     return buf_size;                                                                                              \
                 }                                                                                                                 \
-                offset += written;                                                                                                \
-                remaining_size -= written;                                                                                        \
-                if (i < g_nvsconfig_controller.name_.size - 1) {                                                                  \
-                    if (remaining_size > 1) {                                                                                     \
-                        buf[offset++] = ',';                                                                                      \
-                        buf[offset] = '\0';                                                                                       \
-                        remaining_size--;                                                                                         \
-                    } else {                                                                                                      \
-                        buf[buf_size - 1] = '\0';                                                                                 \
-                        xSemaphoreGive(s_nvs_mutex);                                                                              \
-                        return buf_size;                                                                                          \
-                    }                                                                                                             \
-                }                                                                                                                 \
-            }                                                                                                                     \
-            if (remaining_size > 1) {                                                                                             \
-                buf[offset++] = ']';                                                                                              \
-                buf[offset] = '\0';                                                                                               \
-            } else {                                                                                                              \
-                buf[buf_size - 1] = '\0';                                                                                         \
-                xSemaphoreGive(s_nvs_mutex);                                                                                      \
-                return buf_size;                                                                                                  \
             }                                                                                                                     \
-            _result = offset;                                                                                                     \
         }                                                                                                                         \
         xSemaphoreGive(s_nvs_mutex);                                                                                              \
-        return _result;                                                                                                           \
+        if (remaining_size > 1) {                                                                                                 \
+            buf[offset++] = ']';                                                                                                  \
+            buf[offset] = '\0';                                                                                                   \
+            return offset;                                                                                                        \
+        }                                                                                                                         \
+        buf[buf_size - 1] = '\0';                                                                                                 \
+        return buf_size;                                                                                                          \
+    }
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)                                       \
+    esp_err_t Param_Set##name_(const char* value)                                                               \
+    {                                                                                                           \
+        if (NvsConfig_SecureLevel() > secure_lvl_) {                                                            \
+            return ESP_ERR_INVALID_STATE;                                                                       \
+        }                                                                                                       \
+        return _string_set(PARAM_INDEX_##name_, g_nvsconfig_controller.name_.value,                             \
+                           &_NVS_STRLEN(name_), (maxlen_) + 1,                                                  \
+                           g_nvsconfig_defaults.name_, value, strnlen(value, (maxlen_) + 1));                   \
+    }                                                                                                           \
+    const char* Param_Get##name_(size_t* out_length)                                                            \
+    {                                                                                                           \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                             \
+        if (out_length) *out_length = _NVS_STRLEN(name_);                                                       \
+        const char* _ptr = g_nvsconfig_controller.name_.value;                                                  \
+        xSemaphoreGive(s_nvs_mutex);                                                                            \
+        return _ptr;                                                                                            \
+    }                                                                                                           \
+    const char* Param_Acquire##name_(size_t* out_length)                                                        \
+    {                                                                                                           \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                             \
+        if (out_length) *out_length = _NVS_STRLEN(name_);                                                       \
+        return g_nvsconfig_controller.name_.value;                                                              \
+    }                                                                                                           \
+    void Param_Release##name_(void)                                                                             \
+    {                                                                                                           \
+        xSemaphoreGive(s_nvs_mutex);                                                                            \
+    }                                                                                                           \
+    esp_err_t Param_Copy##name_(char* buffer, size_t buffer_size)                                               \
+    {                                                                                                           \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                             \
+        const size_t _required = _NVS_STRLEN(name_) + 1;                                                        \
+        if (buffer_size < _required) {                                                                          \
+            xSemaphoreGive(s_nvs_mutex);                                                                        \
+            return ESP_ERR_INVALID_SIZE;                                                                        \
+        }                                                                                                       \
+        memcpy(buffer, g_nvsconfig_controller.name_.value, _required);                                          \
+        xSemaphoreGive(s_nvs_mutex);                                                                            \
+        return ESP_OK;                                                                                          \
+    }                                                                                                           \
+    esp_err_t Param_Reset##name_(void)                                                                          \
+    {                                                                                                           \
+        return _string_reset(PARAM_INDEX_##name_, g_nvsconfig_controller.name_.value,                           \
+                             &_NVS_STRLEN(name_), g_nvsconfig_defaults.name_);                                  \
+    }                                                                                                           \
+    int Param_Print##name_(char* buf, size_t buf_size)                                                          \
+    {                                                                                                           \
+        /* Direct copy: no format string to interpret */                                                        \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                                             \
+        const size_t _len = _NVS_STRLEN(name_);                                                                 \
+        if (buf_size > 0) {                                                                                     \
+            const size_t _n = _len < buf_size - 1 ? _len : buf_size - 1;                                        \
+            memcpy(buf, g_nvsconfig_controller.name_.value, _n);                                                \
+            buf[_n] = '\0';                                                                                     \
+        }                                                                                                       \
+        xSemaphoreGive(s_nvs_mutex);                                                                            \
+        return (int)_len;                                                                                       \
+    }
+#include "param_table.inc"
+#undef PARAM
+#undef ARRAY
+#undef STRING
+#undef _NVS_SCALAR_GETTER
+
+/**
+ * @brief Registry wrapper functions.
+ *
+ * Generate static wrappers with uniform signatures so they can be stored
+ * as function pointers in the NvsConfigParamEntry_t registry.
+ */
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)                 \
+    static bool _registry_is_dirty_##name_(void) {                                     \
+        return _bits_test(s_dirty_bits, PARAM_INDEX_##name_);                          \
+    }                                                                                  \
+    static bool _registry_is_default_##name_(void) {                                   \
+        return !_bits_test(s_nondefault_bits, PARAM_INDEX_##name_);                    \
+    }                                                                                  \
+    static esp_err_t _registry_reset_##name_(void) {                                   \
+        return Param_Reset##name_();                                                   \
+    }                                                                                  \
+    static int _registry_print_##name_(char* buf, size_t buf_size) {                   \
+        return Param_Print##name_(buf, buf_size);                                      \
+    }                                                                                  \
+    static esp_err_t _registry_set_##name_(const void* data, size_t data_size) {       \
+        if (data_size != sizeof(type_)) return ESP_ERR_INVALID_SIZE;                   \
+        type_ val;                                                                     \
+        memcpy(&val, data, sizeof(type_));                                             \
+        return Param_Set##name_(val);                                                  \
+    }                                                                                  \
+    static esp_err_t _registry_get_##name_(void* data, size_t data_size) {             \
+        if (data_size != sizeof(type_)) return ESP_ERR_INVALID_SIZE;                   \
+        type_ val = Param_Get##name_();                                                \
+        memcpy(data, &val, sizeof(type_));                                             \
+        return ESP_OK;                                                                 \
+    }
+
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_)           \
+    static bool _registry_is_dirty_##name_(void) {                                     \
+        return _bits_test(s_dirty_bits, PARAM_INDEX_##name_);                          \
+    }                                                                                  \
+    static bool _registry_is_default_##name_(void) {                                   \
+        return !_bits_test(s_nondefault_bits, PARAM_INDEX_##name_);                    \
+    }                                                                                  \
+    static esp_err_t _registry_reset_##name_(void) {                                   \
+        return Param_Reset##name_();                                                   \
+    }                                                                                  \
+    static int _registry_print_##name_(char* buf, size_t buf_size) {                   \
+        return Param_Print##name_(buf, buf_size);                                      \
+    }                                                                                  \
+    static esp_err_t _registry_set_##name_(const void* data, size_t data_size) {       \
+        const size_t full_size = size_ * sizeof(type_);                                \
+        if (data_size > full_size) return ESP_ERR_INVALID_SIZE;                         \
+        if (data_size == full_size) {                                                   \
+            return Param_Set##name_((const type_*)data, size_);                         \
+        }                                                                               \
+        /* Partial write: zero-fill remaining elements (heap, arrays can be large) */  \
+        type_* tmp = calloc(size_, sizeof(type_));                                      \
+        if (tmp == NULL) return ESP_ERR_NO_MEM;                                         \
+        memcpy(tmp, data, data_size);                                                   \
+        Param_Set##name_(tmp, size_);                                                   \
+        free(tmp);                                                                      \
+        return ESP_ERR_INVALID_SIZE; /* warning: partial write */                       \
+    }                                                                                   \
+    static esp_err_t _registry_get_##name_(void* data, size_t data_size) {              \
+        const size_t full_size = size_ * sizeof(type_);                                 \
+        if (data_size >= full_size) {                                                   \
+            return Param_Copy##name_((type_*)data, data_size);                          \
+        }                                                                               \
+        /* Partial read: copy only what fits into the caller's buffer */                \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                      \
+        memcpy(data, g_nvsconfig_controller.name_.value, data_size);                    \
+        xSemaphoreGive(s_nvs_mutex);                                                     \
+        return ESP_ERR_INVALID_SIZE; /* warning: partial read */                        \
+    }
+
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)                       \
+    static bool _registry_is_dirty_##name_(void) {                                              \
+        return _bits_test(s_dirty_bits, PARAM_INDEX_##name_);                                   \
+    }                                                                                           \
+    static bool _registry_is_default_##name_(void) {                                            \
+        return !_bits_test(s_nondefault_bits, PARAM_INDEX_##name_);                             \
+    }                                                                                           \
+    static esp_err_t _registry_reset_##name_(void) {                                            \
+        return Param_Reset##name_();                                                            \
+    }                                                                                           \
+    static int _registry_print_##name_(char* buf, size_t buf_size) {                            \
+        return Param_Print##name_(buf, buf_size);                                               \
+    }                                                                                           \
+    static esp_err_t _registry_set_##name_(const void* data, size_t data_size) {                \
+        if (NvsConfig_SecureLevel() > secure_lvl_) return ESP_ERR_INVALID_STATE;                \
+        const size_t len = strnlen((const char*)data, data_size);                               \
+        return _string_set(PARAM_INDEX_##name_, g_nvsconfig_controller.name_.value,             \
+                           &_NVS_STRLEN(name_), (maxlen_) + 1,                                  \
+                           g_nvsconfig_defaults.name_, (const char*)data, len);                 \
+    }                                                                                           \
+    static esp_err_t _registry_get_##name_(void* data, size_t data_size) {                      \
+        if (data_size == 0) return ESP_ERR_INVALID_SIZE;                                        \
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                             \
+        const size_t len = _NVS_STRLEN(name_);                                                  \
+        const size_t n = len < data_size ? len : data_size - 1;                                 \
+        memcpy(data, g_nvsconfig_controller.name_.value, n);                                    \
+        ((char*)data)[n] = '\0';                                                                \
+        xSemaphoreGive(s_nvs_mutex);                                                            \
+        return n == len ? ESP_OK : ESP_ERR_INVALID_SIZE; /* warning: truncated */               \
+    }
+#include "param_table.inc"
+#undef PARAM
+#undef ARRAY
+#undef STRING
+#endif  // !CONFIG_NVS_CONFIG_GENERIC_ENGINE
+
+/**
+ * @brief Parameter registry: const array of entries, with function pointers
+ *        unless CONFIG_NVS_CONFIG_GENERIC_ENGINE.
+ */
+#if CONFIG_NVS_CONFIG_GENERIC_ENGINE
+#define _NVS_REGISTRY_FNS(name_)
+#else
+#define _NVS_REGISTRY_FNS(name_)                \
+    .is_dirty = _registry_is_dirty_##name_,     \
+    .is_default = _registry_is_default_##name_, \
+    .reset = _registry_reset_##name_,           \
+    .print = _registry_print_##name_,           \
+    .set = _registry_set_##name_,               \
+    .get = _registry_get_##name_,
+#endif
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)  \
+    {                                                                   \
+        .name = #name_,                                                 \
+        .description = description_,                                    \
+        .secure_level = secure_lvl_,                                    \
+        .is_array = false,                                              \
+        .type = NVS_CONFIG_TYPE_##type_,                                \
+        .element_size = sizeof(type_),                                  \
+        .element_count = 1,                                             \
+        _NVS_REGISTRY_FNS(name_)                                        \
+    },
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) \
+    {                                                                         \
+        .name = #name_,                                                       \
+        .description = description_,                                          \
+        .secure_level = secure_lvl_,                                          \
+        .is_array = true,                                                     \
+        .type = NVS_CONFIG_TYPE_##type_,                                      \
+        .element_size = sizeof(type_),                                        \
+        .element_count = size_,                                               \
+        _NVS_REGISTRY_FNS(name_)                                              \
+    },
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_) \
+    {                                                                     \
+        .name = #name_,                                                   \
+        .description = description_,                                      \
+        .secure_level = secure_lvl_,                                      \
+        .is_array = false,                                                \
+        .is_string = true,                                                \
+        .type = NVS_CONFIG_TYPE_char,                                     \
+        .element_size = 1,                                                \
+        .element_count = (maxlen_) + 1,                                   \
+        _NVS_REGISTRY_FNS(name_)                                          \
+    },
+const NvsConfigParamEntry_t g_nvsconfig_params[] = {
+#include "param_table.inc"
+};
+#undef PARAM
+#undef ARRAY
+#undef STRING
+#undef _NVS_REGISTRY_FNS
+
+const size_t g_nvsconfig_param_count =
+    sizeof(g_nvsconfig_params) / sizeof(g_nvsconfig_params[0]);
+
+_Static_assert(sizeof(g_nvsconfig_params) / sizeof(g_nvsconfig_params[0]) == PARAM_INDEX_COUNT,
+               "g_nvsconfig_params must be indexable by NvsConfigParamIndex_t");
+
+/**
+ * @brief Perfect hash over the parameter names (hash-and-displace).
+ *
+ * Names are hashed with 64-bit FNV-1a plus a final mix. The upper half picks
+ * one of NVS_PHF_BUCKETS buckets; each bucket has a displacement d chosen so
+ * that (lo + d * (hi | 1)) mod NVS_PHF_SLOTS lands every name of the table in
+ * a distinct slot. A lookup is then one hash, one slot read and one strcmp().
+ *
+ * Buckets and slots are sized at compile time; the displacements are searched
+ * once, on first use, because the C preprocessor cannot search and a generator
+ * would have to parse the application's param_table.inc. The search works in
+ * static scratch arrays (about 11 bytes per parameter), so it cannot fail for
+ * lack of heap. If no displacement fits (two names with the same 64-bit
+ * hash), lookups fall back to a linear scan.
+ */
+#define _NVS_POW2_CEIL(x)                                                                     \
+    ((x) <= 16 ? 16 : (x) <= 32 ? 32 : (x) <= 64 ? 64 : (x) <= 128 ? 128 : (x) <= 256 ? 256  \
+     : (x) <= 512 ? 512 : (x) <= 1024 ? 1024 : (x) <= 2048 ? 2048 : (x) <= 4096 ? 4096        \
+     : (x) <= 8192 ? 8192 : (x) <= 16384 ? 16384 : (x) <= 32768 ? 32768 : 65536)
+#define NVS_PHF_BUCKETS ((PARAM_INDEX_COUNT + 3) / 4)
+#define NVS_PHF_SLOTS   _NVS_POW2_CEIL(PARAM_INDEX_COUNT + PARAM_INDEX_COUNT / 4 + 1)
+#define NVS_PHF_EMPTY   0xFFFFu
+
+_Static_assert(PARAM_INDEX_COUNT < NVS_PHF_EMPTY, "param_table.inc has too many parameters");
+
+enum { NVS_PHF_UNBUILT, NVS_PHF_BUILDING, NVS_PHF_READY, NVS_PHF_FAILED };
+
+static _Atomic uint8_t s_phf_state = NVS_PHF_UNBUILT;
+static uint16_t s_phf_disp[NVS_PHF_BUCKETS];
+static uint16_t s_phf_slots[NVS_PHF_SLOTS];
+
+/** Scratch of _phf_build(), only touched by the caller that moved the state to BUILDING. */
+static struct {
+    uint64_t hash[PARAM_INDEX_COUNT];
+    uint16_t members[PARAM_INDEX_COUNT];
+    uint16_t start[NVS_PHF_BUCKETS + 1];
+    uint16_t fill[NVS_PHF_BUCKETS];
+} s_phf_scratch;
+
+static uint64_t _phf_hash(const char* name)
+{
+    uint64_t h = 14695981039346656037ull;
+    while (*name) {
+        h = (h ^ (uint8_t)*name++) * 1099511628211ull;
+    }
+    /* FNV-1a barely mixes the last characters into the upper bits, and names
+       often differ only there (Sensor1, Sensor2...): finish with fmix64 */
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint32_t _phf_bucket(uint64_t h)
+{
+    return (uint32_t)(h >> 32) % NVS_PHF_BUCKETS;
+}
+
+static inline uint32_t _phf_slot(uint64_t h, uint32_t d)
+{
+    return ((uint32_t)h + d * ((uint32_t)(h >> 32) | 1u)) & (NVS_PHF_SLOTS - 1);
+}
+
+/** Search a displacement for every bucket, largest buckets first. */
+static bool _phf_build(void)
+{
+    uint64_t* hash = s_phf_scratch.hash;
+    uint16_t* members = s_phf_scratch.members;
+    uint16_t* start = s_phf_scratch.start;
+    uint16_t* fill = s_phf_scratch.fill;
+    bool ok = true;
+
+    /* Counting sort of the names by bucket */
+    memset(start, 0, sizeof(s_phf_scratch.start));
+    for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
+        hash[i] = _phf_hash(g_nvsconfig_params[i].name);
+        start[_phf_bucket(hash[i]) + 1]++;
+    }
+    uint16_t largest = 0;
+    for (size_t b = 0; b < NVS_PHF_BUCKETS; b++) {
+        largest = start[b + 1] > largest ? start[b + 1] : largest;
+        start[b + 1] += start[b];
+    }
+    memcpy(fill, start, sizeof(s_phf_scratch.fill));
+    for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
+        members[fill[_phf_bucket(hash[i])]++] = (uint16_t)i;
+    }
+
+    for (size_t i = 0; i < NVS_PHF_SLOTS; i++) {
+        s_phf_slots[i] = NVS_PHF_EMPTY;
+    }
+    for (uint16_t size = largest; ok && size > 0; size--) {
+        for (size_t b = 0; ok && b < NVS_PHF_BUCKETS; b++) {
+            if (start[b + 1] - start[b] != size) {
+                continue;
+            }
+            ok = false;
+            for (uint32_t d = 0; !ok && d <= 0xFFFFu; d++) {
+                size_t placed = 0;
+                while (placed < size) {
+                    const uint16_t idx = members[start[b] + placed];
+                    const uint32_t slot = _phf_slot(hash[idx], d);
+                    if (s_phf_slots[slot] != NVS_PHF_EMPTY) {
+                        break;
+                    }
+                    s_phf_slots[slot] = idx;
+                    placed++;
+                }
+                ok = placed == size;
+                if (ok) {
+                    s_phf_disp[b] = (uint16_t)d;
+                }
+                else {
+                    while (placed-- > 0) {
+                        s_phf_slots[_phf_slot(hash[members[start[b] + placed]], d)] = NVS_PHF_EMPTY;
+                    }
+                }
+            }
+        }
+    }
+    if (!ok) {
+        ESP_LOGW(TAG, "No perfect hash for the parameter names, using linear lookup");
+    }
+    return ok;
+}
+
+/** Build the hash table once; concurrent callers fall back to a scan meanwhile. */
+static uint8_t _phf_ensure(void)
+{
+    uint8_t state = atomic_load_explicit(&s_phf_state, memory_order_acquire);
+    if (state == NVS_PHF_UNBUILT &&
+        atomic_compare_exchange_strong_explicit(&s_phf_state, &state, NVS_PHF_BUILDING,
+                                                memory_order_acquire, memory_order_acquire)) {
+        state = _phf_build() ? NVS_PHF_READY : NVS_PHF_FAILED;
+        atomic_store_explicit(&s_phf_state, state, memory_order_release);
+    }
+    return state;
+}
+
+NvsConfigParamIndex_t NvsConfig_Resolve(const char* name)
+{
+    if (name == NULL) {
+        return PARAM_INDEX_COUNT;
+    }
+    if (_phf_ensure() == NVS_PHF_READY) {
+        const uint64_t h = _phf_hash(name);
+        const uint16_t idx = s_phf_slots[_phf_slot(h, s_phf_disp[_phf_bucket(h)])];
+        if (idx != NVS_PHF_EMPTY && strcmp(g_nvsconfig_params[idx].name, name) == 0) {
+            return (NvsConfigParamIndex_t)idx;
+        }
+        return PARAM_INDEX_COUNT;
+    }
+    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
+        if (strcmp(g_nvsconfig_params[i].name, name) == 0) {
+            return (NvsConfigParamIndex_t)i;
+        }
+    }
+    return PARAM_INDEX_COUNT;
+}
+
+const NvsConfigParamEntry_t* NvsConfig_FindParam(const char* name)
+{
+    const NvsConfigParamIndex_t idx = NvsConfig_Resolve(name);
+    return idx < PARAM_INDEX_COUNT ? &g_nvsconfig_params[idx] : NULL;
+}
+
+#if !CONFIG_NVS_CONFIG_GENERIC_ENGINE
+/* The table-driven versions are defined with the engine, after s_slots */
+esp_err_t NvsConfig_GetByIndex(NvsConfigParamIndex_t idx, void* data, size_t data_size)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT || data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return g_nvsconfig_params[idx].get(data, data_size);
+}
+
+esp_err_t NvsConfig_SetByIndex(NvsConfigParamIndex_t idx, const void* data, size_t data_size)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT || data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return g_nvsconfig_params[idx].set(data, data_size);
+}
+
+esp_err_t NvsConfig_ResetByIndex(NvsConfigParamIndex_t idx)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return g_nvsconfig_params[idx].reset();
+}
+
+int NvsConfig_PrintByIndex(NvsConfigParamIndex_t idx, char* buf, size_t buf_size)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT) {
+        return -1;
+    }
+    return g_nvsconfig_params[idx].print(buf, buf_size);
+}
+#endif  // !CONFIG_NVS_CONFIG_GENERIC_ENGINE
+
+bool NvsConfig_IsDirtyByIndex(NvsConfigParamIndex_t idx)
+{
+    return (size_t)idx < PARAM_INDEX_COUNT && _bits_test(s_dirty_bits, idx);
+}
+
+bool NvsConfig_IsDefaultByIndex(NvsConfigParamIndex_t idx)
+{
+    return (size_t)idx < PARAM_INDEX_COUNT && !_bits_test(s_nondefault_bits, idx);
+}
+
+size_t NvsConfig_NextDirty(size_t from)
+{
+    return _bits_next(s_dirty_bits, from);
+}
+
+size_t NvsConfig_NextNonDefault(size_t from)
+{
+    return _bits_next(s_nondefault_bits, from);
+}
+
+void NvsConfig_ResetAll(void)
+{
+    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
+        NvsConfig_ResetByIndex((NvsConfigParamIndex_t)i);
+    }
+}
+
+void NvsConfig_PrintAll(void)
+{
+    char buf[128];
+    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
+        NvsConfig_PrintByIndex((NvsConfigParamIndex_t)i, buf, sizeof(buf));
+        ESP_LOGI(TAG, "%-16s = %s", g_nvsconfig_params[i].name, buf);
+    }
+}
+
+/**
+ * @brief Native NVS entry types used for scalar parameters, named after the
+ *        nvs_set_*() suffix. Arrays are stored as blobs, strings as str entries.
+ */
+typedef enum {
+    _NVS_PRIM_blob,
+    _NVS_PRIM_str,
+    _NVS_PRIM_u8,
+    _NVS_PRIM_i8,
+    _NVS_PRIM_u16,
+    _NVS_PRIM_i16,
+    _NVS_PRIM_u32,
+    _NVS_PRIM_i32,
+    _NVS_PRIM_u64,
+    _NVS_PRIM_i64,
+} _NvsPrimitive_t;
+
+#define NVS_PRIMITIVE(type, prim) enum { _NVS_PRIM_OF_##type = _NVS_PRIM_##prim };
+#include "nvs_types.inc"
+
+/**
+ * @brief Where each parameter lives, indexed by PARAM_INDEX_*, so that the
+ *        save path can walk the dirty bitset instead of the whole table.
+ */
+typedef struct {
+    void* value;               /**< Live value in g_nvsconfig_controller. */
+    const void* default_value; /**< Default value in g_nvsconfig_defaults. */
+    const char* key;           /**< NVS key. */
+    uint32_t offset;           /**< Offset of the value in NvsConfigValues_t. */
+    uint32_t size;             /**< Size of the value in bytes. */
+    uint8_t prim;              /**< _NvsPrimitive_t of the stored entry. */
+} _NvsConfigSlot_t;
+
+#define _NVS_SLOT(name_, prim_)                                                                  \
+    [PARAM_INDEX_##name_] = {&g_nvsconfig_controller.name_.value,                                \
+                             &g_nvsconfig_defaults.name_, #name_,                                \
+                             (uint32_t)offsetof(NvsConfigValues_t, name_),                       \
+                             (uint32_t)sizeof(((NvsConfigValues_t*)0)->name_), prim_},
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)        _NVS_SLOT(name_, _NVS_PRIM_OF_##type_)
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) _NVS_SLOT(name_, _NVS_PRIM_blob)
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)    _NVS_SLOT(name_, _NVS_PRIM_str)
+static const _NvsConfigSlot_t s_slots[PARAM_INDEX_COUNT] = {
+#include "param_table.inc"
+};
+#undef PARAM
+#undef ARRAY
+#undef STRING
+#undef _NVS_SLOT
+
+/** Tracked length of STRING parameter @p idx, NULL for other parameters. */
+static uint16_t* _string_length(size_t idx)
+{
+    switch (idx) {
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_)
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_) \
+    case PARAM_INDEX_##name_:                                             \
+        return &_NVS_STRLEN(name_);
+#include "param_table.inc"
+#undef PARAM
+#undef ARRAY
+#undef STRING
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Table-driven scalar get and set, driven by s_slots and the registry.
+ *
+ * Used by the typed *ByIndex functions and, with
+ * CONFIG_NVS_CONFIG_GENERIC_ENGINE, by the Param_* wrappers. Locking, return
+ * codes and the comparison of values match the generated Param_Set/Get
+ * functions.
+ */
+
+/**
+ * True if scalars @p a and @p b of parameter @p idx are equal by == on their
+ * type, the test the generated setters use: -0.0 equals 0.0 and NaN never
+ * equals anything.
+ */
+static bool _scalar_equal(NvsConfigParamIndex_t idx, const void* a, const void* b)
+{
+    switch (g_nvsconfig_params[idx].type) {
+#define _NVS_SCALAR_EQUAL(type_, name_) \
+    case NVS_CONFIG_TYPE_##type_: {     \
+        type_ x, y;                     \
+        memcpy(&x, a, sizeof(x));       \
+        memcpy(&y, b, sizeof(y));       \
+        return x == y;                  \
+    }
+    NVS_CONFIG_TYPES(_NVS_SCALAR_EQUAL)
+#undef _NVS_SCALAR_EQUAL
+    default:
+        return memcmp(a, b, s_slots[idx].size) == 0;
+    }
+}
+
+/** Copy scalar @p idx into @p out with a single load of its size. */
+static inline void _scalar_load(size_t idx, void* out)
+{
+    const void* src = s_slots[idx].value;
+    switch (s_slots[idx].size) {
+    case 1: { uint8_t v = *(volatile const uint8_t*)src; memcpy(out, &v, 1); break; }
+    case 2: { uint16_t v = *(volatile const uint16_t*)src; memcpy(out, &v, 2); break; }
+    case 4: { uint32_t v = *(volatile const uint32_t*)src; memcpy(out, &v, 4); break; }
+    default: { uint64_t v = *(volatile const uint64_t*)src; memcpy(out, &v, 8); break; }
+    }
+}
+
+static inline bool _secure_denied(NvsConfigParamIndex_t idx)
+{
+    return NvsConfig_SecureLevel() > g_nvsconfig_params[idx].secure_level;
+}
+
+esp_err_t _nvsconfig_set_scalar(NvsConfigParamIndex_t idx, const void* value)
+{
+    if (_secure_denied(idx)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    esp_err_t ret;
+    bool wake = false;
+    _NvsConfigCapture_t cap;
+    if (!_scalar_equal(idx, slot->value, value)) {
+        _capture_change(&cap, idx, slot->value, value, slot->size, 1);
+        _seq_write_begin(idx);
+        memcpy(slot->value, value, slot->size);
+        _seq_write_end(idx);
+        _bits_assign(s_nondefault_bits, idx, !_scalar_equal(idx, value, slot->default_value));
+        wake = _mark_dirty(idx, slot->size);
+        s_write_counts[idx]++;
+        ret = ESP_OK;
+    } else {
+        ret = ESP_FAIL;
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    if (wake) _save_notify();
+    if (ret == ESP_OK) _nvsconfig_notify_change(idx, &cap);
+    return ret;
+}
+
+void _nvsconfig_get_scalar(NvsConfigParamIndex_t idx, void* out)
+{
+#if CONFIG_NVS_CONFIG_LOCKFREE_GETTERS
+    for (int spin = 0; spin < NVS_SEQ_MAX_SPINS; spin++) {
+        uint32_t seq = _seq_read_begin(idx);
+        _scalar_load(idx, out);
+        if (!_seq_read_retry(idx, seq)) return;
+    }
+#endif
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    memcpy(out, s_slots[idx].value, s_slots[idx].size);
+    xSemaphoreGive(s_nvs_mutex);
+}
+
+/** True if @p idx is a scalar parameter of type @p type. */
+static inline bool _scalar_of_type(NvsConfigParamIndex_t idx, NvsConfigType_t type)
+{
+    return (size_t)idx < PARAM_INDEX_COUNT && g_nvsconfig_params[idx].type == type &&
+           !g_nvsconfig_params[idx].is_array && !g_nvsconfig_params[idx].is_string;
+}
+
+#define _NVS_TYPED_BY_INDEX(type_, name_)                                            \
+    esp_err_t NvsConfig_Set##name_##ByIndex(NvsConfigParamIndex_t idx, type_ value)  \
+    {                                                                                \
+        if (!_scalar_of_type(idx, NVS_CONFIG_TYPE_##type_)) {                        \
+            return ESP_ERR_INVALID_ARG;                                              \
+        }                                                                            \
+        return _nvsconfig_set_scalar(idx, &value);                                   \
+    }                                                                                \
+    esp_err_t NvsConfig_Get##name_##ByIndex(NvsConfigParamIndex_t idx, type_* out)   \
+    {                                                                                \
+        if (out == NULL || !_scalar_of_type(idx, NVS_CONFIG_TYPE_##type_)) {         \
+            return ESP_ERR_INVALID_ARG;                                              \
+        }                                                                            \
+        _nvsconfig_get_scalar(idx, out);                                             \
+        return ESP_OK;                                                               \
+    }
+NVS_CONFIG_TYPES(_NVS_TYPED_BY_INDEX)
+#undef _NVS_TYPED_BY_INDEX
+
+#if CONFIG_NVS_CONFIG_GENERIC_ENGINE
+/**
+ * @brief Table-driven getters and setters (CONFIG_NVS_CONFIG_GENERIC_ENGINE).
+ *
+ * One implementation per kind of parameter behind the inline Param_*
+ * wrappers in nvs_config.h, with the scalar functions above.
+ */
+
+/** Print one element of type @p type at @p p with its format.inc formatter. */
+static int _print_element(NvsConfigType_t type, const void* p, char* buf, size_t buf_size)
+{
+    switch (type) {
+#define PRINT_FORMAT(type_, formatter_)                   \
+    case NVS_CONFIG_TYPE_##type_: {                       \
+        type_ _v;                                         \
+        memcpy(&_v, p, sizeof(_v));                       \
+        return formatter_(_v, buf, buf_size);             \
+    }
+#include "format.inc"
+#undef PRINT_FORMAT
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief "[a,b,...]" of array @p idx; caller holds s_nvs_mutex.
+ * @return Characters written, or @p buf_size if the output was truncated.
+ */
+static int _print_array(NvsConfigParamIndex_t idx, char* buf, size_t buf_size)
+{
+    const NvsConfigParamEntry_t* e = &g_nvsconfig_params[idx];
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    if (buf_size < 2) {
+        if (buf_size > 0) buf[0] = '\0';
+        return 1;
+    }
+    int offset = 0;
+    size_t remaining_size = buf_size - 1;
+    buf[offset++] = '[';
+    for (size_t i = 0; i < e->element_count; ++i) {
+        int written = _print_element(e->type, (const uint8_t*)slot->value + i * e->element_size,
+                                     buf + offset, remaining_size);
+        if (written < 0 || (size_t)written >= remaining_size) {
+            buf[buf_size - 1] = '\0';
+            return buf_size;
+        }
+        offset += written;
+        remaining_size -= written;
+        if (i < e->element_count - 1) {
+            if (remaining_size <= 1) {
+                buf[buf_size - 1] = '\0';
+                return buf_size;
+            }
+            buf[offset++] = ',';
+            buf[offset] = '\0';
+            remaining_size--;
+        }
+    }
+    if (remaining_size <= 1) {
+        buf[buf_size - 1] = '\0';
+        return buf_size;
+    }
+    buf[offset++] = ']';
+    buf[offset] = '\0';
+    return offset;
+}
+
+esp_err_t _nvsconfig_set_array(NvsConfigParamIndex_t idx, const void* value, size_t length)
+{
+    if (_secure_denied(idx)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const NvsConfigParamEntry_t* e = &g_nvsconfig_params[idx];
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    if (length > e->element_count) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    esp_err_t ret;
+    bool wake = false;
+    _NvsConfigCapture_t cap;
+    size_t from, to;
+    if (_chunks_diff(slot->value, value, slot->size, &from, &to)) {
+        _capture_change(&cap, idx, slot->value, value, e->element_size, e->element_count);
+        memcpy(slot->value, value, slot->size);
+        _bits_assign(s_nondefault_bits, idx, memcmp(value, slot->default_value, slot->size) != 0);
+        wake = _mark_dirty_span(idx, slot->size, from, to);
+        s_write_counts[idx]++;
+        ret = ESP_OK;
+    } else {
+        ret = ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    if (wake) _save_notify();
+    if (ret == ESP_OK) _nvsconfig_notify_change(idx, &cap);
+    return ret;
+}
+
+esp_err_t _nvsconfig_set_range(NvsConfigParamIndex_t idx, size_t first, const void* values, size_t count)
+{
+    if (_secure_denied(idx)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const NvsConfigParamEntry_t* e = &g_nvsconfig_params[idx];
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    if (first > e->element_count || count > e->element_count - first) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const size_t from = first * e->element_size;
+    const size_t bytes = count * e->element_size;
+    uint8_t* dst = (uint8_t*)slot->value + from;
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    esp_err_t ret;
+    bool wake = false;
+    _NvsConfigCapture_t cap;
+    if (bytes > 0 && memcmp(dst, values, bytes) != 0) {
+        _capture_change(&cap, idx, dst, values, e->element_size, count);
+        if (cap.active) cap.change.first += first;
+        memcpy(dst, values, bytes);
+        _bits_assign(s_nondefault_bits, idx,
+                     _range_nondefault(idx, slot->value, slot->default_value, slot->size, from, bytes));
+        wake = _mark_dirty_span(idx, slot->size, from, from + bytes);
+        s_write_counts[idx]++;
+        ret = ESP_OK;
+    } else {
+        ret = ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    if (wake) _save_notify();
+    if (ret == ESP_OK) _nvsconfig_notify_change(idx, &cap);
+    return ret;
+}
+
+esp_err_t _nvsconfig_get_range(NvsConfigParamIndex_t idx, size_t first, void* buffer, size_t count)
+{
+    const NvsConfigParamEntry_t* e = &g_nvsconfig_params[idx];
+    if (first > e->element_count || count > e->element_count - first) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    memcpy(buffer, (const uint8_t*)s_slots[idx].value + first * e->element_size, count * e->element_size);
+    xSemaphoreGive(s_nvs_mutex);
+    return ESP_OK;
+}
+
+const void* _nvsconfig_get_array(NvsConfigParamIndex_t idx, size_t* out_length)
+{
+    const void* ptr = _nvsconfig_acquire(idx, out_length);
+    _nvsconfig_release();
+    return ptr;
+}
+
+const void* _nvsconfig_acquire(NvsConfigParamIndex_t idx, size_t* out_length)
+{
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    if (out_length) {
+        const uint16_t* len = _string_length(idx);
+        *out_length = len ? *len : g_nvsconfig_params[idx].element_count;
+    }
+    return s_slots[idx].value;
+}
+
+void _nvsconfig_release(void)
+{
+    xSemaphoreGive(s_nvs_mutex);
+}
+
+esp_err_t _nvsconfig_copy(NvsConfigParamIndex_t idx, void* buffer, size_t buffer_size)
+{
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    const uint16_t* len = _string_length(idx);
+    const size_t required = len ? (size_t)*len + 1 : s_slots[idx].size;
+    if (buffer_size < required) {
+        xSemaphoreGive(s_nvs_mutex);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(buffer, s_slots[idx].value, required);
+    xSemaphoreGive(s_nvs_mutex);
+    return ESP_OK;
+}
+
+esp_err_t _nvsconfig_set_string(NvsConfigParamIndex_t idx, const char* value)
+{
+    if (_secure_denied(idx)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const size_t size = s_slots[idx].size;
+    return _string_set(idx, s_slots[idx].value, _string_length(idx), size, s_slots[idx].default_value, value,
+                       strnlen(value, size));
+}
+
+esp_err_t NvsConfig_ResetByIndex(NvsConfigParamIndex_t idx)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    if (g_nvsconfig_params[idx].is_string) {
+        return _string_reset(idx, slot->value, _string_length(idx), slot->default_value);
+    }
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    esp_err_t ret = ESP_FAIL;
+    bool wake = false;
+    size_t from, to;
+    if (!g_nvsconfig_params[idx].is_array) {
+        if (!_scalar_equal(idx, slot->value, slot->default_value)) {
+            _seq_write_begin(idx);
+            memcpy(slot->value, slot->default_value, slot->size);
+            _seq_write_end(idx);
+            _bits_assign(s_nondefault_bits, idx, false);
+            wake = _mark_dirty(idx, slot->size);
+            ret = ESP_OK;
+        }
+    } else if (_chunks_diff(slot->value, slot->default_value, slot->size, &from, &to)) {
+        memcpy(slot->value, slot->default_value, slot->size);
+        _bits_assign(s_nondefault_bits, idx, false);
+        wake = _mark_dirty_span(idx, slot->size, from, to);
+        ret = ESP_OK;
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    if (wake) _save_notify();
+    return ret;
+}
+
+int NvsConfig_PrintByIndex(NvsConfigParamIndex_t idx, char* buf, size_t buf_size)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT) {
+        return -1;
+    }
+    const NvsConfigParamEntry_t* e = &g_nvsconfig_params[idx];
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    int result;
+    if (e->is_string) {
+        /* Direct copy: no format string to interpret */
+        const size_t len = *_string_length(idx);
+        if (buf_size > 0) {
+            const size_t n = len < buf_size - 1 ? len : buf_size - 1;
+            memcpy(buf, slot->value, n);
+            buf[n] = '\0';
+        }
+        result = (int)len;
+    } else if (!e->is_array) {
+        result = _print_element(e->type, slot->value, buf, buf_size);
+    } else {
+        result = _print_array(idx, buf, buf_size);
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    return result;
+}
+
+esp_err_t NvsConfig_SetByIndex(NvsConfigParamIndex_t idx, const void* data, size_t data_size)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT || data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const NvsConfigParamEntry_t* e = &g_nvsconfig_params[idx];
+    const size_t full_size = s_slots[idx].size;
+    if (e->is_string) {
+        if (_secure_denied(idx)) return ESP_ERR_INVALID_STATE;
+        return _string_set(idx, s_slots[idx].value, _string_length(idx), full_size, s_slots[idx].default_value,
+                           (const char*)data, strnlen((const char*)data, data_size));
+    }
+    if (!e->is_array) {
+        if (data_size != full_size) return ESP_ERR_INVALID_SIZE;
+        return _nvsconfig_set_scalar(idx, data);
+    }
+    if (data_size > full_size) return ESP_ERR_INVALID_SIZE;
+    if (data_size == full_size) {
+        return _nvsconfig_set_array(idx, data, e->element_count);
+    }
+    /* Partial write: zero-fill remaining elements (heap, arrays can be large) */
+    void* tmp = calloc(1, full_size);
+    if (tmp == NULL) return ESP_ERR_NO_MEM;
+    memcpy(tmp, data, data_size);
+    _nvsconfig_set_array(idx, tmp, e->element_count);
+    free(tmp);
+    return ESP_ERR_INVALID_SIZE; /* warning: partial write */
+}
+
+esp_err_t NvsConfig_GetByIndex(NvsConfigParamIndex_t idx, void* data, size_t data_size)
+{
+    if ((size_t)idx >= PARAM_INDEX_COUNT || data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const NvsConfigParamEntry_t* e = &g_nvsconfig_params[idx];
+    const size_t full_size = s_slots[idx].size;
+    if (e->is_string) {
+        if (data_size == 0) return ESP_ERR_INVALID_SIZE;
+        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+        const size_t len = *_string_length(idx);
+        const size_t n = len < data_size ? len : data_size - 1;
+        memcpy(data, s_slots[idx].value, n);
+        ((char*)data)[n] = '\0';
+        xSemaphoreGive(s_nvs_mutex);
+        return n == len ? ESP_OK : ESP_ERR_INVALID_SIZE; /* warning: truncated */
+    }
+    if (!e->is_array) {
+        if (data_size != full_size) return ESP_ERR_INVALID_SIZE;
+        _nvsconfig_get_scalar(idx, data);
+        return ESP_OK;
+    }
+    if (data_size >= full_size) {
+        return _nvsconfig_copy(idx, data, data_size);
+    }
+    /* Partial read: copy only what fits into the caller's buffer */
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    memcpy(data, s_slots[idx].value, data_size);
+    xSemaphoreGive(s_nvs_mutex);
+    return ESP_ERR_INVALID_SIZE; /* warning: partial read */
+}
+#endif  // CONFIG_NVS_CONFIG_GENERIC_ENGINE
+
+/**
+ * @brief Typed per-key storage of scalars (CONFIG_NVS_CONFIG_TYPED_SCALARS).
+ *
+ * A scalar is written with the nvs_set_*() call matching its type instead of
+ * nvs_set_blob(): a typed entry fits in a single 32-byte NVS item, where a
+ * blob needs an index entry plus a data entry and a longer lookup. Values are
+ * read in the configured format first and in the other one second, so data
+ * written by firmware with the option toggled is carried over and flagged as
+ * legacy, to be erased and rewritten by the next save.
+ */
+#define NVS_TYPED_SCALARS (CONFIG_NVS_CONFIG_TYPED_SCALARS && !CONFIG_NVS_CONFIG_STORAGE_PACKED)
+
+#define _NVS_PRIM_CALLS(X) \
+    X(u8, uint8_t)         \
+    X(i8, int8_t)          \
+    X(u16, uint16_t)       \
+    X(i16, int16_t)        \
+    X(u32, uint32_t)       \
+    X(i32, int32_t)        \
+    X(u64, uint64_t)       \
+    X(i64, int64_t)
+
+/** Read the typed entry of scalar @p idx into @p out; @p out is untouched on failure. */
+static esp_err_t _typed_get(nvs_handle_t handle, size_t idx, void* out, size_t* length)
+{
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    esp_err_t err = ESP_ERR_NVS_NOT_FOUND;
+    switch (slot->prim) {
+#define X(prim_, ctype_)                                 \
+    case _NVS_PRIM_##prim_: {                            \
+        ctype_ raw;                                      \
+        err = nvs_get_##prim_(handle, slot->key, &raw);  \
+        if (err == ESP_OK) {                             \
+            memcpy(out, &raw, sizeof(raw));              \
+        }                                                \
+        break;                                           \
+    }
+        _NVS_PRIM_CALLS(X)
+#undef X
+    default:
+        break;
+    }
+    if (err == ESP_OK) {
+        *length = slot->size;
+    }
+    return err;
+}
+
+#if NVS_TYPED_SCALARS
+/** Write scalar @p idx from @p value as its typed entry. */
+static esp_err_t _typed_set(nvs_handle_t handle, size_t idx, const void* value)
+{
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    switch (slot->prim) {
+#define X(prim_, ctype_)                                    \
+    case _NVS_PRIM_##prim_: {                               \
+        ctype_ raw;                                         \
+        memcpy(&raw, value, sizeof(raw));                   \
+        return nvs_set_##prim_(handle, slot->key, raw);     \
+    }
+        _NVS_PRIM_CALLS(X)
+#undef X
+    default:
+        return nvs_set_blob(handle, slot->key, value, slot->size);
+    }
+}
+#endif
+
+/**
+ * @brief Read a value stored under its own key.
+ *
+ * A scalar is looked up in the configured format first and in the other one
+ * second. @p legacy reports a value found in the other format, or an entry of
+ * another type (ESP_ERR_NVS_TYPE_MISMATCH, e.g. after the parameter's type
+ * changed) that the next save must erase before writing.
+ */
+static esp_err_t _perkey_get_value(nvs_handle_t handle, size_t idx, void* out, size_t* length, bool* legacy)
+{
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    *legacy = false;
+    if (slot->prim == _NVS_PRIM_blob) {
+        return nvs_get_blob(handle, slot->key, out, length);
+    }
+    if (slot->prim == _NVS_PRIM_str) {
+        /* A char ARRAY turned STRING left a blob under the same key */
+        esp_err_t err = nvs_get_str(handle, slot->key, out, length);
+        if (err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_TYPE_MISMATCH) {
+            err = nvs_get_blob(handle, slot->key, out, length);
+            *legacy = (err == ESP_OK);
+        }
+        return err;
+    }
+
+#if NVS_TYPED_SCALARS
+    esp_err_t err = _typed_get(handle, idx, out, length);
+#else
+    esp_err_t err = nvs_get_blob(handle, slot->key, out, length);
+#endif
+    if (err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_TYPE_MISMATCH) {
+        const bool mismatch = (err == ESP_ERR_NVS_TYPE_MISMATCH);
+#if NVS_TYPED_SCALARS
+        err = nvs_get_blob(handle, slot->key, out, length);
+#else
+        err = _typed_get(handle, idx, out, length);
+#endif
+        *legacy = mismatch || err == ESP_OK;
+    }
+    return err;
+}
+
+/**
+ * @brief Staged writes of one transaction, laid out like the live values.
+ */
+struct NvsConfigTxn_s {
+    NvsConfigValues_t values;
+    _NvsConfigBitset_t staged;
+};
+
+NvsConfigTxn_t* NvsConfig_Begin(void)
+{
+    NvsConfigTxn_t* txn = calloc(1, sizeof(*txn));
+    if (txn == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %u byte transaction", (unsigned int)sizeof(*txn));
+    }
+    return txn;
+}
+
+esp_err_t NvsConfig_TxnSet(NvsConfigTxn_t* txn, const char* name, const void* data, size_t data_size)
+{
+    if (txn == NULL || name == NULL || data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const NvsConfigParamEntry_t* entry = NvsConfig_FindParam(name);
+    if (entry == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (NvsConfig_SecureLevel() > entry->secure_level) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const size_t idx = (size_t)(entry - g_nvsconfig_params);
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    uint8_t* staged = (uint8_t*)&txn->values + slot->offset;
+    if (entry->is_string) {
+        /* Characters up to the first NUL; the rest of the slot stays zero */
+        const size_t len = strnlen((const char*)data, data_size);
+        if (len >= slot->size) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(staged, data, len);
+        memset(staged + len, 0, slot->size - len);
+        _bits_assign(txn->staged, idx, true);
+        return ESP_OK;
+    }
+    if (data_size > slot->size || (!entry->is_array && data_size != slot->size)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    /* Partial array write: zero-fill remaining elements, as the registry does */
+    memcpy(staged, data, data_size);
+    memset(staged + data_size, 0, slot->size - data_size);
+    _bits_assign(txn->staged, idx, true);
+    return data_size == slot->size ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t NvsConfig_Commit(NvsConfigTxn_t* txn)
+{
+    if (txn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    _NvsConfigBitset_t changed = {0};
+    bool wake = false;
+    esp_err_t ret = ESP_OK;
+    const uint8_t* image = (const uint8_t*)&txn->values;
+
+    size_t staged = 0;
+    NVS_BITS_FOREACH(txn->staged, i) {
+        staged++;
+    }
+    _NvsConfigCapture_t* caps = NULL;
+    size_t ncaps = 0;
+
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    NVS_BITS_FOREACH(txn->staged, i) {
+        if (NvsConfig_SecureLevel() > g_nvsconfig_params[i].secure_level) {
+            ret = ESP_ERR_INVALID_STATE;
+            break;
+        }
+    }
+    /* One capture per staged parameter, in bit order, if anyone wants values.
+       Decided under the lock, like the setters' _capture_change(); without
+       memory the changes are delivered with unavailable values. */
+    if (ret == ESP_OK && atomic_load_explicit(&s_callback_value_total, memory_order_relaxed) != 0) {
+        caps = calloc(staged, sizeof(*caps));
+        if (caps == NULL) {
+            ESP_LOGE(TAG, "No memory to capture %u committed changes", (unsigned int)staged);
+        }
+    }
+    if (ret == ESP_OK) {
+        NVS_BITS_FOREACH(txn->staged, i) {
+            const _NvsConfigSlot_t* slot = &s_slots[i];
+            const uint8_t* value = image + slot->offset;
+            const bool scalar = !g_nvsconfig_params[i].is_array && !g_nvsconfig_params[i].is_string;
+            size_t from = 0, to = slot->size;
+            if (scalar ? _scalar_equal((NvsConfigParamIndex_t)i, slot->value, value)
+                       : !_chunks_diff(slot->value, value, slot->size, &from, &to)) {
+                continue;
+            }
+            if (caps != NULL && slot->prim == _NVS_PRIM_str) {
+                _capture_string_change(&caps[ncaps++], (NvsConfigParamIndex_t)i, slot->value,
+                                       *_string_length(i), (const char*)value, strlen((const char*)value));
+            }
+            else if (caps != NULL) {
+                const NvsConfigParamEntry_t* entry = &g_nvsconfig_params[i];
+                _capture_change(&caps[ncaps++], (NvsConfigParamIndex_t)i, slot->value, value,
+                                entry->element_size, entry->element_count);
+            }
+            _seq_write_begin((NvsConfigParamIndex_t)i);
+            memcpy(slot->value, value, slot->size);
+            _seq_write_end((NvsConfigParamIndex_t)i);
+            size_t bytes = slot->size;
+            if (slot->prim == _NVS_PRIM_str) {
+                *_string_length(i) = (uint16_t)strlen((const char*)value);
+                bytes = *_string_length(i) + 1;
+            }
+            _bits_assign(s_nondefault_bits, i,
+                         scalar ? !_scalar_equal((NvsConfigParamIndex_t)i, value, slot->default_value)
+                                : memcmp(value, slot->default_value, slot->size) != 0);
+            wake |= _mark_dirty_span(i, bytes, from, to);
+            s_write_counts[i]++;
+            _bits_assign(changed, i, true);
+        }
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    free(txn);
+
+    if (wake) _save_notify();
+    size_t k = 0;
+    NVS_BITS_FOREACH(changed, i) {
+        _nvsconfig_notify_change((NvsConfigParamIndex_t)i, caps != NULL ? &caps[k++] : NULL);
+    }
+    free(caps);
+    return ret;
+}
+
+void NvsConfig_Abort(NvsConfigTxn_t* txn)
+{
+    free(txn);
+}
+
+uint32_t NvsConfig_Epoch(void)
+{
+    return atomic_load_explicit(&s_config_epoch, memory_order_acquire);
+}
+
+uint32_t NvsConfig_GetGeneration(NvsConfigParamIndex_t idx)
+{
+    return (size_t)idx < PARAM_INDEX_COUNT ? atomic_load_explicit(&s_param_gen[idx], memory_order_acquire) : 0;
+}
+
+bool NvsConfig_ChangedSince(NvsConfigParamIndex_t idx, uint32_t gen)
+{
+    return _gen_after(NvsConfig_GetGeneration(idx), gen);
+}
+
+bool NvsConfig_AnyChangedSince(const NvsConfigParamIndex_t* indices, size_t count, uint32_t gen)
+{
+    if (atomic_load_explicit(&s_config_epoch, memory_order_acquire) == gen) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (NvsConfig_ChangedSince(indices[i], gen)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t NvsConfig_Snapshot(NvsConfigValues_t* out)
+{
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    memcpy(out, &g_nvsconfig_controller, sizeof(*out));
+    const uint32_t gen = atomic_load_explicit(&s_config_epoch, memory_order_relaxed);
+    xSemaphoreGive(s_nvs_mutex);
+    return gen;
+}
+
+uint32_t NvsConfig_SnapshotSince(NvsConfigValues_t* out, uint32_t since)
+{
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    const uint32_t gen = atomic_load_explicit(&s_config_epoch, memory_order_relaxed);
+    if (gen != since) {
+        for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
+            if (_gen_after(atomic_load_explicit(&s_param_gen[i], memory_order_relaxed), since)) {
+                memcpy((uint8_t*)out + s_slots[i].offset, s_slots[i].value, s_slots[i].size);
+            }
+        }
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    return gen;
+}
+
+/**
+ * @brief Digest of the value each parameter has on flash, guarded by
+ *        s_save_mutex once Init has returned.
+ *
+ * A staged value whose digest matches is already persisted and is not written
+ * again, so A -> B -> A between two saves, or a reset to the stored value,
+ * costs no flash erase cycles. Values of up to 8 bytes (every scalar) are kept
+ * verbatim; larger ones use 64-bit FNV-1a. s_persisted_known is clear where
+ * flash content is unknown (not found at boot, layout change, failed commit).
+ */
+static uint64_t s_persisted_digest[PARAM_INDEX_COUNT];
+static _NvsConfigBitset_t s_persisted_known;
+
+static uint64_t _persist_digest(const void* data, size_t size)
+{
+    uint64_t d = 0;
+    if (size <= sizeof(d)) {
+        memcpy(&d, data, size);
+        return d;
+    }
+    const uint8_t* p = (const uint8_t*)data;
+    d = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        d = (d ^ p[i]) * 1099511628211ull;
+    }
+    return d;
+}
+
+/**
+ * @brief Staging area for one save: dirty values copied out under the lock,
+ *        plus the generation each value had when it was copied.
+ */
+typedef struct {
+    NvsConfigValues_t values;
+    uint32_t gen[PARAM_INDEX_COUNT];
+    uint64_t digest[PARAM_INDEX_COUNT];
+    _NvsConfigBitset_t staged; /**< Dirty when copied; cleared again on a failed write. */
+    _NvsConfigBitset_t write;  /**< Staged and different from flash. */
+    _NvsChunkBitset_t chunks;  /**< Dirty array chunks when copied. */
+} _NvsConfigSaveStage_t;
+
+#if CONFIG_NVS_CONFIG_STORAGE_PACKED
+/**
+ * @brief Packed storage layout.
+ *
+ * The whole value set is stored as the byte image of NvsConfigValues_t, split
+ * into chunks of CONFIG_NVS_CONFIG_PACKED_CHUNK_SIZE bytes. Chunk keys embed
+ * the layout hash ("_p<hash><n>"), so chunks written for an older parameter
+ * table are never mistaken for current ones. A header and a layout descriptor
+ * (key, offset and size of every parameter) are rewritten only when the table
+ * changes; loading an older layout matches values by key and size.
+ */
+#define NVS_PACKED_MAGIC       0x4E564350u /* "NVCP" */
+#define NVS_PACKED_VERSION     1
+#define NVS_PACKED_HDR_KEY     "_pk_hdr"
+#define NVS_PACKED_DESC_KEY    "_pk_desc"
+#define NVS_PACKED_CHUNK_SIZE  CONFIG_NVS_CONFIG_PACKED_CHUNK_SIZE
+#define NVS_PACKED_CHUNK_COUNT ((sizeof(NvsConfigValues_t) + NVS_PACKED_CHUNK_SIZE - 1) / NVS_PACKED_CHUNK_SIZE)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t layout_hash;
+    uint32_t field_count;
+    uint32_t image_size;
+    uint32_t chunk_size;
+} _NvsPackedHeader_t;
+
+typedef struct {
+    char key[16];
+    uint32_t offset;
+    uint32_t size;
+} _NvsPackedField_t;
+
+#define _NVS_PACKED_FIELD(name_) \
+    {#name_, (uint32_t)offsetof(NvsConfigValues_t, name_), (uint32_t)sizeof(((NvsConfigValues_t*)0)->name_)},
+#define PARAM(secure_lvl_, type_, name_, default_value_, description_)        _NVS_PACKED_FIELD(name_)
+#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) _NVS_PACKED_FIELD(name_)
+#define STRING(secure_lvl_, maxlen_, name_, default_value_, description_)    _NVS_PACKED_FIELD(name_)
+static const _NvsPackedField_t s_packed_fields[PARAM_INDEX_COUNT] = {
+#include "param_table.inc"
+};
+#undef PARAM
+#undef ARRAY
+#undef STRING
+#undef _NVS_PACKED_FIELD
+
+/* Save-path state, guarded by s_save_mutex once Init has returned. */
+static uint32_t s_packed_hash = 0;                          /**< Layout hash of this firmware. */
+static uint32_t s_packed_stored_hash = 0;                   /**< Layout hash in the header, 0 if none. */
+static uint32_t s_packed_stored_chunks = 0;                 /**< Chunk count of the stored layout. */
+static bool s_packed_from_per_key = false;                  /**< Values were read from per-key blobs. */
+static bool s_packed_pending[NVS_PACKED_CHUNK_COUNT];       /**< Chunks not yet written for this layout. */
+
+/** @return true while flash does not yet hold a complete image in this layout. */
+static bool _packed_needs_publish(void)
+{
+    if (s_packed_hash == 0 || s_packed_stored_hash != s_packed_hash) {
+        return true;
+    }
+    for (uint32_t c = 0; c < NVS_PACKED_CHUNK_COUNT; c++) {
+        if (s_packed_pending[c]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t _packed_layout_hash(void)
+{
+    const uint32_t extra[2] = {(uint32_t)sizeof(NvsConfigValues_t), (uint32_t)NVS_PACKED_CHUNK_SIZE};
+    const uint8_t* parts[2] = {(const uint8_t*)s_packed_fields, (const uint8_t*)extra};
+    const size_t lens[2] = {sizeof(s_packed_fields), sizeof(extra)};
+    uint32_t h = 2166136261u; /* FNV-1a */
+
+    for (int p = 0; p < 2; p++) {
+        for (size_t i = 0; i < lens[p]; i++) {
+            h = (h ^ parts[p][i]) * 16777619u;
+        }
+    }
+    return h ? h : 1; /* 0 means "no packed data" */
+}
+
+static void _packed_chunk_key(char* key, size_t key_size, uint32_t hash, uint32_t chunk)
+{
+    snprintf(key, key_size, "_p%08" PRIx32 "%" PRIu32, hash, chunk);
+}
+
+/**
+ * @brief Packed data read at boot, consumed by _packed_load_value().
+ */
+typedef struct {
+    nvs_handle_t handle;
+    uint8_t* image;                  /**< Stored image, NULL to fall back to per-key blobs. */
+    bool* chunk_ok;                  /**< Per stored chunk: read successfully. */
+    _NvsPackedField_t* fields;       /**< Stored descriptor, NULL if the layout is current. */
+    uint32_t field_count;
+    uint32_t image_size;
+    uint32_t chunk_size;
+    uint32_t cursor;                 /**< Descriptor search start, see _packed_find(). */
+    bool same_layout;                /**< Stored layout hash matches this firmware. */
+    bool resave;                     /**< Loaded values must be rewritten in the current layout. */
+} _NvsPackedLoad_t;
+
+static void _packed_load_end(_NvsPackedLoad_t* ld)
+{
+    free(ld->image);
+    free(ld->chunk_ok);
+    free(ld->fields);
+}
+
+/**
+ * @brief Read the header, descriptor (if the layout changed) and every chunk.
+ *
+ * Without a usable header the loader falls back to the per-key blobs, which
+ * migrates a device that previously ran in per-key mode.
+ */
+static void _packed_load_begin(_NvsPackedLoad_t* ld, nvs_handle_t handle)
+{
+    memset(ld, 0, sizeof(*ld));
+    ld->handle = handle;
+    ld->resave = true;
+
+    s_packed_hash = _packed_layout_hash();
+    s_packed_stored_hash = 0;
+    s_packed_stored_chunks = 0;
+    s_packed_from_per_key = true;
+    for (uint32_t c = 0; c < NVS_PACKED_CHUNK_COUNT; c++) {
+        s_packed_pending[c] = true;
+    }
+
+    _NvsPackedHeader_t hdr;
+    size_t len = sizeof(hdr);
+    if (nvs_get_blob(handle, NVS_PACKED_HDR_KEY, &hdr, &len) != ESP_OK || len != sizeof(hdr) ||
+        hdr.magic != NVS_PACKED_MAGIC || hdr.version != NVS_PACKED_VERSION || hdr.chunk_size == 0) {
+        ESP_LOGI(TAG, "No packed data, reading per-key blobs");
+        return;
+    }
+
+    const uint32_t chunks = (hdr.image_size + hdr.chunk_size - 1) / hdr.chunk_size;
+    s_packed_stored_hash = hdr.layout_hash;
+    s_packed_stored_chunks = chunks;
+    s_packed_from_per_key = false;
+
+    if (hdr.layout_hash != s_packed_hash) {
+        ESP_LOGW(TAG, "Packed layout changed (0x%08" PRIx32 " -> 0x%08" PRIx32 "), matching values by key",
+                 hdr.layout_hash, s_packed_hash);
+        ld->fields = malloc(hdr.field_count * sizeof(_NvsPackedField_t));
+        len = hdr.field_count * sizeof(_NvsPackedField_t);
+        if (ld->fields == NULL || nvs_get_blob(handle, NVS_PACKED_DESC_KEY, ld->fields, &len) != ESP_OK ||
+            len != hdr.field_count * sizeof(_NvsPackedField_t)) {
+            ESP_LOGE(TAG, "Packed layout descriptor unreadable, using defaults");
+            hdr.field_count = 0;
+        }
+        ld->field_count = hdr.field_count;
+    }
+    else {
+        ld->same_layout = true;
+        ld->resave = false;
+        memset(s_packed_pending, 0, sizeof(s_packed_pending));
+    }
+
+    ld->image = malloc(hdr.image_size);
+    ld->chunk_ok = calloc(chunks, sizeof(bool));
+    if (ld->image == NULL || ld->chunk_ok == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate %" PRIu32 " byte packed image", hdr.image_size);
+        free(ld->image);
+        ld->image = NULL;
+        return;
+    }
+    ld->image_size = hdr.image_size;
+    ld->chunk_size = hdr.chunk_size;
+
+    for (uint32_t c = 0; c < chunks; c++) {
+        char key[16];
+        const uint32_t off = c * hdr.chunk_size;
+        const size_t want = (hdr.image_size - off < hdr.chunk_size) ? hdr.image_size - off : hdr.chunk_size;
+        len = want;
+        _packed_chunk_key(key, sizeof(key), hdr.layout_hash, c);
+        ld->chunk_ok[c] = nvs_get_blob(handle, key, ld->image + off, &len) == ESP_OK && len == want;
+        if (!ld->chunk_ok[c]) {
+            ESP_LOGW(TAG, "Packed chunk %s missing, its parameters use defaults", key);
+        }
+    }
+}
+
+/**
+ * @brief Locate a current parameter in the stored image.
+ *
+ * Searching starts just after the previous match, so a table that only had
+ * parameters appended, inserted or removed is matched in one pass.
+ */
+static bool _packed_find(_NvsPackedLoad_t* ld, const _NvsPackedField_t* f, uint32_t* src)
+{
+    if (ld->same_layout) {
+        *src = f->offset;
+        return true;
+    }
+    for (uint32_t n = 0; n < ld->field_count; n++) {
+        const uint32_t i = (ld->cursor + n) % ld->field_count;
+        if (strncmp(ld->fields[i].key, f->key, sizeof(f->key)) == 0) {
+            ld->cursor = i + 1;
+            *src = ld->fields[i].offset;
+            return ld->fields[i].size == f->size;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief nvs_get_blob() equivalent for the load X-macro in packed mode.
+ */
+static esp_err_t _packed_load_value(_NvsPackedLoad_t* ld, NvsConfigParamIndex_t idx, void* out, size_t* length)
+{
+    const _NvsPackedField_t* f = &s_packed_fields[idx];
+
+    if (s_packed_from_per_key) {
+        bool legacy;
+        return _perkey_get_value(ld->handle, idx, out, length, &legacy);
+    }
+
+    uint32_t src;
+    if (ld->image == NULL || !_packed_find(ld, f, &src) || src + f->size > ld->image_size) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    for (uint32_t c = src / ld->chunk_size; c <= (src + f->size - 1) / ld->chunk_size; c++) {
+        if (!ld->chunk_ok[c]) {
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+    }
+    memcpy(out, ld->image + src, f->size);
+    *length = f->size;
+    return ESP_OK;
+}
+
+/**
+ * @brief Once every chunk of the current layout is on flash, publish it: write
+ *        the header and descriptor, then drop data in the previous format.
+ */
+static esp_err_t _packed_publish_layout(nvs_handle_t handle)
+{
+    const _NvsPackedHeader_t hdr = {
+        .magic = NVS_PACKED_MAGIC,
+        .version = NVS_PACKED_VERSION,
+        .layout_hash = s_packed_hash,
+        .field_count = PARAM_INDEX_COUNT,
+        .image_size = sizeof(NvsConfigValues_t),
+        .chunk_size = NVS_PACKED_CHUNK_SIZE,
+    };
+    esp_err_t err = nvs_set_blob(handle, NVS_PACKED_DESC_KEY, s_packed_fields, sizeof(s_packed_fields));
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, NVS_PACKED_HDR_KEY, &hdr, sizeof(hdr));
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to publish packed layout (Error: 0x%x %s)", err, esp_err_to_name(err));
+        return err;
+    }
+
+    /* Best effort: leftovers only cost flash space */
+    for (uint32_t c = 0; s_packed_stored_hash != 0 && c < s_packed_stored_chunks; c++) {
+        char key[16];
+        _packed_chunk_key(key, sizeof(key), s_packed_stored_hash, c);
+        nvs_erase_key(handle, key);
+    }
+    for (size_t i = 0; s_packed_from_per_key && i < PARAM_INDEX_COUNT; i++) {
+        nvs_erase_key(handle, s_packed_fields[i].key);
+    }
+    nvs_commit(handle);
+
+    s_packed_stored_hash = s_packed_hash;
+    s_packed_stored_chunks = NVS_PACKED_CHUNK_COUNT;
+    s_packed_from_per_key = false;
+    return ESP_OK;
+}
+
+/**
+ * @brief Phase 2 in packed mode: rewrite every chunk that holds a staged value.
+ *        Runs without s_nvs_mutex.
+ *
+ * Arrays with dirty chunk bits only pull in the packed chunks overlapping
+ * those array chunks. The stage holds the full value image. Values in a chunk whose write fails
+ * are un-staged so they stay dirty. While the current layout is not yet
+ * published, nothing counts as saved.
+ *
+ * @return true if the written chunks were committed under the current layout.
+ */
+static bool _save_write_packed(_NvsConfigSaveStage_t* stage)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS namespace '%s' (Error: 0x%x %s)",
+                 NVS_NAMESPACE, err, esp_err_to_name(err));
+        return false;
+    }
+
+    if (s_packed_hash == 0) {
+        /* Init could not read flash: rewrite everything in the current layout */
+        s_packed_hash = _packed_layout_hash();
+        memset(s_packed_pending, true, sizeof(s_packed_pending));
+    }
+
+    const uint8_t* image = (const uint8_t*)&stage->values;
+    bool write[NVS_PACKED_CHUNK_COUNT];
+    memcpy(write, s_packed_pending, sizeof(write));
+    NVS_BITS_FOREACH(stage->write, i) {
+        const _NvsPackedField_t* f = &s_packed_fields[i];
+        if (_chunks_any(stage->chunks, i)) {
+            /* Only the array chunks that changed */
+            const _NvsChunkSpan_t* span = &s_chunk_spans[i];
+            for (uint32_t k = 0; k < span->count; k++) {
+                if (!_bits_test(stage->chunks, span->first + k)) {
+                    continue;
+                }
+                const uint32_t lo = f->offset + k * NVS_ARRAY_CHUNK_SIZE;
+                const uint32_t hi = (k + 1) * NVS_ARRAY_CHUNK_SIZE < f->size ? lo + NVS_ARRAY_CHUNK_SIZE : f->offset + f->size;
+                for (uint32_t c = lo / NVS_PACKED_CHUNK_SIZE; c <= (hi - 1) / NVS_PACKED_CHUNK_SIZE; c++) {
+                    write[c] = true;
+                }
+            }
+            continue;
+        }
+        for (uint32_t c = f->offset / NVS_PACKED_CHUNK_SIZE; c <= (f->offset + f->size - 1) / NVS_PACKED_CHUNK_SIZE; c++) {
+            write[c] = true;
+        }
+    }
+
+    int chunksWritten = 0;
+    for (uint32_t c = 0; c < NVS_PACKED_CHUNK_COUNT; c++) {
+        if (!write[c]) {
+            continue;
+        }
+        char key[16];
+        const uint32_t off = c * NVS_PACKED_CHUNK_SIZE;
+        const size_t len = (sizeof(NvsConfigValues_t) - off < NVS_PACKED_CHUNK_SIZE) ? sizeof(NvsConfigValues_t) - off
+                                                                                        : NVS_PACKED_CHUNK_SIZE;
+        _packed_chunk_key(key, sizeof(key), s_packed_hash, c);
+        err = nvs_set_blob(handle, key, image + off, len);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set packed chunk %s (Error: 0x%x %s)", key, err, esp_err_to_name(err));
+            write[c] = false;
+            NVS_BITS_FOREACH(stage->write, i) {
+                const _NvsPackedField_t* f = &s_packed_fields[i];
+                if (f->offset < off + len && f->offset + f->size > off) {
+                    _bits_assign(stage->staged, i, false);
+                    _bits_assign(stage->write, i, false);
+                }
+            }
+        }
+        else {
+            chunksWritten++;
+        }
+    }
+
+    bool committed = false;
+    if (chunksWritten > 0) {
+        err = nvs_commit(handle);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "%d packed chunks committing to flash... Failed (Error: 0x%x %s)",
+                     chunksWritten, err, esp_err_to_name(err));
+        }
+        else {
+            ESP_LOGI(TAG, "%d packed chunks committing to flash... Done", chunksWritten);
+            for (uint32_t c = 0; c < NVS_PACKED_CHUNK_COUNT; c++) {
+                if (write[c]) s_packed_pending[c] = false;
+            }
+            committed = true;
+        }
     }
-#include "param_table.inc"
-#undef PARAM
-#undef ARRAY
+
+    if (committed && s_packed_stored_hash != s_packed_hash) {
+        bool complete = true;
+        for (uint32_t c = 0; c < NVS_PACKED_CHUNK_COUNT; c++) {
+            complete = complete && !s_packed_pending[c];
+        }
+        committed = complete && _packed_publish_layout(handle) == ESP_OK;
+    }
+    nvs_close(handle);
+    return committed;
+}
+#endif  // CONFIG_NVS_CONFIG_STORAGE_PACKED
 
 /**
- * @brief Registry wrapper functions.
+ * The one stage, guarded by s_save_mutex. Static rather than allocated per
+ * save, so a save cannot fail for lack of heap and peak RAM does not double.
+ */
+static _NvsConfigSaveStage_t s_save_stage;
+
+/**
+ * @brief Phase 1: copy every dirty value into the stage. Caller holds s_nvs_mutex.
  *
- * Generate static wrappers with uniform signatures so they can be stored
- * as function pointers in the NvsConfigParamEntry_t registry.
+ * Packed chunks are rewritten whole, so in packed mode the stage receives
+ * every value; only the dirty ones are marked as staged.
+ *
+ * @return Number of staged parameters.
  */
-#define PARAM(secure_lvl_, type_, name_, default_value_, description_)                 \
-    static bool _registry_is_dirty_##name_(void) {                                     \
-        return g_nvsconfig_controller.name_.is_dirty;                                  \
-    }                                                                                  \
-    static bool _registry_is_default_##name_(void) {                                   \
-        return g_nvsconfig_controller.name_.is_default;                                \
-    }                                                                                  \
-    static esp_err_t _registry_reset_##name_(void) {                                   \
-        return Param_Reset##name_();                                                   \
-    }                                                                                  \
-    static int _registry_print_##name_(char* buf, size_t buf_size) {                   \
-        return Param_Print##name_(buf, buf_size);                                      \
-    }                                                                                  \
-    static esp_err_t _registry_set_##name_(const void* data, size_t data_size) {       \
-        if (data_size != sizeof(type_)) return ESP_ERR_INVALID_SIZE;                   \
-        type_ val;                                                                     \
-        memcpy(&val, data, sizeof(type_));                                             \
-        return Param_Set##name_(val);                                                  \
-    }                                                                                  \
-    static esp_err_t _registry_get_##name_(void* data, size_t data_size) {             \
-        if (data_size != sizeof(type_)) return ESP_ERR_INVALID_SIZE;                   \
-        type_ val = Param_Get##name_();                                                \
-        memcpy(data, &val, sizeof(type_));                                             \
-        return ESP_OK;                                                                 \
+static int _save_stage_dirty(_NvsConfigSaveStage_t* stage)
+{
+    uint8_t* image = (uint8_t*)&stage->values;
+#if CONFIG_NVS_CONFIG_STORAGE_PACKED
+    memcpy(image, &g_nvsconfig_controller, sizeof(stage->values));
+#endif
+    int staged = 0;
+    NVS_BITS_FOREACH(s_dirty_bits, i) {
+#if !CONFIG_NVS_CONFIG_STORAGE_PACKED
+        memcpy(image + s_slots[i].offset, s_slots[i].value, s_slots[i].size);
+#endif
+        stage->gen[i] = s_param_gen[i];
+        _bits_assign(stage->staged, i, true);
+        staged++;
     }
+    for (size_t w = 0; w < NVS_CHUNK_BITSET_WORDS; w++) {
+        stage->chunks[w] = atomic_load_explicit(&s_dirty_chunks[w], memory_order_relaxed);
+    }
+    return staged;
+}
 
-#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_)           \
-    static bool _registry_is_dirty_##name_(void) {                                     \
-        return g_nvsconfig_controller.name_.is_dirty;                                  \
-    }                                                                                  \
-    static bool _registry_is_default_##name_(void) {                                   \
-        return g_nvsconfig_controller.name_.is_default;                                \
-    }                                                                                  \
-    static esp_err_t _registry_reset_##name_(void) {                                   \
-        return Param_Reset##name_();                                                   \
-    }                                                                                  \
-    static int _registry_print_##name_(char* buf, size_t buf_size) {                   \
-        return Param_Print##name_(buf, buf_size);                                      \
-    }                                                                                  \
-    static esp_err_t _registry_set_##name_(const void* data, size_t data_size) {       \
-        const size_t full_size = size_ * sizeof(type_);                                \
-        if (data_size > full_size) return ESP_ERR_INVALID_SIZE;                         \
-        if (data_size == full_size) {                                                   \
-            return Param_Set##name_((const type_*)data, size_);                         \
-        }                                                                               \
-        /* Partial write: zero-fill remaining elements */                               \
-        type_ tmp[size_];                                                               \
-        memset(tmp, 0, full_size);                                                      \
-        memcpy(tmp, data, data_size);                                                   \
-        Param_Set##name_(tmp, size_);                                                   \
-        return ESP_ERR_INVALID_SIZE; /* warning: partial write */                       \
-    }                                                                                   \
-    static esp_err_t _registry_get_##name_(void* data, size_t data_size) {              \
-        const size_t full_size = size_ * sizeof(type_);                                 \
-        if (data_size >= full_size) {                                                   \
-            return Param_Copy##name_((type_*)data, data_size);                          \
-        }                                                                               \
-        /* Partial read: copy only what fits into the caller's buffer */                \
-        xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);                                      \
-        memcpy(data, g_nvsconfig_controller.name_.value, data_size);                    \
-        xSemaphoreGive(s_nvs_mutex);                                                     \
-        return ESP_ERR_INVALID_SIZE; /* warning: partial read */                        \
+/**
+ * @brief Phase 2a: mark the staged values that differ from flash for writing.
+ *        Runs without s_nvs_mutex.
+ *
+ * Staged values that match the persisted digest stay staged, so their dirty
+ * bit is cleared, but are counted as suppressed writes instead.
+ *
+ * @return Number of values that have to be written.
+ */
+static int _save_filter_unchanged(_NvsConfigSaveStage_t* stage)
+{
+    const uint8_t* image = (const uint8_t*)&stage->values;
+    int pending = 0;
+    NVS_BITS_FOREACH(stage->staged, i) {
+        stage->digest[i] = _persist_digest(image + s_slots[i].offset, s_slots[i].size);
+        if (_bits_test(s_persisted_known, i) && s_persisted_digest[i] == stage->digest[i]) {
+            ESP_LOGD(TAG, "'%s' unchanged on flash, write suppressed", s_slots[i].key);
+            s_suppressed_counts[i]++;
+        }
+        else {
+            /* Unknown until the commit succeeds: a failed save may leave either value */
+            _bits_assign(s_persisted_known, i, false);
+            _bits_assign(stage->write, i, true);
+            pending++;
+        }
     }
-#include "param_table.inc"
-#undef PARAM
-#undef ARRAY
+#if CONFIG_NVS_CONFIG_STORAGE_PACKED
+    if (pending == 0 && _packed_needs_publish()) {
+        pending = 1;  // chunks of the current layout are still unwritten
+    }
+#endif
+    return pending;
+}
+
+/** Phase 2b: remember what a successful commit put on flash. */
+static void _save_record_persisted(const _NvsConfigSaveStage_t* stage)
+{
+    NVS_BITS_FOREACH(stage->write, i) {
+        s_persisted_digest[i] = stage->digest[i];
+        _bits_assign(s_persisted_known, i, true);
+    }
+}
+
+#if !CONFIG_NVS_CONFIG_STORAGE_PACKED
+static _NvsConfigBitset_t s_perkey_legacy; /**< Loaded from a legacy format, erased by the next save. */
+#endif
 
+#if NVS_CHUNKED_STORAGE
 /**
- * @brief Parameter registry: const array of entries with function pointers.
+ * @brief Chunked storage of large arrays (CONFIG_NVS_CONFIG_ARRAY_CHUNKED).
+ *
+ * An array spanning more than one NVS_ARRAY_CHUNK_SIZE chunk is stored as one
+ * blob per chunk instead of a single blob under its name, so a save rewrites
+ * only the chunks whose s_dirty_chunks bit is set. Chunk keys are
+ * "_c<name hash><chunk>" because a name may already use all 15 characters of
+ * an NVS key. Smaller arrays and scalars keep their own key.
  */
-#define PARAM(secure_lvl_, type_, name_, default_value_, description_)  \
-    {                                                                    \
-        .name = #name_,                                                 \
-        .description = description_,                                    \
-        .secure_level = secure_lvl_,                                    \
-        .is_array = false,                                              \
-        .element_size = sizeof(type_),                                  \
-        .element_count = 1,                                             \
-        .is_dirty = _registry_is_dirty_##name_,                         \
-        .is_default = _registry_is_default_##name_,                     \
-        .reset = _registry_reset_##name_,                               \
-        .print = _registry_print_##name_,                               \
-        .set = _registry_set_##name_,                                   \
-        .get = _registry_get_##name_,                                   \
-    },
-#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_) \
-    {                                                                          \
-        .name = #name_,                                                       \
-        .description = description_,                                          \
-        .secure_level = secure_lvl_,                                          \
-        .is_array = true,                                                     \
-        .element_size = sizeof(type_),                                        \
-        .element_count = size_,                                               \
-        .is_dirty = _registry_is_dirty_##name_,                               \
-        .is_default = _registry_is_default_##name_,                           \
-        .reset = _registry_reset_##name_,                                     \
-        .print = _registry_print_##name_,                                     \
-        .set = _registry_set_##name_,                                         \
-        .get = _registry_get_##name_,                                         \
-    },
-const NvsConfigParamEntry_t g_nvsconfig_params[] = {
-#include "param_table.inc"
-};
-#undef PARAM
-#undef ARRAY
+static inline bool _chunked(size_t idx)
+{
+    return s_chunk_spans[idx].count > 1;
+}
 
-const size_t g_nvsconfig_param_count =
-    sizeof(g_nvsconfig_params) / sizeof(g_nvsconfig_params[0]);
+/** Byte range [*@p off, *@p off + return) of chunk @p chunk of parameter @p idx. */
+static size_t _chunk_extent(size_t idx, uint32_t chunk, size_t* off)
+{
+    *off = (size_t)chunk * NVS_ARRAY_CHUNK_SIZE;
+    const size_t rest = s_slots[idx].size - *off;
+    return rest < NVS_ARRAY_CHUNK_SIZE ? rest : NVS_ARRAY_CHUNK_SIZE;
+}
 
-const NvsConfigParamEntry_t* NvsConfig_FindParam(const char* name)
+static void _chunk_key(char* key, size_t key_size, size_t idx, uint32_t chunk)
 {
-    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
-        if (strcmp(g_nvsconfig_params[i].name, name) == 0) {
-            return &g_nvsconfig_params[i];
-        }
+    uint32_t h = 2166136261u; /* FNV-1a */
+    for (const char* p = s_slots[idx].key; *p != '\0'; p++) {
+        h = (h ^ (uint8_t)*p) * 16777619u;
     }
-    return NULL;
+    snprintf(key, key_size, "_c%08" PRIx32 "%u", h, (unsigned)(uint16_t)chunk);
 }
 
-void NvsConfig_ResetAll(void)
+/**
+ * @brief Load a chunked array.
+ *
+ * An array without its first chunk is read from a whole-array blob written
+ * before chunking was enabled, and flagged in s_perkey_legacy so it is
+ * rewritten in chunks. A missing or short later chunk fails the load.
+ */
+static esp_err_t _chunked_load_value(nvs_handle_t handle, size_t idx, void* out, size_t* length)
 {
-    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
-        g_nvsconfig_params[i].reset();
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    for (uint32_t c = 0; c < s_chunk_spans[idx].count; c++) {
+        char key[16];
+        size_t off;
+        const size_t want = _chunk_extent(idx, c, &off);
+        size_t len = want;
+        _chunk_key(key, sizeof(key), idx, c);
+        esp_err_t err = nvs_get_blob(handle, key, (uint8_t*)out + off, &len);
+        if (err == ESP_ERR_NVS_NOT_FOUND && c == 0) {
+            err = nvs_get_blob(handle, slot->key, out, length);
+            _bits_assign(s_perkey_legacy, idx, err == ESP_OK);
+            return err;
+        }
+        if (err != ESP_OK || len != want) {
+            ESP_LOGW(TAG, "Chunk %" PRIu32 " of '%s' unreadable, using defaults", c, slot->key);
+            return err != ESP_OK ? err : ESP_ERR_NVS_INVALID_LENGTH;
+        }
     }
+    *length = slot->size;
+    return ESP_OK;
 }
+#endif  // NVS_CHUNKED_STORAGE
 
-void NvsConfig_PrintAll(void)
+#if !CONFIG_NVS_CONFIG_STORAGE_PACKED
+/**
+ * @brief Load a value stored under its own key or in chunks. Called from
+ *        NvsConfig_Init().
+ */
+static esp_err_t _perkey_load_value(nvs_handle_t handle, NvsConfigParamIndex_t idx, void* out, size_t* length)
 {
-    char buf[128];
-    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
-        g_nvsconfig_params[i].print(buf, sizeof(buf));
-        ESP_LOGI(TAG, "%-16s = %s", g_nvsconfig_params[i].name, buf);
+#if NVS_CHUNKED_STORAGE
+    if (_chunked(idx)) {
+        _bits_assign(s_perkey_legacy, idx, false);
+        return _chunked_load_value(handle, idx, out, length);
     }
+#endif
+    bool legacy;
+    esp_err_t err = _perkey_get_value(handle, idx, out, length, &legacy);
+    _bits_assign(s_perkey_legacy, idx, legacy);
+    return err;
 }
 
-void NvsConfig_SaveDirtyParameters(void)
+/**
+ * @brief Write one staged value. A chunked array writes only the chunks marked
+ *        in the stage, or all of them when it is dirty as a whole. A value
+ *        loaded in a legacy format has its old entry erased first: old and
+ *        new entry may differ in type under the same key, and nvs_erase_key()
+ *        removes whichever of them it finds.
+ */
+static esp_err_t _save_write_value(nvs_handle_t handle, const _NvsConfigSaveStage_t* stage, size_t idx)
 {
-    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    const _NvsConfigSlot_t* slot = &s_slots[idx];
+    const uint8_t* value = (const uint8_t*)&stage->values + slot->offset;
+#if NVS_CHUNKED_STORAGE
+    if (_chunked(idx)) {
+        const bool all = _bits_test(s_perkey_legacy, idx) || !_chunks_any(stage->chunks, idx);
+        for (uint32_t c = 0; c < s_chunk_spans[idx].count; c++) {
+            if (!all && !_bits_test(stage->chunks, s_chunk_spans[idx].first + c)) {
+                continue;
+            }
+            char key[16];
+            size_t off;
+            const size_t len = _chunk_extent(idx, c, &off);
+            _chunk_key(key, sizeof(key), idx, c);
+            esp_err_t err = nvs_set_blob(handle, key, value + off, len);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+        if (_bits_test(s_perkey_legacy, idx)) {
+            nvs_erase_key(handle, slot->key);
+            _bits_assign(s_perkey_legacy, idx, false);
+        }
+        return ESP_OK;
+    }
+#endif
+    if (_bits_test(s_perkey_legacy, idx)) {
+        nvs_erase_key(handle, slot->key);
+        _bits_assign(s_perkey_legacy, idx, false);
+    }
+    if (slot->prim == _NVS_PRIM_str) {
+        return nvs_set_str(handle, slot->key, (const char*)value);
+    }
+#if NVS_TYPED_SCALARS
+    return _typed_set(handle, idx, value);
+#else
+    return nvs_set_blob(handle, slot->key, value, slot->size);
+#endif
+}
 
+/**
+ * @brief Phase 2: write staged values to flash. Runs without s_nvs_mutex.
+ *
+ * Only values marked for writing by _save_filter_unchanged() go to flash.
+ * Values whose write fails are un-staged so they stay dirty.
+ *
+ * @return true if at least one value was written and committed.
+ */
+static bool _save_write_staged(_NvsConfigSaveStage_t* stage)
+{
     nvs_handle_t handle;
     esp_err_t err;
 
@@ -518,57 +3417,29 @@ void NvsConfig_SaveDirtyParameters(void)
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to open NVS namespace '%s' (Error: 0x%x %s)",
                  NVS_NAMESPACE, err, esp_err_to_name(err));
-        xSemaphoreGive(s_nvs_mutex);
-        return;  // Cannot proceed without NVS handle
+        return false;  // Cannot proceed without NVS handle
     }
 
     int parametersChanged = 0;
 
-#define PARAM(secure_lvl_, type_, name_, default_value_, description_)                                                           \
-    if (g_nvsconfig_controller.name_.is_dirty) {                                                                                 \
-        size_t name_##required_size = sizeof(type_);                                                                             \
-        /* Log before attempting to save */                                                                                      \
-        ESP_LOGD(TAG, "Saving PARAM '%s', key '%s', size %u",                                                                    \
-                 g_nvsconfig_controller.name_.name,                                                                              \
-                 g_nvsconfig_controller.name_.key,                                                                               \
-                 (unsigned int)name_##required_size);                                                                            \
-        err = nvs_set_blob(handle, g_nvsconfig_controller.name_.key, &g_nvsconfig_controller.name_.value, name_##required_size); \
-        if (err != ESP_OK) {                                                                                                     \
-            ESP_LOGE(TAG, "Failed to set blob for PARAM: %s (Key: %s, Error: 0x%x %s)",                                          \
-                     g_nvsconfig_controller.name_.name, g_nvsconfig_controller.name_.key, err, esp_err_to_name(err));            \
-        }                                                                                                                        \
-        else {                                                                                                                   \
-            g_nvsconfig_controller.name_.is_dirty = false;                                                                       \
-            parametersChanged++;                                                                                                 \
-            ESP_LOGD(TAG, "Successfully saved PARAM '%s'", g_nvsconfig_controller.name_.name);                                   \
-        }                                                                                                                        \
-    }
-#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_)                                                    \
-    if (g_nvsconfig_controller.name_.is_dirty) {                                                                                 \
-        size_t name_##required_size = size_ * sizeof(type_);                                                                     \
-        /* Log before attempting to save */                                                                                      \
-        ESP_LOGD(TAG, "Saving ARRAY '%s', key '%s', size %u (elements %u, element_size %u)",                                     \
-                 g_nvsconfig_controller.name_.name,                                                                              \
-                 g_nvsconfig_controller.name_.key,                                                                               \
-                 (unsigned int)name_##required_size,                                                                             \
-                 (unsigned int)size_,                                                                                            \
-                 (unsigned int)sizeof(type_));                                                                                   \
-        err = nvs_set_blob(handle, g_nvsconfig_controller.name_.key, &g_nvsconfig_controller.name_.value, name_##required_size); \
-        if (err != ESP_OK) {                                                                                                     \
-            ESP_LOGE(TAG, "Failed to set blob for ARRAY: %s (Key: %s, Error: 0x%x %s)",                                          \
-                     g_nvsconfig_controller.name_.name, g_nvsconfig_controller.name_.key, err, esp_err_to_name(err));            \
-        }                                                                                                                        \
-        else {                                                                                                                   \
-            g_nvsconfig_controller.name_.is_dirty = false;                                                                       \
-            parametersChanged++;                                                                                                 \
-            ESP_LOGD(TAG, "Successfully saved ARRAY '%s'", g_nvsconfig_controller.name_.name);                                   \
-        }                                                                                                                        \
+    NVS_BITS_FOREACH(stage->write, i) {
+        const _NvsConfigSlot_t* slot = &s_slots[i];
+        /* Log before attempting to save */
+        ESP_LOGD(TAG, "Saving '%s', size %u", slot->key, (unsigned int)slot->size);
+        err = _save_write_value(handle, stage, i);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to set blob for %s (Error: 0x%x %s)", slot->key, err, esp_err_to_name(err));
+            _bits_assign(stage->staged, i, false);
+            _bits_assign(stage->write, i, false);
+        }
+        else {
+            parametersChanged++;
+            ESP_LOGD(TAG, "Successfully saved '%s'", slot->key);
+        }
     }
-#include "param_table.inc"
-#undef PARAM
-#undef ARRAY
 
     // Commit changes if any parameters were successfully saved
+    bool committed = false;
     if (parametersChanged > 0) {
         char buf[128];
         int len = snprintf(buf, sizeof(buf), "%d dirty parameters committing to flash...", parametersChanged);
@@ -581,24 +3452,141 @@ void NvsConfig_SaveDirtyParameters(void)
         else {
             len += snprintf(buf + len, sizeof(buf) - len, " Done");
             ESP_LOGI(TAG, "%s", buf);
+            committed = true;
         }
     }
     nvs_close(handle);
+    return committed;
+}
+#endif  // !CONFIG_NVS_CONFIG_STORAGE_PACKED
+
+/**
+ * @brief Phase 3: clear the dirty bit of staged values that were not written
+ *        again while the flash I/O ran. Caller holds s_nvs_mutex.
+ */
+static void _save_clear_dirty(const _NvsConfigSaveStage_t* stage)
+{
+    NVS_BITS_FOREACH(stage->staged, i) {
+        if (stage->gen[i] == s_param_gen[i]) {
+            _bits_assign(s_dirty_bits, i, false);
+            _chunks_assign(s_dirty_chunks, i, 0, s_slots[i].size, false);
+        }
+    }
+}
+
+/**
+ * @brief Rebuild the scheduling state from the dirty flags. Caller holds
+ *        s_nvs_mutex.
+ *
+ * Called after a save (successful or not) and after loading, so that
+ * parameters still dirty re-arm the save task with a fresh quiet period.
+ *
+ * @param failed The save left values dirty because a write or the commit
+ *               failed; the next attempt waits for the quiet period even if
+ *               the dirty-byte threshold is exceeded.
+ */
+static void _save_recount_dirty(bool failed)
+{
+    size_t bytes = 0;
+    NVS_BITS_FOREACH(s_dirty_bits, i) {
+        const uint16_t* length = _string_length(i);
+        bytes += length != NULL ? *length + 1u : s_slots[i].size;
+    }
+
+    const TickType_t now = xTaskGetTickCount();
+    s_dirty_bytes = bytes;
+    s_save_armed = bytes > 0;
+    s_save_backoff = failed && bytes > 0;
+    s_first_dirty_tick = now;
+    s_last_dirty_tick = now;
+}
+
+void NvsConfig_SaveDirtyParameters(void)
+{
+    _NvsConfigSaveStage_t* stage = &s_save_stage;
+
+    xSemaphoreTake(s_save_mutex, portMAX_DELAY);
+    memset(stage, 0, sizeof(*stage));
+
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    int staged = _save_stage_dirty(stage);
+    xSemaphoreGive(s_nvs_mutex);
+
+    bool committed = staged > 0;
+    if (committed && _save_filter_unchanged(stage) > 0) {
+#if CONFIG_NVS_CONFIG_STORAGE_PACKED
+        committed = _save_write_packed(stage);
+#else
+        committed = _save_write_staged(stage);
+#endif
+        if (committed) {
+            _save_record_persisted(stage);
+        }
+    }
+
+    /* Failed writes were un-staged; a failed commit leaves everything dirty */
+    int kept = 0;
+    NVS_BITS_FOREACH(stage->staged, i) {
+        kept++;
+    }
+    const bool failed = staged > 0 && (!committed || kept < staged);
+
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    if (committed) {
+        _save_clear_dirty(stage);
+    }
+    _save_recount_dirty(failed);
     xSemaphoreGive(s_nvs_mutex);
+
+    xSemaphoreGive(s_save_mutex);
 }
 
-#if defined(ESP_IDF_VERSION_MAJOR) && (ESP_IDF_VERSION_MAJOR >= 5)
-static void save_dirty_parameters_callback(void *arg)
+/**
+ * @brief Ticks the save task should sleep before the next flush, or
+ *        portMAX_DELAY if nothing is dirty. Returns 0 when a flush is due.
+ */
+static TickType_t _save_wait_ticks(void)
 {
-    (void) arg;
-    NvsConfig_SaveDirtyParameters();
+    TickType_t wait = portMAX_DELAY;
+
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    if (s_save_armed) {
+        const TickType_t now = xTaskGetTickCount();
+        const TickType_t quiet = now - s_last_dirty_tick;
+        const TickType_t age = now - s_first_dirty_tick;
+
+        if ((CONFIG_NVS_CONFIG_SAVE_DIRTY_BYTES > 0 && !s_save_backoff &&
+             s_dirty_bytes >= CONFIG_NVS_CONFIG_SAVE_DIRTY_BYTES) ||
+            quiet >= NVS_SAVE_QUIET_TICKS || age >= NVS_SAVE_MAX_LATENCY_TICKS) {
+            wait = 0;
+        }
+        else {
+            const TickType_t to_quiet = NVS_SAVE_QUIET_TICKS - quiet;
+            const TickType_t to_latency = NVS_SAVE_MAX_LATENCY_TICKS - age;
+            wait = to_quiet < to_latency ? to_quiet : to_latency;
+        }
+    }
+    xSemaphoreGive(s_nvs_mutex);
+    return wait;
 }
-#else 
-static void save_dirty_parameters_callback(TimerHandle_t xTimer)
+
+static void _save_task(void *arg)
 {
-    NvsConfig_SaveDirtyParameters();
+    (void) arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        TickType_t wait;
+        while ((wait = _save_wait_ticks()) != portMAX_DELAY) {
+            if (wait == 0) {
+                NvsConfig_SaveDirtyParameters();
+            }
+            else {
+                ulTaskNotifyTake(pdTRUE, wait);
+            }
+        }
+    }
 }
-#endif // defined(ESP_IDF_VERSION_MAJOR) && (ESP_IDF_VERSION_MAJOR >= 5)
 
 esp_err_t NvsConfig_Init(void)
 {
@@ -610,6 +3598,13 @@ esp_err_t NvsConfig_Init(void)
             return ESP_FAIL;
         }
     }
+    if (s_save_mutex == NULL) {
+        s_save_mutex = xSemaphoreCreateMutex();
+        if (s_save_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create NVS config save mutex");
+            return ESP_FAIL;
+        }
+    }
 
     // NVS initialization
     esp_err_t ret = nvs_flash_init();
@@ -654,82 +3649,78 @@ esp_err_t NvsConfig_Init(void)
 
         (void)version_mismatch;
 
-#define PARAM(secure_lvl_, type_, name_, default_value_, description_)                                                                   \
-    size_t name_##_required_size = sizeof(g_nvsconfig_controller.name_.value);                                                           \
-    if (nvs_get_blob(handle, g_nvsconfig_controller.name_.key, &g_nvsconfig_controller.name_.value, &name_##_required_size) != ESP_OK) { \
-        g_nvsconfig_controller.name_.value = g_nvsconfig_controller.name_.default_value;                                                 \
-        g_nvsconfig_controller.name_.is_default = true;                                                                                  \
-        g_nvsconfig_controller.name_.is_dirty = true;                                                                                    \
-    }                                                                                                                                    \
-    else {                                                                                                                               \
-        g_nvsconfig_controller.name_.is_dirty = false;                                                                                   \
-        if (g_nvsconfig_controller.name_.value != g_nvsconfig_controller.name_.default_value) {                                          \
-            g_nvsconfig_controller.name_.is_default = false;                                                                             \
-        }                                                                                                                                \
-        else {                                                                                                                           \
-            g_nvsconfig_controller.name_.is_default = true;                                                                              \
-        }                                                                                                                                \
-    }
-#define ARRAY(secure_lvl_, type_, size_, name_, default_value_, description_)                                                                 \
-    size_t name_##_required_size = sizeof(g_nvsconfig_controller.name_.value);                                                                \
-    if (nvs_get_blob(handle, g_nvsconfig_controller.name_.key, &g_nvsconfig_controller.name_.value, &name_##_required_size) != ESP_OK) {      \
-        memcpy(&g_nvsconfig_controller.name_.value, &g_nvsconfig_controller.name_.default_value, sizeof(g_nvsconfig_controller.name_.value)); \
-        g_nvsconfig_controller.name_.is_dirty = true;                                                                                         \
-        g_nvsconfig_controller.name_.is_default = true;                                                                                       \
-    }                                                                                                                                         \
-    else {                                                                                                                                    \
-        g_nvsconfig_controller.name_.is_dirty = false;                                                                                        \
-        if (memcmp(&g_nvsconfig_controller.name_.value, &g_nvsconfig_controller.name_.default_value, size_ * sizeof(type_)) != 0) {           \
-            g_nvsconfig_controller.name_.is_default = false;                                                                                  \
-        }                                                                                                                                     \
-        else {                                                                                                                                \
-            g_nvsconfig_controller.name_.is_default = true;                                                                                   \
-        }                                                                                                                                     \
-    }
+        for (size_t w = 0; w < NVS_CHUNK_BITSET_WORDS; w++) {
+            atomic_store_explicit(&s_dirty_chunks[w], 0, memory_order_relaxed);
+        }
 
-#include "param_table.inc"
-#undef PARAM
-#undef ARRAY
+#if CONFIG_NVS_CONFIG_STORAGE_PACKED
+        _NvsPackedLoad_t packed;
+        _packed_load_begin(&packed, handle);
+#endif
 
-        nvs_close(handle);
-    }
+        /* One loop over s_slots, so Init does not grow with the table either */
+        for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
+            const _NvsConfigSlot_t* slot = &s_slots[i];
+            size_t length = slot->size;
+#if CONFIG_NVS_CONFIG_STORAGE_PACKED
+            const esp_err_t err = _packed_load_value(&packed, (NvsConfigParamIndex_t)i, slot->value, &length);
+            const bool resave = packed.resave;
+#else
+            const esp_err_t err = _perkey_load_value(handle, (NvsConfigParamIndex_t)i, slot->value, &length);
+            const bool resave = _bits_test(s_perkey_legacy, i);
+#endif
+            if (err != ESP_OK) {
+                memcpy(slot->value, slot->default_value, slot->size);
+            }
+            _bits_assign(s_dirty_bits, i, err != ESP_OK || resave);
+            uint16_t* string_length = _string_length(i);
+            if (string_length) {
+                *string_length = (uint16_t)_string_fix(slot->value, slot->size);
+            }
+            _bits_assign(s_nondefault_bits, i, memcmp(slot->value, slot->default_value, slot->size) != 0);
+        }
 
-    #if defined(ESP_IDF_VERSION_MAJOR) && (ESP_IDF_VERSION_MAJOR >= 5)
-    // Using esp_timer in ESP-IDF v5 and later
-    const esp_timer_create_args_t periodic_timer_args = {
-        .callback = &save_dirty_parameters_callback,
-        .arg = NULL,
-        .dispatch_method = ESP_TIMER_TASK,
-        .name = "g_param_save"
-    };
-    esp_timer_handle_t periodic_timer;
-    esp_err_t err = esp_timer_create(&periodic_timer_args, &periodic_timer);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create periodic timer");
-        return ESP_FAIL;
+#if CONFIG_NVS_CONFIG_STORAGE_PACKED
+        _packed_load_end(&packed);
+#endif
+
+        /* Whatever loaded cleanly (and needs no re-save) is what flash holds */
+        for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
+            const bool on_flash = !_bits_test(s_dirty_bits, i);
+            _bits_assign(s_persisted_known, i, on_flash);
+            if (on_flash) {
+                s_persisted_digest[i] = _persist_digest(s_slots[i].value, s_slots[i].size);
+            }
+        }
+
+        nvs_close(handle);
     }
-    err = esp_timer_start_periodic(periodic_timer, 30000 * 1000); // period in microseconds (30 seconds)
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start periodic timer");
-        return err;
+    else {
+        memset(s_persisted_known, 0, sizeof(s_persisted_known));
     }
-    #else
-    // Using FreeRTOS timers for earlier ESP-IDF versions
-    TimerHandle_t xTimer = xTimerCreate(
-        "g_param_save",
-        pdMS_TO_TICKS(30000),  // Timer period in ticks (30 seconds)
-        pdTRUE,
-        (void*)0,
-        save_dirty_parameters_callback);
 
-    if (xTimer != NULL) {
-        xTimerStart(xTimer, 0);
+    _phf_ensure();
+
+    xSemaphoreTake(s_nvs_mutex, portMAX_DELAY);
+    _save_recount_dirty(false);
+    bool armed = s_save_armed;
+    xSemaphoreGive(s_nvs_mutex);
+
+    if (s_save_task == NULL) {
+        BaseType_t created = xTaskCreatePinnedToCore(_save_task, "nvs_cfg_save",
+                                                     CONFIG_NVS_CONFIG_SAVE_TASK_STACK_SIZE, NULL,
+                                                     CONFIG_NVS_CONFIG_SAVE_TASK_PRIORITY, &s_save_task,
+                                                     CONFIG_NVS_CONFIG_SAVE_TASK_CORE < 0 ? tskNO_AFFINITY
+                                                                                          : CONFIG_NVS_CONFIG_SAVE_TASK_CORE);
+        if (created != pdPASS) {
+            s_save_task = NULL;
+            ESP_LOGE(TAG, "Failed to create save task");
+            return ESP_FAIL;
+        }
     }
-    else {
-        ESP_LOGE(TAG, "Failed to create periodic timer");
-        return ESP_FAIL;
+    if (armed) {
+        _save_notify();
     }
-    #endif // defined(ESP_IDF_VERSION_MAJOR) && (ESP_IDF_VERSION_MAJOR >= 5)
-    
+
     return ESP_OK;
 }
\ No newline at end of file
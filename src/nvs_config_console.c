@@ -10,6 +10,9 @@
 #include "nvs_config_console.h"
 #include "nvs_config.h"
 
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -20,6 +23,12 @@
 
 static const char *TAG = "NVS_CONSOLE";
 
+/* The *ByIndex calls work whether or not entries carry function pointers */
+static inline NvsConfigParamIndex_t _console_index(const NvsConfigParamEntry_t *e)
+{
+    return (NvsConfigParamIndex_t)(e - g_nvsconfig_params);
+}
+
 /* ── param list ── */
 
 static int cmd_param_list(int argc, char **argv)
@@ -33,13 +42,14 @@ static int cmd_param_list(int argc, char **argv)
 
     for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
         const NvsConfigParamEntry_t *e = &g_nvsconfig_params[i];
-        e->print(buf, sizeof(buf));
+        const NvsConfigParamIndex_t idx = (NvsConfigParamIndex_t)i;
+        NvsConfig_PrintByIndex(idx, buf, sizeof(buf));
         printf("%-16s %-6u %-5s %-5s %-7s  %s\n",
                e->name,
                e->secure_level,
-               e->is_dirty()   ? "yes" : "no",
-               e->is_default() ? "yes" : "no",
-               e->is_array     ? "array" : "scalar",
+               NvsConfig_IsDirtyByIndex(idx)   ? "yes" : "no",
+               NvsConfig_IsDefaultByIndex(idx) ? "yes" : "no",
+               e->is_string    ? "string" : e->is_array ? "array" : "scalar",
                buf);
     }
     return 0;
@@ -67,7 +77,7 @@ static int cmd_param_get(int argc, char **argv)
     }
 
     char buf[128];
-    e->print(buf, sizeof(buf));
+    NvsConfig_PrintByIndex(_console_index(e), buf, sizeof(buf));
     printf("%s = %s\n", e->name, buf);
     return 0;
 }
@@ -75,50 +85,89 @@ static int cmd_param_get(int argc, char **argv)
 /* ── param set <name> <value> ── */
 
 /**
- * Parse a string value into a buffer based on element size.
- * Supports scalars only (console limitation).
+ * Parse a string value into a buffer for a scalar of type @p type.
+ * The whole string must be consumed. A char takes a one-character literal
+ * or a number; a bool takes true/false or a number.
  */
-static esp_err_t _console_parse_scalar(const char* str, void* out, size_t elem_size)
+static esp_err_t _console_parse_scalar(const char* str, void* out, NvsConfigType_t type)
 {
-    switch (elem_size) {
-    case 1: {
-        /* Could be char, bool, int8_t, or uint8_t */
-        long v = strtol(str, NULL, 0);
-        uint8_t byte = (uint8_t)v;
-        /* If input is a single non-digit char, treat as char literal */
-        if (str[0] != '\0' && str[1] == '\0' && (str[0] < '0' || str[0] > '9') && str[0] != '-') {
-            byte = (uint8_t)str[0];
+    char *end = NULL;
+    switch (type) {
+    case NVS_CONFIG_TYPE_char:
+        if (str[0] != '\0' && str[1] == '\0') {
+            memcpy(out, str, 1);
+            return ESP_OK;
         }
-        memcpy(out, &byte, 1);
-        return ESP_OK;
-    }
-    case 2: { uint16_t v = (uint16_t)strtoul(str, NULL, 0); memcpy(out, &v, 2); return ESP_OK; }
-    case 4: {
-        /* Could be int32_t, uint32_t, or float */
-        char *end;
-        /* Try as integer first; if string contains '.', parse as float */
-        if (strchr(str, '.') != NULL) {
-            float f = strtof(str, NULL);
-            memcpy(out, &f, 4);
-        } else {
-            uint32_t v = (uint32_t)strtoul(str, &end, 0);
-            memcpy(out, &v, 4);
+        {
+            errno = 0;
+            long v = strtol(str, &end, 0);
+            if (errno == ERANGE || v < CHAR_MIN || v > CHAR_MAX) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            char c = (char)v;
+            memcpy(out, &c, 1);
         }
-        return ESP_OK;
-    }
-    case 8: {
-        if (strchr(str, '.') != NULL) {
-            double d = strtod(str, NULL);
-            memcpy(out, &d, 8);
+        break;
+    case NVS_CONFIG_TYPE_bool: {
+        bool b;
+        if (strcmp(str, "true") == 0) {
+            b = true;
+        } else if (strcmp(str, "false") == 0) {
+            b = false;
         } else {
-            uint64_t v = (uint64_t)strtoull(str, NULL, 0);
-            memcpy(out, &v, 8);
+            b = strtol(str, &end, 0) != 0;
+            if (end == str || *end != '\0') return ESP_ERR_INVALID_ARG;
         }
+        memcpy(out, &b, sizeof(b));
         return ESP_OK;
     }
+/* Out-of-range values and '-' on unsigned types are rejected, not wrapped */
+#define _CONSOLE_PARSE(type_, min_, max_)                                  \
+    case NVS_CONFIG_TYPE_##type_: {                                        \
+        errno = 0;                                                         \
+        long long v = strtoll(str, &end, 0);                               \
+        if (errno == ERANGE || v < (min_) || v > (max_)) {                 \
+            return ESP_ERR_INVALID_ARG;                                    \
+        }                                                                  \
+        type_ t = (type_)v;                                                \
+        memcpy(out, &t, sizeof(t));                                        \
+        break;                                                             \
+    }
+#define _CONSOLE_PARSE_U(type_, max_)                                      \
+    case NVS_CONFIG_TYPE_##type_: {                                        \
+        errno = 0;                                                         \
+        unsigned long long v = strtoull(str, &end, 0);                     \
+        if (errno == ERANGE || v > (max_) || strchr(str, '-') != NULL) {   \
+            return ESP_ERR_INVALID_ARG;                                    \
+        }                                                                  \
+        type_ t = (type_)v;                                                \
+        memcpy(out, &t, sizeof(t));                                        \
+        break;                                                             \
+    }
+    _CONSOLE_PARSE(int8_t, INT8_MIN, INT8_MAX)
+    _CONSOLE_PARSE_U(uint8_t, UINT8_MAX)
+    _CONSOLE_PARSE(int16_t, INT16_MIN, INT16_MAX)
+    _CONSOLE_PARSE_U(uint16_t, UINT16_MAX)
+    _CONSOLE_PARSE(int32_t, INT32_MIN, INT32_MAX)
+    _CONSOLE_PARSE_U(uint32_t, UINT32_MAX)
+    _CONSOLE_PARSE(int64_t, INT64_MIN, INT64_MAX)
+    _CONSOLE_PARSE_U(uint64_t, UINT64_MAX)
+#undef _CONSOLE_PARSE_U
+#undef _CONSOLE_PARSE
+    case NVS_CONFIG_TYPE_float: {
+        float f = strtof(str, &end);
+        memcpy(out, &f, sizeof(f));
+        break;
+    }
+    case NVS_CONFIG_TYPE_double: {
+        double d = strtod(str, &end);
+        memcpy(out, &d, sizeof(d));
+        break;
+    }
     default:
         return ESP_ERR_NOT_SUPPORTED;
     }
+    return (end != str && *end == '\0') ? ESP_OK : ESP_ERR_INVALID_ARG;
 }
 
 static struct {
@@ -146,17 +195,22 @@ static int cmd_param_set(int argc, char **argv)
         return 1;
     }
 
-    uint8_t val_buf[8]; /* largest scalar is 8 bytes (double/int64) */
-    esp_err_t parse_rc = _console_parse_scalar(s_set_args.value->sval[0], val_buf, e->element_size);
-    if (parse_rc != ESP_OK) {
-        printf("Failed to parse value for '%s'\n", e->name);
-        return 1;
+    esp_err_t rc;
+    if (e->is_string) {
+        const char *str = s_set_args.value->sval[0];
+        rc = NvsConfig_SetByIndex(_console_index(e), str, strlen(str));
+    } else {
+        uint8_t val_buf[8]; /* largest scalar is 8 bytes (double/int64) */
+        esp_err_t parse_rc = _console_parse_scalar(s_set_args.value->sval[0], val_buf, e->type);
+        if (parse_rc != ESP_OK) {
+            printf("Failed to parse value for '%s'\n", e->name);
+            return 1;
+        }
+        rc = NvsConfig_SetByIndex(_console_index(e), val_buf, e->element_size);
     }
-
-    esp_err_t rc = e->set(val_buf, e->element_size);
     if (rc == ESP_OK) {
         char buf[128];
-        e->print(buf, sizeof(buf));
+        NvsConfig_PrintByIndex(_console_index(e), buf, sizeof(buf));
         printf("%s = %s\n", e->name, buf);
     } else {
         printf("Failed to set '%s': %s (0x%x)\n", e->name, esp_err_to_name(rc), rc);
@@ -193,10 +247,10 @@ static int cmd_param_reset(int argc, char **argv)
         return 1;
     }
 
-    esp_err_t rc = e->reset();
+    esp_err_t rc = NvsConfig_ResetByIndex(_console_index(e));
     if (rc == ESP_OK) {
         char buf[128];
-        e->print(buf, sizeof(buf));
+        NvsConfig_PrintByIndex(_console_index(e), buf, sizeof(buf));
         printf("%s reset to %s\n", e->name, buf);
     } else {
         printf("%s already at default\n", e->name);
@@ -0,0 +1,692 @@
+/**
+ * @file nvs_format.c
+ * @author Hossein Molavi (hmolavi@uwaterloo.ca)
+ *
+ * @brief Number formatting for the print functions
+ *
+ * See nvs_format.h. float uses Ryu (Adams, "Ryu: Fast Float-to-String
+ * Conversion", PLDI 2018), which finds the shortest digits exactly with
+ * 32 x 64-bit multiplies and two small tables. The same method for double
+ * needs 128-bit products and 10 KB of tables, so double uses Grisu2
+ * (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with
+ * Integers", PLDI 2010): the value and the boundaries of its rounding
+ * interval are scaled by a cached power of ten into a 64-bit fixed-point
+ * window, and digits are generated until the remaining error fits inside the
+ * interval. Its output always reads back to the same value, but for about
+ * 0.1% of values it is longer than the shortest such string.
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#include "nvs_format.h"
+
+#include <string.h>
+
+/** "00" to "99", two characters per value. */
+static const char s_digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/** Copies the @p len characters at @p s into @p buf like snprintf(). */
+static int _format_out(const char* s, int len, char* buf, size_t buf_size)
+{
+    if (buf_size > 0) {
+        size_t n = (size_t)len < buf_size ? (size_t)len : buf_size - 1;
+        memcpy(buf, s, n);
+        buf[n] = '\0';
+    }
+    return len;
+}
+
+/**
+ * Writes @p value with @p writer_ straight into @p buf when it has room for
+ * any output, or through a stack copy that _format_out() truncates.
+ */
+#define _FORMAT_VIA(writer_, value_)                                      \
+    do {                                                                  \
+        if (buf_size > NVS_FORMAT_MAX_LEN) {                              \
+            int _n = writer_(value_, buf);                                \
+            buf[_n] = '\0';                                               \
+            return _n;                                                    \
+        }                                                                 \
+        char _tmp[NVS_FORMAT_MAX_LEN];                                    \
+        return _format_out(_tmp, writer_(value_, _tmp), buf, buf_size);   \
+    } while (0)
+
+/* ── Integers ────────────────────────────────────────────────────────── */
+
+/** Decimal digits of @p v at @p out, two per division; returns the count. */
+static int _write_u32(uint32_t v, char* out)
+{
+    char tmp[10];
+    char* p = tmp + sizeof(tmp);
+    while (v >= 100) {
+        uint32_t q = v / 100;
+        p -= 2;
+        memcpy(p, &s_digit_pairs[(v - q * 100) * 2], 2);
+        v = q;
+    }
+    if (v >= 10) {
+        p -= 2;
+        memcpy(p, &s_digit_pairs[v * 2], 2);
+    } else {
+        *--p = (char)('0' + v);
+    }
+    int n = (int)(tmp + sizeof(tmp) - p);
+    memcpy(out, p, (size_t)n);
+    return n;
+}
+
+/**
+ * 64-bit values split off nine digits per 64-bit division and write the
+ * parts with 32-bit arithmetic, which the target does in hardware.
+ */
+static int _write_u64(uint64_t v, char* out)
+{
+    if (v <= UINT32_MAX) {
+        return _write_u32((uint32_t)v, out);
+    }
+    uint64_t hi = v / 1000000000u;
+    uint32_t lo = (uint32_t)(v - hi * 1000000000u);
+    int n = _write_u64(hi, out);
+    for (int i = 8; i >= 0; i--) {
+        out[n + i] = (char)('0' + lo % 10);
+        lo /= 10;
+    }
+    return n + 9;
+}
+
+static int _write_i32(int32_t v, char* out)
+{
+    if (v < 0) {
+        out[0] = '-';
+        return 1 + _write_u32(0u - (uint32_t)v, out + 1);
+    }
+    return _write_u32((uint32_t)v, out);
+}
+
+static int _write_i64(int64_t v, char* out)
+{
+    if (v < 0) {
+        out[0] = '-';
+        return 1 + _write_u64(0u - (uint64_t)v, out + 1);
+    }
+    return _write_u64((uint64_t)v, out);
+}
+
+int _nvsconfig_format_char(char value, char* buf, size_t buf_size)
+{
+    return _format_out(&value, 1, buf, buf_size);
+}
+
+int _nvsconfig_format_bool(bool value, char* buf, size_t buf_size)
+{
+    return _format_out(value ? "1" : "0", 1, buf, buf_size);
+}
+
+int _nvsconfig_format_u32(uint32_t value, char* buf, size_t buf_size)
+{
+    _FORMAT_VIA(_write_u32, value);
+}
+
+int _nvsconfig_format_i32(int32_t value, char* buf, size_t buf_size)
+{
+    _FORMAT_VIA(_write_i32, value);
+}
+
+int _nvsconfig_format_u64(uint64_t value, char* buf, size_t buf_size)
+{
+    _FORMAT_VIA(_write_u64, value);
+}
+
+int _nvsconfig_format_i64(int64_t value, char* buf, size_t buf_size)
+{
+    _FORMAT_VIA(_write_i64, value);
+}
+
+/* ── float (Ryu) ─────────────────────────────────────────────────────── */
+
+#define _RYU_POW5_INV_BITCOUNT  59
+#define _RYU_POW5_BITCOUNT      61
+
+/** ceil(2^(bits(5^i) - 1 + 59) / 5^i) for i = 0..30. */
+static const uint64_t s_ryu_pow5_inv[31] = {
+    0x0800000000000001ULL, 0x0666666666666667ULL, 0x051EB851EB851EB9ULL,
+    0x04189374BC6A7EFAULL, 0x068DB8BAC710CB2AULL, 0x053E2D6238DA3C22ULL,
+    0x0431BDE82D7B634EULL, 0x06B5FCA6AF2BD216ULL, 0x055E63B88C230E78ULL,
+    0x044B82FA09B5A52DULL, 0x06DF37F675EF6EAEULL, 0x057F5FF85E592558ULL,
+    0x0465E6604B7A8447ULL, 0x0709709A125DA071ULL, 0x05A126E1A84AE6C1ULL,
+    0x0480EBE7B9D58567ULL, 0x0734ACA5F6226F0BULL, 0x05C3BD5191B525A3ULL,
+    0x049C97747490EAE9ULL, 0x0760F253EDB4AB0EULL, 0x05E72843249088D8ULL,
+    0x04B8ED0283A6D3E0ULL, 0x078E480405D7B966ULL, 0x060B6CD004AC9452ULL,
+    0x04D5F0A66A23A9DBULL, 0x07BCB43D769F762BULL, 0x063090312BB2C4EFULL,
+    0x04F3A68DBC8F03F3ULL, 0x07EC3DAF94180651ULL, 0x065697BFA9ACD1DAULL,
+    0x051212FFBAF0A7E2ULL,
+};
+
+/** 5^i scaled to 61 bits, for i = 0..46. */
+static const uint64_t s_ryu_pow5[47] = {
+    0x1000000000000000ULL, 0x1400000000000000ULL, 0x1900000000000000ULL,
+    0x1F40000000000000ULL, 0x1388000000000000ULL, 0x186A000000000000ULL,
+    0x1E84800000000000ULL, 0x1312D00000000000ULL, 0x17D7840000000000ULL,
+    0x1DCD650000000000ULL, 0x12A05F2000000000ULL, 0x174876E800000000ULL,
+    0x1D1A94A200000000ULL, 0x12309CE540000000ULL, 0x16BCC41E90000000ULL,
+    0x1C6BF52634000000ULL, 0x11C37937E0800000ULL, 0x16345785D8A00000ULL,
+    0x1BC16D674EC80000ULL, 0x1158E460913D0000ULL, 0x15AF1D78B58C4000ULL,
+    0x1B1AE4D6E2EF5000ULL, 0x10F0CF064DD59200ULL, 0x152D02C7E14AF680ULL,
+    0x1A784379D99DB420ULL, 0x108B2A2C28029094ULL, 0x14ADF4B7320334B9ULL,
+    0x19D971E4FE8401E7ULL, 0x1027E72F1F128130ULL, 0x1431E0FAE6D7217CULL,
+    0x193E5939A08CE9DBULL, 0x1F8DEF8808B02452ULL, 0x13B8B5B5056E16B3ULL,
+    0x18A6E32246C99C60ULL, 0x1ED09BEAD87C0378ULL, 0x13426172C74D822BULL,
+    0x1812F9CF7920E2B6ULL, 0x1E17B84357691B64ULL, 0x12CED32A16A1B11EULL,
+    0x178287F49C4A1D66ULL, 0x1D6329F1C35CA4BFULL, 0x125DFA371A19E6F7ULL,
+    0x16F578C4E0A060B5ULL, 0x1CB2D6F618C878E3ULL, 0x11EFC659CF7D4B8DULL,
+    0x166BB7F0435C9E71ULL, 0x1C06A5EC5433C60DULL,
+};
+
+/** Bits of 5^e, e > 0. */
+static inline int _pow5_bits(int e)
+{
+    return (int)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+/** floor(e * log10(2)) and floor(e * log10(5)), e >= 0. */
+static inline int _log10_pow2(int e)
+{
+    return (int)(((uint32_t)e * 78913) >> 18);
+}
+
+static inline int _log10_pow5(int e)
+{
+    return (int)(((uint32_t)e * 732923) >> 20);
+}
+
+static inline bool _multiple_of_pow5(uint32_t v, int p)
+{
+    int count = 0;
+    while (v % 5 == 0) {
+        v /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+static inline bool _multiple_of_pow2(uint32_t v, int p)
+{
+    return (v & ((1u << p) - 1)) == 0;
+}
+
+/** (m * factor) >> shift, shift > 32, from two 32 x 32-bit products. */
+static inline uint32_t _mul_shift32(uint32_t m, uint64_t factor, int shift)
+{
+    const uint64_t lo = (uint64_t)m * (uint32_t)factor;
+    const uint64_t hi = (uint64_t)m * (uint32_t)(factor >> 32);
+    return (uint32_t)(((lo >> 32) + hi) >> (shift - 32));
+}
+
+/**
+ * Shortest digits of the finite, nonzero float with fields @p frac and
+ * @p biased_e: the value is *out * 10^(*exp10), and of all such numbers in
+ * the rounding interval it has the fewest digits and is closest to the float.
+ */
+static void _ryu_float(uint32_t frac, int biased_e, uint32_t* out, int* exp10)
+{
+    int e2;
+    uint32_t m2;
+    if (biased_e == 0) {
+        e2 = 1 - 127 - 23 - 2;
+        m2 = frac;
+    } else {
+        e2 = biased_e - 127 - 23 - 2;
+        m2 = (1u << 23) | frac;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    /* The value and its interval as 4 * m2 * 2^e2, exact in 32 bits */
+    const uint32_t mv = 4 * m2;
+    const uint32_t mp = 4 * m2 + 2;
+    const uint32_t mm_shift = frac != 0 || biased_e <= 1;
+    const uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+    /* Scale by 10^-e10 with the tables, noting where the cut-off digits are all zero */
+    uint32_t vr, vp, vm;
+    int e10;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+    uint32_t last_removed = 0;
+    if (e2 >= 0) {
+        const int q = _log10_pow2(e2);
+        e10 = q;
+        const int k = _RYU_POW5_INV_BITCOUNT + _pow5_bits(q) - 1;
+        const int i = -e2 + q + k;
+        vr = _mul_shift32(mv, s_ryu_pow5_inv[q], i);
+        vp = _mul_shift32(mp, s_ryu_pow5_inv[q], i);
+        vm = _mul_shift32(mm, s_ryu_pow5_inv[q], i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            const int l = _RYU_POW5_INV_BITCOUNT + _pow5_bits(q - 1) - 1;
+            last_removed = _mul_shift32(mv, s_ryu_pow5_inv[q - 1], -e2 + q - 1 + l) % 10;
+        }
+        if (q <= 9) {
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = _multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = _multiple_of_pow5(mm, q);
+            } else {
+                vp -= _multiple_of_pow5(mp, q);
+            }
+        }
+    } else {
+        const int q = _log10_pow5(-e2);
+        e10 = q + e2;
+        const int i = -e2 - q;
+        const int k = _pow5_bits(i) - _RYU_POW5_BITCOUNT;
+        int j = q - k;
+        vr = _mul_shift32(mv, s_ryu_pow5[i], j);
+        vp = _mul_shift32(mp, s_ryu_pow5[i], j);
+        vm = _mul_shift32(mm, s_ryu_pow5[i], j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = q - 1 - (_pow5_bits(i + 1) - _RYU_POW5_BITCOUNT);
+            last_removed = _mul_shift32(mv, s_ryu_pow5[i + 1], j) % 10;
+        }
+        if (q <= 1) {
+            vr_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 31) {
+            vr_trailing_zeros = _multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    /* Drop digits while the interval still holds a shorter number */
+    int removed = 0;
+    uint32_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) {
+            /* Exactly halfway: round to even */
+            last_removed = 4;
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    } else {
+        while (vp / 10 > vm / 10) {
+            last_removed = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || last_removed >= 5);
+    }
+    *out = output;
+    *exp10 = e10 + removed;
+}
+
+/* ── double (Grisu2) ─────────────────────────────────────────────────── */
+
+/** f * 2^e with a 64-bit significand. */
+typedef struct {
+    uint64_t f;
+    int e;
+} _DiyFp_t;
+
+/** 10^k as f * 2^e, f normalized. */
+typedef struct {
+    uint64_t f;
+    int16_t e;
+    int16_t k;
+} _CachedPower_t;
+
+/** 10^k for k = -300, -292, ..., 324, rounded to nearest. */
+static const _CachedPower_t s_cached_powers[] = {
+    { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+    { 0xBE5691EF416BD60CULL, -1007, -284 },
+    { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+    { 0xD3515C2831559A83ULL,  -954, -268 },
+    { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+    { 0xEA9C227723EE8BCBULL,  -901, -252 },
+    { 0xAECC49914078536DULL,  -874, -244 },
+    { 0x823C12795DB6CE57ULL,  -847, -236 },
+    { 0xC21094364DFB5637ULL,  -821, -228 },
+    { 0x9096EA6F3848984FULL,  -794, -220 },
+    { 0xD77485CB25823AC7ULL,  -768, -212 },
+    { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+    { 0xEF340A98172AACE5ULL,  -715, -196 },
+    { 0xB23867FB2A35B28EULL,  -688, -188 },
+    { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+    { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+    { 0x936B9FCEBB25C996ULL,  -608, -164 },
+    { 0xDBAC6C247D62A584ULL,  -582, -156 },
+    { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+    { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+    { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+    { 0x87625F056C7C4A8BULL,  -475, -124 },
+    { 0xC9BCFF6034C13053ULL,  -449, -116 },
+    { 0x964E858C91BA2655ULL,  -422, -108 },
+    { 0xDFF9772470297EBDULL,  -396, -100 },
+    { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+    { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+    { 0xB94470938FA89BCFULL,  -316,  -76 },
+    { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+    { 0xCDB02555653131B6ULL,  -263,  -60 },
+    { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+    { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+    { 0xAA242499697392D3ULL,  -183,  -36 },
+    { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+    { 0xBCE5086492111AEBULL,  -130,  -20 },
+    { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+    { 0xD1B71758E219652CULL,   -77,   -4 },
+    { 0x9C40000000000000ULL,   -50,    4 },
+    { 0xE8D4A51000000000ULL,   -24,   12 },
+    { 0xAD78EBC5AC620000ULL,     3,   20 },
+    { 0x813F3978F8940984ULL,    30,   28 },
+    { 0xC097CE7BC90715B3ULL,    56,   36 },
+    { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+    { 0xD5D238A4ABE98068ULL,   109,   52 },
+    { 0x9F4F2726179A2245ULL,   136,   60 },
+    { 0xED63A231D4C4FB27ULL,   162,   68 },
+    { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+    { 0x83C7088E1AAB65DBULL,   216,   84 },
+    { 0xC45D1DF942711D9AULL,   242,   92 },
+    { 0x924D692CA61BE758ULL,   269,  100 },
+    { 0xDA01EE641A708DEAULL,   295,  108 },
+    { 0xA26DA3999AEF774AULL,   322,  116 },
+    { 0xF209787BB47D6B85ULL,   348,  124 },
+    { 0xB454E4A179DD1877ULL,   375,  132 },
+    { 0x865B86925B9BC5C2ULL,   402,  140 },
+    { 0xC83553C5C8965D3DULL,   428,  148 },
+    { 0x952AB45CFA97A0B3ULL,   455,  156 },
+    { 0xDE469FBD99A05FE3ULL,   481,  164 },
+    { 0xA59BC234DB398C25ULL,   508,  172 },
+    { 0xF6C69A72A3989F5CULL,   534,  180 },
+    { 0xB7DCBF5354E9BECEULL,   561,  188 },
+    { 0x88FCF317F22241E2ULL,   588,  196 },
+    { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+    { 0x98165AF37B2153DFULL,   641,  212 },
+    { 0xE2A0B5DC971F303AULL,   667,  220 },
+    { 0xA8D9D1535CE3B396ULL,   694,  228 },
+    { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+    { 0xBB764C4CA7A44410ULL,   747,  244 },
+    { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+    { 0xD01FEF10A657842CULL,   800,  260 },
+    { 0x9B10A4E5E9913129ULL,   827,  268 },
+    { 0xE7109BFBA19C0C9DULL,   853,  276 },
+    { 0xAC2820D9623BF429ULL,   880,  284 },
+    { 0x80444B5E7AA7CF85ULL,   907,  292 },
+    { 0xBF21E44003ACDD2DULL,   933,  300 },
+    { 0x8E679C2F5E44FF8FULL,   960,  308 },
+    { 0xD433179D9C8CB841ULL,   986,  316 },
+    { 0x9E19DB92B4E31BA9ULL,  1013,  324 },
+};
+
+#define _CACHED_POWERS_MIN_K  (-300)
+#define _CACHED_POWERS_STEP   8
+
+/** Window the scaled exponent must fall in, so digits come out of one 32-bit part. */
+#define _GRISU_ALPHA  (-60)
+#define _GRISU_GAMMA  (-32)
+
+static _DiyFp_t _diy_sub(_DiyFp_t x, _DiyFp_t y)
+{
+    return (_DiyFp_t){ x.f - y.f, x.e };
+}
+
+/** Upper 64 bits of the 128-bit product, rounded. */
+static _DiyFp_t _diy_mul(_DiyFp_t x, _DiyFp_t y)
+{
+    const uint64_t x_lo = x.f & 0xFFFFFFFFu, x_hi = x.f >> 32;
+    const uint64_t y_lo = y.f & 0xFFFFFFFFu, y_hi = y.f >> 32;
+    const uint64_t p0 = x_lo * y_lo;
+    const uint64_t p1 = x_lo * y_hi;
+    const uint64_t p2 = x_hi * y_lo;
+    const uint64_t p3 = x_hi * y_hi;
+    uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+    mid += 1u << 31;
+    return (_DiyFp_t){ p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32), x.e + y.e + 64 };
+}
+
+static _DiyFp_t _diy_normalize(_DiyFp_t x)
+{
+    const int shift = __builtin_clzll(x.f);
+    return (_DiyFp_t){ x.f << shift, x.e - shift };
+}
+
+/**
+ * Digits of the finite, nonzero double with fields @p frac and @p biased_e
+ * that read back as it: @p out holds them, and the double is approximately
+ * out * 10^(*exp10). Returns the number of digits.
+ */
+static int _grisu2(uint64_t frac, int biased_e, char* out, int* exp10)
+{
+    _DiyFp_t v;
+    if (biased_e == 0) {
+        v = (_DiyFp_t){ frac, 1 - 1075 };
+    } else {
+        v = (_DiyFp_t){ frac + (1ULL << 52), biased_e - 1075 };
+    }
+
+    /* Boundaries: midpoints to the neighbours; the one below is closer at a power of two */
+    const bool lower_closer = frac == 0 && biased_e > 1;
+    _DiyFp_t m_plus = _diy_normalize((_DiyFp_t){ 2 * v.f + 1, v.e - 1 });
+    _DiyFp_t m_minus = lower_closer ? (_DiyFp_t){ 4 * v.f - 1, v.e - 2 }
+                                    : (_DiyFp_t){ 2 * v.f - 1, v.e - 1 };
+    m_minus.f <<= m_minus.e - m_plus.e;
+    m_minus.e = m_plus.e;
+    const _DiyFp_t w = _diy_normalize(v);
+
+    /* Cached power c = 10^-k with ALPHA <= e(m_plus * c) <= GAMMA; k = ceil(f * log10(2)) */
+    const int f = _GRISU_ALPHA - m_plus.e - 1;
+    const int k = (f * 78913) / (1 << 18) + (f > 0);
+    const int index = (-_CACHED_POWERS_MIN_K + k + (_CACHED_POWERS_STEP - 1)) / _CACHED_POWERS_STEP;
+    const _CachedPower_t* cached = &s_cached_powers[index];
+    const _DiyFp_t c = { cached->f, cached->e };
+
+    const _DiyFp_t w_scaled = _diy_mul(w, c);
+    _DiyFp_t lo = _diy_mul(m_minus, c);
+    _DiyFp_t hi = _diy_mul(m_plus, c);
+    /* Shrink the interval by one unit for the rounding error of the products */
+    lo.f++;
+    hi.f--;
+
+    uint64_t delta = _diy_sub(hi, lo).f;
+    uint64_t dist = _diy_sub(hi, w_scaled).f;
+    const int shift = -hi.e;
+    const uint64_t one = 1ULL << shift;
+    uint32_t p1 = (uint32_t)(hi.f >> shift);
+    uint64_t p2 = hi.f & (one - 1);
+    int len = 0;
+    int e10 = -cached->k;
+
+    /* Integral part: p1 < 10^10 */
+    uint32_t pow10 = 1000000000u;
+    int n = 10;
+    while (pow10 > p1 && n > 1) {
+        pow10 /= 10;
+        n--;
+    }
+    uint64_t rest;
+    uint64_t ten_k;
+    for (;;) {
+        const uint32_t d = p1 / pow10;
+        p1 -= d * pow10;
+        out[len++] = (char)('0' + d);
+        n--;
+        rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta) {
+            e10 += n;
+            ten_k = (uint64_t)pow10 << shift;
+            break;
+        }
+        if (n == 0) {
+            /* Fractional part: digits until the rest fits the shrunken interval */
+            int m = 0;
+            do {
+                p2 *= 10;
+                out[len++] = (char)('0' + (p2 >> shift));
+                p2 &= one - 1;
+                delta *= 10;
+                dist *= 10;
+                m++;
+            } while (p2 > delta);
+            e10 -= m;
+            rest = p2;
+            ten_k = one;
+            break;
+        }
+        pow10 /= 10;
+    }
+
+    /* Step the last digit down while that moves closer to w and stays inside */
+    while (rest < dist && delta - rest >= ten_k &&
+           (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+        out[len - 1]--;
+        rest += ten_k;
+    }
+    *exp10 = e10;
+    return len;
+}
+
+/**
+ * "%g"-style layout of digits * 10^exp10: scientific when the exponent of the
+ * first digit is below -4 or at least @p max_fixed, otherwise fixed.
+ */
+static int _write_decimal(const char* digits, int len, int exp10, int max_fixed, char* out)
+{
+    char* p = out;
+    const int point = len + exp10;
+    int sci = point - 1;
+    if (sci < -4 || sci >= max_fixed) {
+        *p++ = digits[0];
+        if (len > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, (size_t)len - 1);
+            p += len - 1;
+        }
+        *p++ = 'e';
+        if (sci < 0) {
+            *p++ = '-';
+            sci = -sci;
+        } else {
+            *p++ = '+';
+        }
+        if (sci >= 100) {
+            *p++ = (char)('0' + sci / 100);
+            sci %= 100;
+        }
+        memcpy(p, &s_digit_pairs[sci * 2], 2);
+        p += 2;
+    } else if (point <= 0) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', (size_t)-point);
+        p += -point;
+        memcpy(p, digits, (size_t)len);
+        p += len;
+    } else if (point >= len) {
+        memcpy(p, digits, (size_t)len);
+        p += len;
+        memset(p, '0', (size_t)(point - len));
+        p += point - len;
+    } else {
+        memcpy(p, digits, (size_t)point);
+        p += point;
+        *p++ = '.';
+        memcpy(p, digits + point, (size_t)(len - point));
+        p += len - point;
+    }
+    return (int)(p - out);
+}
+
+/** "nan", "inf" or "-inf"; otherwise the sign, and "0" for zero. Returns -1 if digits follow. */
+static int _write_special(bool negative, bool non_finite, bool nan, bool zero, char* out, int* n)
+{
+    *n = 0;
+    if (nan) {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+    if (negative) {
+        out[(*n)++] = '-';
+    }
+    if (non_finite) {
+        memcpy(out + *n, "inf", 3);
+        return *n + 3;
+    }
+    if (zero) {
+        out[(*n)++] = '0';
+        return *n;
+    }
+    return -1;
+}
+
+static int _write_float(float v, char* out)
+{
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    const uint32_t frac = bits & 0x7FFFFFu;
+    const int biased_e = (int)((bits >> 23) & 0xFF);
+    int n;
+    const int special = _write_special(bits >> 31, biased_e == 0xFF, biased_e == 0xFF && frac != 0,
+                                       biased_e == 0 && frac == 0, out, &n);
+    if (special >= 0) {
+        return special;
+    }
+    uint32_t digits;
+    int exp10;
+    _ryu_float(frac, biased_e, &digits, &exp10);
+    char d[10];
+    const int len = _write_u32(digits, d);
+    return n + _write_decimal(d, len, exp10, 9, out + n);
+}
+
+static int _write_double(double v, char* out)
+{
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    const uint64_t frac = bits & 0xFFFFFFFFFFFFFull;
+    const int biased_e = (int)((bits >> 52) & 0x7FF);
+    int n;
+    const int special = _write_special(bits >> 63, biased_e == 0x7FF, biased_e == 0x7FF && frac != 0,
+                                       biased_e == 0 && frac == 0, out, &n);
+    if (special >= 0) {
+        return special;
+    }
+    char d[20];
+    int exp10;
+    const int len = _grisu2(frac, biased_e, d, &exp10);
+    return n + _write_decimal(d, len, exp10, 17, out + n);
+}
+
+int _nvsconfig_format_float(float value, char* buf, size_t buf_size)
+{
+    _FORMAT_VIA(_write_float, value);
+}
+
+int _nvsconfig_format_double(double value, char* buf, size_t buf_size)
+{
+    _FORMAT_VIA(_write_double, value);
+}
@@ -0,0 +1,51 @@
+/**
+ * @file nvs_format.h
+ * @author Hossein Molavi (hmolavi@uwaterloo.ca)
+ *
+ * @brief Number formatting for the print functions
+ *
+ * Allocation-free replacements for snprintf() with a format string, one per
+ * element type in format.inc. Integers are written with plain integer
+ * arithmetic, 32-bit where the value fits. float and double are written with
+ * digits that read back (strtof()/strtod()) to the same value: the fewest
+ * such digits for float (Ryu) and for all but about 0.1% of doubles
+ * (Grisu2). The layout follows "%g": fixed notation unless the decimal
+ * exponent is below -4 or at least the type's round-trip digit count
+ * (9 for float, 17 for double).
+ *
+ * Every function behaves like snprintf(): it writes at most buf_size - 1
+ * characters and a terminator, and returns the length of the full output.
+ * None allocates; the deepest, double, takes about 250 bytes of stack on a
+ * 64-bit host.
+ *
+ * @copyright Copyright (c) 2025
+ */
+
+#ifndef __NVS_FORMAT_H__
+#define __NVS_FORMAT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Longest output of any formatter, without the terminator ("-2.2250738585072014e-308"). */
+#define NVS_FORMAT_MAX_LEN 24
+
+int _nvsconfig_format_char(char value, char* buf, size_t buf_size);
+int _nvsconfig_format_bool(bool value, char* buf, size_t buf_size);
+int _nvsconfig_format_u32(uint32_t value, char* buf, size_t buf_size);
+int _nvsconfig_format_i32(int32_t value, char* buf, size_t buf_size);
+int _nvsconfig_format_u64(uint64_t value, char* buf, size_t buf_size);
+int _nvsconfig_format_i64(int64_t value, char* buf, size_t buf_size);
+int _nvsconfig_format_float(float value, char* buf, size_t buf_size);
+int _nvsconfig_format_double(double value, char* buf, size_t buf_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __NVS_FORMAT_H__
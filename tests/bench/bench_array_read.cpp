@@ -0,0 +1,116 @@
+/**
+ * @file bench_array_read.cpp
+ * @brief In-place array reads (Param_Acquire/Release) vs. Param_Copy.
+ *
+ * A reader thread repeatedly reads a 1 KB and a 4 KB uint8_t array and scans
+ * every byte, the way a consumer of the data would, while 0..N writer threads
+ * flip the same array between two uniform fill patterns. A read is counted as
+ * torn when the scanned bytes are not all equal.
+ *
+ * The unguarded Param_Get pointer is included as a baseline: it is the
+ * fastest path but shows how often a concurrent setter tears the data.
+ */
+
+#include "bench_rtos.hpp"
+#include "nvs_config.h"
+
+#include <cstring>
+#include <thread>
+
+static const int kReads = 50000;
+
+struct ArrayOps {
+    const char* name;
+    size_t size;
+    esp_err_t (*set)(const uint8_t*, size_t);
+    const uint8_t* (*get)(size_t*);
+    esp_err_t (*copy)(uint8_t*, size_t);
+    const uint8_t* (*acquire)(size_t*);
+    void (*release)(void);
+};
+
+static const ArrayOps kArrays[] = {
+    { "1 KB", 1024, Param_SetBlob1K, Param_GetBlob1K, Param_CopyBlob1K,
+      Param_AcquireBlob1K, Param_ReleaseBlob1K },
+    { "4 KB", 4096, Param_SetBlob4K, Param_GetBlob4K, Param_CopyBlob4K,
+      Param_AcquireBlob4K, Param_ReleaseBlob4K },
+};
+
+enum Method { kGet, kCopy, kAcquire };
+static const char* const kMethodNames[] = { "Get", "Copy", "Acquire" };
+
+/** True when every byte equals the first one. */
+static bool uniform(const uint8_t* data, size_t len)
+{
+    uint8_t diff = 0;
+    for (size_t i = 1; i < len; i++) diff |= (uint8_t)(data[i] ^ data[0]);
+    return diff == 0;
+}
+
+static void run(const ArrayOps& ops, Method method, int writers)
+{
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&stop, &ops, w] {
+            std::vector<uint8_t> a(ops.size, 0x11), b(ops.size, 0xEE);
+            uint32_t i = (uint32_t)w;
+            while (!stop.load(std::memory_order_relaxed)) {
+                ops.set((i++ & 1) ? a.data() : b.data(), ops.size);
+            }
+        });
+    }
+
+    std::vector<uint8_t> buffer(ops.size);
+    std::vector<uint64_t> samples;
+    samples.reserve(kReads);
+    uint32_t torn = 0;
+    for (int i = 0; i < kReads; i++) {
+        size_t len = ops.size;
+        bool ok;
+        uint64_t t0 = bench_now_ns();
+        switch (method) {
+        case kGet:
+            ok = uniform(ops.get(&len), len);
+            break;
+        case kCopy:
+            ops.copy(buffer.data(), buffer.size());
+            ok = uniform(buffer.data(), len);
+            break;
+        default:
+            ok = uniform(ops.acquire(&len), len);
+            ops.release();
+            break;
+        }
+        samples.push_back(bench_now_ns() - t0);
+        if (!ok) torn++;
+    }
+
+    stop = true;
+    for (auto& t : threads) t.join();
+
+    BenchLatency lat = BenchLatency::from(samples);
+    printf("%-5s %-8s %7d %10llu %10llu %10llu %6u\n", ops.name, kMethodNames[method], writers,
+           (unsigned long long)lat.p50, (unsigned long long)lat.p99,
+           (unsigned long long)lat.p999, torn);
+}
+
+int main()
+{
+    NvsConfig_Init();
+    NvsConfig_SecureLevelChange(0);
+
+    printf("Array read + full scan latency (ns), %d reads per row\n\n", kReads);
+    printf("%-5s %-8s %7s %10s %10s %10s %6s\n",
+           "size", "method", "writers", "p50", "p99", "p99.9", "torn");
+
+    for (const ArrayOps& ops : kArrays) {
+        for (int writers : {0, 1, 2}) {
+            for (Method method : {kGet, kCopy, kAcquire}) {
+                run(ops, method, writers);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file bench_find_param.cpp
+ * @brief Name lookup cost: perfect-hash NvsConfig_FindParam() vs. the linear
+ *        strcmp() scan it replaced.
+ *
+ * Every name in the table is looked up (hits), then every name with one
+ * character appended (misses, which the scan has to compare against all
+ * entries). Reported as average nanoseconds per lookup, best of several rounds.
+ *
+ * Built by CMakeLists.txt against the same generated tables of 20, 200 and
+ * 2000 parameters as the storage benchmarks.
+ */
+
+#include "bench_rtos.hpp"
+#include "nvs_config.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int kRounds = 20;
+static const size_t kLookups = 200000;
+static volatile size_t s_sink;  // keeps the lookups from being optimized out
+
+/** The lookup NvsConfig_FindParam() used before the hash table. */
+static const NvsConfigParamEntry_t* linear_find(const char* name)
+{
+    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
+        if (strcmp(g_nvsconfig_params[i].name, name) == 0) {
+            return &g_nvsconfig_params[i];
+        }
+    }
+    return NULL;
+}
+
+template <typename F>
+static double ns_per_lookup(const std::vector<std::string>& names, F&& find)
+{
+    uint64_t best = 0;
+    for (int r = 0; r < kRounds; r++) {
+        size_t found = 0;
+        uint64_t t0 = bench_now_ns();
+        for (size_t i = 0; i < kLookups; i++) {
+            found += find(names[i % names.size()].c_str()) != NULL;
+        }
+        uint64_t ns = bench_now_ns() - t0;
+        s_sink = found;
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return (double)best / kLookups;
+}
+
+int main(int argc, char** argv)
+{
+    const char* opt = argc > 1 ? argv[1] : "";
+    if (strcmp(opt, "--no-header") != 0) {
+        printf("%6s | %10s %10s | %10s %10s\n", "", "hit", "ns", "miss", "ns");
+        printf("%6s | %10s %10s | %10s %10s\n", "params", "scan", "hash", "scan", "hash");
+    }
+    if (strcmp(opt, "--header-only") == 0) {
+        return 0;
+    }
+
+    std::vector<std::string> hits, misses;
+    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
+        hits.push_back(g_nvsconfig_params[i].name);
+        misses.push_back(std::string(g_nvsconfig_params[i].name) + "x");
+        if (NvsConfig_FindParam(hits.back().c_str()) != &g_nvsconfig_params[i]) {
+            fprintf(stderr, "lookup of %s failed\n", hits.back().c_str());
+            return 1;
+        }
+    }
+
+    printf("%6u | %10.1f %10.1f | %10.1f %10.1f\n", (unsigned)g_nvsconfig_param_count,
+           ns_per_lookup(hits, linear_find), ns_per_lookup(hits, NvsConfig_FindParam),
+           ns_per_lookup(misses, linear_find), ns_per_lookup(misses, NvsConfig_FindParam));
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file bench_format.cpp
+ * @brief Param_Print cost: the nvs_format.c formatters vs. the snprintf()
+ *        loop they replaced, for a 64-element float and int32_t array.
+ *
+ * "snprintf" is the old Param_Print body: one snprintf() per element with the
+ * old format.inc format ("%.6g" for float, which does not read back exactly).
+ * "snprintf %.9g" is the cheapest snprintf() format whose float output reads
+ * back exactly, as the new output does. "formatter" runs the same loop with
+ * _nvsconfig_format_*(), and "Param_Print" is the library function itself,
+ * mutex included. Reported as average nanoseconds per array, best of several
+ * rounds, with the length of the output.
+ */
+
+#include "bench_rtos.hpp"
+#include "nvs_config.h"
+#include "nvs_format.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+
+static const int kRounds = 20;
+static const int kPrints = 2000;
+static const size_t kCount = 64;
+static volatile int s_sink;  // keeps the prints from being optimized out
+
+/** "[a,b,...]" of @p values with one snprintf() per element. */
+template <typename T>
+static int print_snprintf(const T* values, const char* format, char* buf, size_t buf_size)
+{
+    int offset = snprintf(buf, buf_size, "[");
+    for (size_t i = 0; i < kCount; i++) {
+        offset += snprintf(buf + offset, buf_size - offset, format, values[i]);
+        if (i < kCount - 1) buf[offset++] = ',';
+    }
+    buf[offset++] = ']';
+    buf[offset] = '\0';
+    return offset;
+}
+
+/** The same loop with a nvs_format.c formatter. */
+template <typename T>
+static int print_formatter(const T* values, int (*format)(T, char*, size_t), char* buf, size_t buf_size)
+{
+    int offset = 0;
+    buf[offset++] = '[';
+    for (size_t i = 0; i < kCount; i++) {
+        offset += format(values[i], buf + offset, buf_size - offset);
+        if (i < kCount - 1) buf[offset++] = ',';
+    }
+    buf[offset++] = ']';
+    buf[offset] = '\0';
+    return offset;
+}
+
+template <typename F>
+static double ns_per_print(F&& print, int* length)
+{
+    char buf[2048];
+    uint64_t best = 0;
+    for (int r = 0; r < kRounds; r++) {
+        int total = 0;
+        uint64_t t0 = bench_now_ns();
+        for (int i = 0; i < kPrints; i++) {
+            total += print(buf, sizeof(buf));
+        }
+        uint64_t ns = bench_now_ns() - t0;
+        s_sink = total;
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    *length = print(buf, sizeof(buf));
+    return (double)best / kPrints;
+}
+
+static void row(const char* array, const char* method, double ns, int length)
+{
+    printf("%-12s | %-14s | %10.0f | %6d\n", array, method, ns, length);
+}
+
+int main()
+{
+    /* Sensor-like readings with a few decimals, and counters of mixed width */
+    float samples[kCount];
+    int32_t counts[kCount];
+    for (size_t i = 0; i < kCount; i++) {
+        samples[i] = 21.5f + 4.0f * sinf((float)i * 0.37f) + (float)i * 0.001f;
+        counts[i] = (int32_t)((i * 2654435761u) >> (i % 24)) * ((i & 1) ? -1 : 1);
+    }
+    NvsConfig_Init();
+    Param_SetSamples(samples, kCount);
+    Param_SetCounts(counts, kCount);
+
+    printf("%-12s | %-14s | %10s | %6s\n", "array", "method", "ns", "chars");
+    int len;
+    double ns;
+
+    ns = ns_per_print([&](char* b, size_t n) { return print_snprintf(samples, "%.6g", b, n); }, &len);
+    row("float[64]", "snprintf", ns, len);
+    ns = ns_per_print([&](char* b, size_t n) { return print_snprintf(samples, "%.9g", b, n); }, &len);
+    row("float[64]", "snprintf %.9g", ns, len);
+    ns = ns_per_print([&](char* b, size_t n) { return print_formatter(samples, _nvsconfig_format_float, b, n); }, &len);
+    row("float[64]", "formatter", ns, len);
+    ns = ns_per_print([](char* b, size_t n) { return Param_PrintSamples(b, n); }, &len);
+    row("float[64]", "Param_Print", ns, len);
+
+    ns = ns_per_print([&](char* b, size_t n) { return print_snprintf(counts, "%" PRId32, b, n); }, &len);
+    row("int32_t[64]", "snprintf", ns, len);
+    ns = ns_per_print([&](char* b, size_t n) { return print_formatter(counts, _nvsconfig_format_i32, b, n); }, &len);
+    row("int32_t[64]", "formatter", ns, len);
+    ns = ns_per_print([](char* b, size_t n) { return Param_PrintCounts(b, n); }, &len);
+    row("int32_t[64]", "Param_Print", ns, len);
+    return 0;
+}
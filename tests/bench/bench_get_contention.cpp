@@ -0,0 +1,92 @@
+/**
+ * @file bench_get_contention.cpp
+ * @brief Param_Get* latency while other threads hammer setters and saves.
+ *
+ * One reader thread times individual Param_GetBigTimestamp() calls while
+ * 0..N writer threads flip the same parameter between two bit patterns and a
+ * saver thread runs NvsConfig_SaveDirtyParameters() against simulated flash
+ * latency. Every value read is checked against the two patterns, so a torn
+ * 64-bit read is reported as well.
+ *
+ * Built twice by CMakeLists.txt: once with the default lock-free getters and
+ * once with CONFIG_NVS_CONFIG_LOCKFREE_GETTERS=0 for the mutex baseline.
+ */
+
+#include "bench_rtos.hpp"
+#include "nvs_config.h"
+
+#include <thread>
+#include <vector>
+
+#ifndef NVS_BENCH_VARIANT
+#define NVS_BENCH_VARIANT "default"
+#endif
+
+static const int64_t kPatternA = 0x0123456789ABCDEFLL;
+static const int64_t kPatternB = ~0x0123456789ABCDEFLL;
+static const int kReads = 200000;
+
+static void run(int writers, bool with_saver)
+{
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&stop, w] {
+            uint32_t i = (uint32_t)w;
+            while (!stop.load(std::memory_order_relaxed)) {
+                Param_SetBigTimestamp((i++ & 1) ? kPatternA : kPatternB);
+                Param_SetCounter(i);
+            }
+        });
+    }
+    if (with_saver) {
+        threads.emplace_back([&stop] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                NvsConfig_SaveDirtyParameters();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+
+    std::vector<uint64_t> samples;
+    samples.reserve(kReads);
+    uint32_t torn = 0;
+    for (int i = 0; i < kReads; i++) {
+        uint64_t t0 = bench_now_ns();
+        int64_t v = Param_GetBigTimestamp();
+        samples.push_back(bench_now_ns() - t0);
+        if (v != kPatternA && v != kPatternB) torn++;
+    }
+
+    stop = true;
+    for (auto& t : threads) t.join();
+
+    BenchLatency lat = BenchLatency::from(samples);
+    printf("%-10s %7d %6s %10llu %10llu %10llu %12llu %6u\n",
+           NVS_BENCH_VARIANT, writers, with_saver ? "yes" : "no",
+           (unsigned long long)lat.p50, (unsigned long long)lat.p99,
+           (unsigned long long)lat.p999, (unsigned long long)lat.max, torn);
+}
+
+int main()
+{
+    NvsConfig_Init();
+    NvsConfig_SecureLevelChange(0);
+    Param_SetBigTimestamp(kPatternA);
+    g_bench_flash_latency_us = 2000;
+
+    printf("Param_GetBigTimestamp latency (ns), %d reads per row, "
+           "simulated flash op = %u us\n\n", kReads, g_bench_flash_latency_us.load());
+    printf("%-10s %7s %6s %10s %10s %10s %12s %6s\n",
+           "getters", "writers", "saver", "p50", "p99", "p99.9", "max", "torn");
+
+    const int writer_counts[] = {0, 1, 2, 4};
+    for (int writers : writer_counts) {
+        run(writers, false);
+    }
+    for (int writers : writer_counts) {
+        run(writers, true);
+    }
+    return 0;
+}
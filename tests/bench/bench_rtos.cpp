@@ -0,0 +1,275 @@
+/**
+ * @file bench_rtos.cpp
+ * @brief Thread-safe host implementations of the ESP-IDF APIs used by nvs_config.
+ *
+ * Unlike tests/unit/mocks/mock_impl.cpp, which stubs everything for a single
+ * thread, these back the FreeRTOS mutex with std::mutex and NVS with an
+ * in-memory store so benchmarks can run real concurrent tasks as std::threads.
+ * Flash operations optionally sleep for g_bench_flash_latency_us to model the
+ * cost of an nvs_set_blob/nvs_commit on a real chip.
+ */
+
+#include "bench_rtos.hpp"
+
+#include "esp_err.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::atomic<uint32_t> g_bench_flash_latency_us{0};
+std::atomic<uint32_t> g_bench_read_latency_us{0};
+BenchNvsStats g_bench_nvs_stats;
+
+static std::mutex s_store_lock;
+/** How a value was stored: nvs_set_blob(), nvs_set_u8() ... nvs_set_u64() or nvs_set_str(). */
+enum BenchNvsKind { kBenchBlob, kBenchTyped, kBenchStr };
+
+struct BenchNvsEntry {
+    BenchNvsKind kind;
+    std::vector<uint8_t> data;
+};
+static std::map<std::string, BenchNvsEntry> s_store;
+
+static void bench_flash_delay(void)
+{
+    uint32_t us = g_bench_flash_latency_us.load(std::memory_order_relaxed);
+    if (us) std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+static void bench_read_delay(void)
+{
+    uint32_t us = g_bench_read_latency_us.load(std::memory_order_relaxed);
+    if (us) std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+size_t bench_nvs_entries(void)
+{
+    // NVS stores a typed value in a single entry, a string as one header
+    // entry plus 32-byte data entries, and a blob as one index entry plus a
+    // data header entry and 32-byte data entries (single-page blobs;
+    // multi-page blobs add a data header per page, ignored here).
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    size_t entries = 0;
+    for (const auto& kv : s_store) {
+        const size_t data_entries = (kv.second.data.size() + 31) / 32;
+        switch (kv.second.kind) {
+        case kBenchTyped: entries += 1; break;
+        case kBenchStr:   entries += 1 + data_entries; break;
+        default:          entries += 2 + data_entries; break;
+        }
+    }
+    return entries;
+}
+
+void bench_nvs_reset(void)
+{
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    s_store.clear();
+    g_bench_nvs_stats.reset();
+}
+
+// ── esp_err ──
+
+const char* esp_err_to_name(esp_err_t code)
+{
+    return code == ESP_OK ? "ESP_OK" : "ESP_ERR";
+}
+
+// ── NVS ──
+
+esp_err_t nvs_flash_init(void)  { return ESP_OK; }
+esp_err_t nvs_flash_erase(void) { return ESP_OK; }
+
+esp_err_t nvs_open(const char* /*name*/, nvs_open_mode_t /*mode*/, nvs_handle_t* out_handle)
+{
+    g_bench_nvs_stats.opens++;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t /*handle*/, const char* key, void* out, size_t* length)
+{
+    g_bench_nvs_stats.reads++;
+    bench_read_delay();
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    auto it = s_store.find(key);
+    if (it == s_store.end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (it->second.kind != kBenchBlob) return ESP_ERR_NVS_TYPE_MISMATCH;
+    const std::vector<uint8_t>& data = it->second.data;
+    if (out != nullptr) {
+        if (*length < data.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(out, data.data(), data.size());
+    }
+    *length = data.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t /*handle*/, const char* key, const void* value, size_t length)
+{
+    g_bench_nvs_stats.writes++;
+    g_bench_nvs_stats.bytes_written += length;
+    bench_flash_delay();
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    const uint8_t* p = static_cast<const uint8_t*>(value);
+    s_store[key] = BenchNvsEntry{kBenchBlob, std::vector<uint8_t>(p, p + length)};
+    return ESP_OK;
+}
+
+template <typename T>
+static esp_err_t bench_set_typed(const char* key, T value)
+{
+    g_bench_nvs_stats.writes++;
+    g_bench_nvs_stats.bytes_written += sizeof(T);
+    bench_flash_delay();
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    s_store[key] = BenchNvsEntry{kBenchTyped, std::vector<uint8_t>(p, p + sizeof(T))};
+    return ESP_OK;
+}
+
+template <typename T>
+static esp_err_t bench_get_typed(const char* key, T* out)
+{
+    g_bench_nvs_stats.reads++;
+    bench_read_delay();
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    auto it = s_store.find(key);
+    if (it == s_store.end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (it->second.kind != kBenchTyped || it->second.data.size() != sizeof(T)) return ESP_ERR_NVS_TYPE_MISMATCH;
+    memcpy(out, it->second.data.data(), sizeof(T));
+    return ESP_OK;
+}
+
+#define BENCH_NVS_TYPED(suffix, ctype)                                                \
+    esp_err_t nvs_set_##suffix(nvs_handle_t /*handle*/, const char* key, ctype value) \
+    {                                                                                 \
+        return bench_set_typed(key, value);                                           \
+    }                                                                                 \
+    esp_err_t nvs_get_##suffix(nvs_handle_t /*handle*/, const char* key, ctype* out)  \
+    {                                                                                 \
+        return bench_get_typed(key, out);                                             \
+    }
+BENCH_NVS_TYPED(u8, uint8_t)
+BENCH_NVS_TYPED(i8, int8_t)
+BENCH_NVS_TYPED(u16, uint16_t)
+BENCH_NVS_TYPED(i16, int16_t)
+BENCH_NVS_TYPED(u32, uint32_t)
+BENCH_NVS_TYPED(i32, int32_t)
+BENCH_NVS_TYPED(u64, uint64_t)
+BENCH_NVS_TYPED(i64, int64_t)
+#undef BENCH_NVS_TYPED
+
+esp_err_t nvs_set_str(nvs_handle_t /*handle*/, const char* key, const char* value)
+{
+    const size_t length = strlen(value) + 1;
+    g_bench_nvs_stats.writes++;
+    g_bench_nvs_stats.bytes_written += length;
+    bench_flash_delay();
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(value);
+    s_store[key] = BenchNvsEntry{kBenchStr, std::vector<uint8_t>(p, p + length)};
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_str(nvs_handle_t /*handle*/, const char* key, char* out, size_t* length)
+{
+    g_bench_nvs_stats.reads++;
+    bench_read_delay();
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    auto it = s_store.find(key);
+    if (it == s_store.end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (it->second.kind != kBenchStr) return ESP_ERR_NVS_TYPE_MISMATCH;
+    const std::vector<uint8_t>& data = it->second.data;
+    if (out != nullptr) {
+        if (*length < data.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(out, data.data(), data.size());
+    }
+    *length = data.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t /*handle*/)
+{
+    g_bench_nvs_stats.commits++;
+    bench_flash_delay();
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t /*handle*/, const char* key)
+{
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    return s_store.erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t /*handle*/)
+{
+    std::lock_guard<std::mutex> lock(s_store_lock);
+    s_store.clear();
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t /*handle*/) {}
+
+// ── FreeRTOS mutex backed by std::mutex ──
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return new std::mutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t /*ticks*/)
+{
+    static_cast<std::mutex*>(sem)->lock();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    static_cast<std::mutex*>(sem)->unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    delete static_cast<std::mutex*>(sem);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t /*max*/, UBaseType_t /*initial*/)
+{
+    return nullptr;
+}
+
+// ── Tasks: benchmarks drive saves explicitly, so the save task never runs ──
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*,
+                                   UBaseType_t, TaskHandle_t* out_handle, BaseType_t)
+{
+    static int s_dummy_task;
+    *out_handle = &s_dummy_task;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    using namespace std::chrono;
+    return (TickType_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,60 @@
+/**
+ * @file bench_rtos.hpp
+ * @brief Controls and helpers shared by the host benchmarks.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/** Simulated latency of every nvs_set_blob / nvs_commit, in microseconds. */
+extern std::atomic<uint32_t> g_bench_flash_latency_us;
+
+/** Simulated latency of every nvs_get_blob, in microseconds. */
+extern std::atomic<uint32_t> g_bench_read_latency_us;
+
+/** Counters of NVS calls made by the library since the last bench_nvs_reset(). */
+struct BenchNvsStats {
+    std::atomic<uint32_t> opens{0};
+    std::atomic<uint32_t> reads{0};
+    std::atomic<uint32_t> writes{0};
+    std::atomic<uint32_t> commits{0};
+    std::atomic<uint64_t> bytes_written{0};
+
+    void reset()
+    {
+        opens = 0; reads = 0; writes = 0; commits = 0; bytes_written = 0;
+    }
+};
+extern BenchNvsStats g_bench_nvs_stats;
+
+/** Clear the in-memory NVS store and all counters. */
+void bench_nvs_reset(void);
+
+/** Estimated number of 32-byte NVS entries the stored blobs occupy. */
+size_t bench_nvs_entries(void);
+
+/** Monotonic timestamp in nanoseconds. */
+inline uint64_t bench_now_ns()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Latency distribution summary over a set of samples (sorted in place). */
+struct BenchLatency {
+    uint64_t p50, p99, p999, max;
+
+    static BenchLatency from(std::vector<uint64_t>& samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        auto at = [&](double q) { return samples[(size_t)(q * (samples.size() - 1))]; };
+        return { at(0.50), at(0.99), at(0.999), samples.back() };
+    }
+};
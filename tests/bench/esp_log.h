@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdio.h>
+
+/* Benchmarks shadow tests/unit/mocks/esp_log.h so periodic info logs from
+ * the save path do not interleave with result tables. */
+#define ESP_LOGI(tag, fmt, ...) ((void)0)
+#define ESP_LOGE(tag, fmt, ...) printf("[E][%s] " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) ((void)0)
+#define ESP_LOGD(tag, fmt, ...) ((void)0)
+#define ESP_LOGV(tag, fmt, ...) ((void)0)
@@ -21,7 +21,7 @@ extern "C" void app_main(void)
     register_thread_safety_tests();
 
     ESP_LOGI(TAG, "");
-    ESP_LOGI(TAG, "NVS Config - Hardware Test Suite (4 tests)");
+    ESP_LOGI(TAG, "NVS Config - Hardware Test Suite (8 tests)");
     ESP_LOGI(TAG, "");
 
     esp_err_t rc = NvsConfig_Init();
@@ -10,6 +10,10 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
+#include "sdkconfig.h"
+
+#include <atomic>
+#include <cstring>
 
 void register_thread_safety_tests() {} // linker anchor
 
@@ -73,6 +77,52 @@ static void modify_task(void* arg)
     vTaskDelete(NULL);
 }
 
+static const int64_t kTornPatternA = 0x0123456789ABCDEFLL;
+static const int64_t kTornPatternB = ~0x0123456789ABCDEFLL;
+
+static void timestamp_flipper_task(void* arg)
+{
+    int iterations = *static_cast<int*>(arg);
+    for (int i = 0; i < iterations; i++) {
+        Param_SetBigTimestamp((i & 1) ? kTornPatternA : kTornPatternB);
+    }
+    xSemaphoreGive(s_done_sem);
+    vTaskDelete(NULL);
+}
+
+static void pattern_flipper_task(void* arg)
+{
+    int iterations = *static_cast<int*>(arg);
+    uint8_t a[8], b[8];
+    memset(a, 0x11, sizeof(a));
+    memset(b, 0xEE, sizeof(b));
+    for (int i = 0; i < iterations; i++) {
+        Param_SetBytePattern((i & 1) ? a : b, sizeof(a));
+    }
+    xSemaphoreGive(s_done_sem);
+    vTaskDelete(NULL);
+}
+
+static std::atomic<int> s_churn_calls{0};
+
+static void churn_callback(const char*, void*)
+{
+    s_churn_calls++;
+}
+
+static void subscription_churn_task(void* arg)
+{
+    int iterations = *static_cast<int*>(arg);
+    for (int i = 0; i < iterations; i++) {
+        NvsConfigSubscription_t sub = NVS_CONFIG_SUBSCRIPTION_NONE;
+        if (NvsConfig_Subscribe("Brightness", churn_callback, nullptr, 0, &sub) == ESP_OK) {
+            NvsConfig_Unsubscribe(sub);
+        }
+    }
+    xSemaphoreGive(s_done_sem);
+    vTaskDelete(NULL);
+}
+
 // ── Tests ──
 
 TEST_F(NvsTestFixture, ConcurrentSettersNoCorruption) {
@@ -129,8 +179,90 @@ TEST_F(NvsTestFixture, ConcurrentSaveAndSet) {
     vSemaphoreDelete(s_done_sem);
 }
 
+TEST_F(NvsTestFixture, ConcurrentGetNeverTorn) {
+    s_done_sem = xSemaphoreCreateCounting(1, 0);
+
+    static int iters = 20000;
+    Param_SetBigTimestamp(kTornPatternA);
+
+    // Writer on the other core (where available) at the reader's priority
+    xTaskCreatePinnedToCore(timestamp_flipper_task, "flipper", 4096, &iters, 5, NULL,
+                            portNUM_PROCESSORS - 1);
+
+    int torn = 0;
+    while (xSemaphoreTake(s_done_sem, 0) != pdTRUE) {
+        int64_t v = Param_GetBigTimestamp();
+        if (v != kTornPatternA && v != kTornPatternB) torn++;
+    }
+    EXPECT_EQ(torn, 0);
+
+    vSemaphoreDelete(s_done_sem);
+}
+
+TEST_F(NvsTestFixture, ArrayAcquireNeverTorn) {
+    s_done_sem = xSemaphoreCreateCounting(1, 0);
+
+    static int iters = 20000;
+
+    xTaskCreatePinnedToCore(pattern_flipper_task, "flipper", 4096, &iters, 5, NULL,
+                            portNUM_PROCESSORS - 1);
+
+    // Every element must match the first one for as long as the guard is held
+    int torn = 0;
+    while (xSemaphoreTake(s_done_sem, 0) != pdTRUE) {
+        size_t len;
+        const uint8_t* bp = Param_AcquireBytePattern(&len);
+        for (size_t i = 1; i < len; i++) {
+            if (bp[i] != bp[0]) {
+                torn++;
+                break;
+            }
+        }
+        Param_ReleaseBytePattern();
+    }
+    EXPECT_EQ(torn, 0);
+
+    vSemaphoreDelete(s_done_sem);
+}
+
+TEST_F(NvsTestFixture, BackgroundSaveAfterQuietPeriod) {
+    NvsConfig_SaveDirtyParameters();
+    Param_SetBrightness(Param_GetBrightness() + 1);
+    EXPECT_TRUE(NvsConfig_FindParam("Brightness")->is_dirty());
+
+    // The save task flushes once the quiet period has passed without changes
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_NVS_CONFIG_SAVE_QUIET_MS + 500));
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
 TEST_F(NvsTestFixture, MutexInitializedBeforeUse) {
     // NvsConfig_Init() was already called successfully in test_main.cpp
     // If mutex creation failed, Init would have returned ESP_FAIL
     EXPECT_EQ(NvsConfig_SecureLevel(), (uint8_t)0);
 }
+
+TEST_F(NvsTestFixture, SubscribeUnsubscribeDuringNotify) {
+    s_done_sem = xSemaphoreCreateCounting(3, 0);
+    NvsConfig_ClearCallbacks();
+
+    static SetterTaskArgs args_a = { .value = 1, .iterations = 2000 };
+    static SetterTaskArgs args_b = { .value = 2, .iterations = 2000 };
+    static int iters = 2000;
+
+    xTaskCreate(brightness_setter_task, "set_a", 4096, &args_a, 5, NULL);
+    xTaskCreate(brightness_setter_task, "set_b", 4096, &args_b, 5, NULL);
+    xTaskCreate(subscription_churn_task, "churn", 4096, &iters, 5, NULL);
+
+    xSemaphoreTake(s_done_sem, pdMS_TO_TICKS(10000));
+    xSemaphoreTake(s_done_sem, pdMS_TO_TICKS(10000));
+    xSemaphoreTake(s_done_sem, pdMS_TO_TICKS(10000));
+
+    // Every churned slot must have been reclaimed: the whole pool is available again
+    NvsConfigSubscription_t subs[CONFIG_NVS_CONFIG_MAX_CALLBACKS];
+    for (int i = 0; i < CONFIG_NVS_CONFIG_MAX_CALLBACKS; i++) {
+        EXPECT_EQ(NvsConfig_Subscribe(nullptr, churn_callback, nullptr, 0, &subs[i]), ESP_OK);
+    }
+    NvsConfig_ClearCallbacks();
+
+    vSemaphoreDelete(s_done_sem);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+/* Minimal FreeRTOS task stubs. The save and callback dispatch tasks are never
+ * actually started in unit tests; tests drive NvsConfig_SaveDirtyParameters()
+ * and NvsConfig_DispatchPending() directly and use the notify counter in
+ * mock_control.h to check when a task would be woken. mock_run_save_task()
+ * runs one pass of the save task to check how long it would sleep. */
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void* arg);
+
+#define tskNO_AFFINITY ((BaseType_t) 0x7FFFFFFF)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name,
+                                   uint32_t stack_depth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* out_handle,
+                                   BaseType_t core_id);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t   ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+void       vTaskDelay(TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
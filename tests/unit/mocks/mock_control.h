@@ -9,6 +9,7 @@
 #pragma once
 
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -25,17 +26,49 @@ extern esp_err_t g_mock_nvs_open_ret;
  * The first g_mock_nvs_get_blob_ok_calls calls to nvs_get_blob() return
  * ESP_OK and memcpy g_mock_nvs_get_blob_data (up to *length bytes) into
  * the caller's buffer.  All subsequent calls return ESP_ERR_NVS_NOT_FOUND.
+ * The typed nvs_get_u8() ... nvs_get_u64() calls share these controls.
  */
 extern int     g_mock_nvs_get_blob_ok_calls;
 extern uint8_t g_mock_nvs_get_blob_data[64];
 
 /* ── nvs_set_blob ─────────────────────────────────────────────────────── */
+/*
+ * The typed nvs_set_u8() ... nvs_set_u64() calls share these controls, so
+ * the counter and return value cover every value written.
+ */
 /** Return value for nvs_set_blob().  Default: ESP_OK. */
 extern esp_err_t g_mock_nvs_set_blob_ret;
+/** Number of nvs_set_blob() calls since the last mock_reset_controls(). */
+extern int g_mock_nvs_set_blob_calls;
+/**
+ * Called from inside nvs_set_blob() with the key being written, before it
+ * returns.  Lets a test change parameters while a save is mid-flight.
+ * Default: NULL.
+ */
+extern void (*g_mock_nvs_set_blob_hook)(const char* key);
+
+/* ── in-memory NVS store ───────────────────────────────────────────────── */
+/**
+ * When non-zero, nvs_set_blob() stores blobs by key and nvs_get_blob() serves
+ * them back (NOT_FOUND for unknown keys, TYPE_MISMATCH for a key written by a
+ * typed nvs_set_*() call, and vice versa), taking precedence over
+ * g_mock_nvs_get_blob_ok_calls.  nvs_erase_key()/nvs_erase_all() remove
+ * entries.  The store persists across NvsConfig_Init() calls so a test can
+ * "reboot".  Default: 0.
+ */
+extern int g_mock_nvs_store_enabled;
+/** Number of blobs currently in the store. */
+size_t mock_nvs_store_count(void);
+/** Size of the stored blob for @p key, or 0 if absent. */
+size_t mock_nvs_store_size(const char* key);
+/** NVS type of the entry for @p key ("blob", "str", "u8", "i32", ...), or NULL if absent. */
+const char* mock_nvs_store_type(const char* key);
 
 /* ── nvs_commit ───────────────────────────────────────────────────────── */
 /** Return value for nvs_commit().  Default: ESP_OK. */
 extern esp_err_t g_mock_nvs_commit_ret;
+/** Number of nvs_commit() calls since the last mock_reset_controls(). */
+extern int g_mock_nvs_commit_calls;
 
 /* ── nvs_flash_init ───────────────────────────────────────────────────── */
 /**
@@ -49,14 +82,31 @@ extern esp_err_t g_mock_nvs_flash_init_ret;
 /** When non-zero, xSemaphoreCreateMutex() returns NULL. Default: 0. */
 extern int g_mock_mutex_fail;
 
-/* ── esp_timer ────────────────────────────────────────────────────────── */
-/** Return value for esp_timer_create().         Default: ESP_OK. */
-extern esp_err_t g_mock_esp_timer_create_ret;
-/** Return value for esp_timer_start_periodic(). Default: ESP_OK. */
-extern esp_err_t g_mock_esp_timer_start_ret;
+/* ── FreeRTOS tasks ───────────────────────────────────────────────────── */
+/** Return value for xTaskCreatePinnedToCore().  Default: pdPASS. */
+extern BaseType_t g_mock_task_create_ret;
+/** Number of xTaskNotifyGive() calls since the last mock_reset_controls(). */
+extern int g_mock_task_notify_count;
+/** Value returned by xTaskGetTickCount().  Default: 0. */
+extern TickType_t g_mock_tick_count;
+/**
+ * Run the save task created by NvsConfig_Init() on the calling thread, as if
+ * it had just been woken, until it blocks again.  Returns the timeout of its
+ * next ulTaskNotifyTake(): portMAX_DELAY once nothing is dirty, otherwise the
+ * ticks until the next flush is due.  Returns 0 if the task is still running
+ * after @p max_polls calls to xTaskGetTickCount(), i.e. it saves in a loop
+ * without ever sleeping.
+ */
+TickType_t mock_run_save_task(int max_polls);
+/**
+ * Clear the handle the library keeps for task @p name ("nvs_cfg_save", ...),
+ * as if it had never been created, so the next NvsConfig_Init() or
+ * registration tries to create it again.
+ */
+void mock_forget_task(const char* name);
 
 /* ── helpers ──────────────────────────────────────────────────────────── */
-/** Reset every control to its default value. */
+/** Reset every control to its default value and empty the store. */
 void mock_reset_controls(void);
 
 #ifdef __cplusplus
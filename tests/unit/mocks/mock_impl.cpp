@@ -5,9 +5,12 @@
  * Default behaviour (unchanged from original):
  *  - nvs_flash_init / nvs_open / nvs_set_blob / nvs_commit → ESP_OK
  *  - nvs_get_blob                                          → ESP_ERR_NVS_NOT_FOUND
+ *  - nvs_set_u8 ... nvs_set_u64 / nvs_get_u8 ... nvs_get_u64 and
+ *    nvs_set_str / nvs_get_str share the nvs_set_blob / nvs_get_blob controls
  *    (forces NvsConfig_Init to load every parameter from its compiled-in default)
  *  - Mutex stubs are single-threaded no-ops (unit tests never spawn tasks)
- *  - Timer stubs are no-ops (no periodic saves needed in unit tests)
+ *  - The save task is never started; xTaskNotifyGive() only counts wake-ups,
+ *    and mock_run_save_task() runs one pass of it on the test thread
  *
  * Tests that need to exercise error/alternate paths can set the knobs in
  * mock_control.h and call mock_reset_controls() in teardown().
@@ -20,12 +23,15 @@
 #include "nvs_flash.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
-#include "freertos/timers.h"
-#include "esp_timer/esp_timer.h"
+#include "freertos/task.h"
 
+#include <csetjmp>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
+#include <map>
+#include <string>
+#include <vector>
 
 // ── Mock control globals (defaults mirror original fixed-stub behaviour) ──
 
@@ -33,11 +39,40 @@ esp_err_t g_mock_nvs_open_ret           = ESP_OK;
 int       g_mock_nvs_get_blob_ok_calls  = 0;
 uint8_t   g_mock_nvs_get_blob_data[64]  = {};
 esp_err_t g_mock_nvs_set_blob_ret       = ESP_OK;
+int       g_mock_nvs_set_blob_calls     = 0;
+void    (*g_mock_nvs_set_blob_hook)(const char*) = nullptr;
+int       g_mock_nvs_store_enabled      = 0;
 esp_err_t g_mock_nvs_commit_ret         = ESP_OK;
+int       g_mock_nvs_commit_calls       = 0;
 esp_err_t g_mock_nvs_flash_init_ret     = ESP_OK;
 int       g_mock_mutex_fail             = 0;
-esp_err_t g_mock_esp_timer_create_ret   = ESP_OK;
-esp_err_t g_mock_esp_timer_start_ret    = ESP_OK;
+BaseType_t g_mock_task_create_ret       = pdPASS;
+int       g_mock_task_notify_count      = 0;
+TickType_t g_mock_tick_count            = 0;
+
+/** One stored entry: its NVS type ("blob", "u8", "i32", ...) and raw bytes. */
+struct MockNvsEntry {
+    std::string type;
+    std::vector<uint8_t> data;
+};
+static std::map<std::string, MockNvsEntry> s_store;
+
+size_t mock_nvs_store_count(void)
+{
+    return s_store.size();
+}
+
+size_t mock_nvs_store_size(const char* key)
+{
+    auto it = s_store.find(key);
+    return it == s_store.end() ? 0 : it->second.data.size();
+}
+
+const char* mock_nvs_store_type(const char* key)
+{
+    auto it = s_store.find(key);
+    return it == s_store.end() ? nullptr : it->second.type.c_str();
+}
 
 void mock_reset_controls(void)
 {
@@ -45,11 +80,17 @@ void mock_reset_controls(void)
     g_mock_nvs_get_blob_ok_calls = 0;
     memset(g_mock_nvs_get_blob_data, 0, sizeof(g_mock_nvs_get_blob_data));
     g_mock_nvs_set_blob_ret      = ESP_OK;
+    g_mock_nvs_set_blob_calls    = 0;
+    g_mock_nvs_set_blob_hook     = nullptr;
+    g_mock_nvs_store_enabled     = 0;
+    s_store.clear();
     g_mock_nvs_commit_ret        = ESP_OK;
+    g_mock_nvs_commit_calls      = 0;
     g_mock_nvs_flash_init_ret    = ESP_OK;
     g_mock_mutex_fail            = 0;
-    g_mock_esp_timer_create_ret  = ESP_OK;
-    g_mock_esp_timer_start_ret   = ESP_OK;
+    g_mock_task_create_ret       = pdPASS;
+    g_mock_task_notify_count     = 0;
+    g_mock_tick_count            = 0;
 }
 
 // ── esp_err ──
@@ -88,9 +129,23 @@ esp_err_t nvs_open(const char* /*name*/, nvs_open_mode_t /*mode*/, nvs_handle_t*
     return g_mock_nvs_open_ret;
 }
 
-esp_err_t nvs_get_blob(nvs_handle_t /*handle*/, const char* /*key*/,
+esp_err_t nvs_get_blob(nvs_handle_t /*handle*/, const char* key,
                        void* out, size_t* length)
 {
+    if (g_mock_nvs_store_enabled) {
+        auto it = s_store.find(key);
+        if (it == s_store.end()) return ESP_ERR_NVS_NOT_FOUND;
+        if (it->second.type != "blob") return ESP_ERR_NVS_TYPE_MISMATCH;
+        const std::vector<uint8_t>& data = it->second.data;
+        if (out == nullptr) {
+            *length = data.size();
+            return ESP_OK;
+        }
+        if (*length < data.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(out, data.data(), data.size());
+        *length = data.size();
+        return ESP_OK;
+    }
     if (g_mock_nvs_get_blob_ok_calls > 0) {
         g_mock_nvs_get_blob_ok_calls--;
         size_t copy_len = (*length < sizeof(g_mock_nvs_get_blob_data))
@@ -101,14 +156,125 @@ esp_err_t nvs_get_blob(nvs_handle_t /*handle*/, const char* /*key*/,
     return ESP_ERR_NVS_NOT_FOUND;
 }
 
-esp_err_t nvs_set_blob(nvs_handle_t /*handle*/, const char* /*key*/,
-                       const void* /*value*/, size_t /*length*/)
+esp_err_t nvs_set_blob(nvs_handle_t /*handle*/, const char* key,
+                       const void* value, size_t length)
+{
+    g_mock_nvs_set_blob_calls++;
+    if (g_mock_nvs_set_blob_hook) g_mock_nvs_set_blob_hook(key);
+    if (g_mock_nvs_store_enabled && g_mock_nvs_set_blob_ret == ESP_OK) {
+        const uint8_t* p = static_cast<const uint8_t*>(value);
+        s_store[key] = MockNvsEntry{"blob", std::vector<uint8_t>(p, p + length)};
+    }
+    return g_mock_nvs_set_blob_ret;
+}
+
+// Typed entries go through the nvs_set_blob/nvs_get_blob controls, so the
+// write counter and failure knobs cover every value a save writes.
+template <typename T>
+static esp_err_t mock_set_typed(const char* type, const char* key, T value)
+{
+    g_mock_nvs_set_blob_calls++;
+    if (g_mock_nvs_set_blob_hook) g_mock_nvs_set_blob_hook(key);
+    if (g_mock_nvs_store_enabled && g_mock_nvs_set_blob_ret == ESP_OK) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        s_store[key] = MockNvsEntry{type, std::vector<uint8_t>(p, p + sizeof(T))};
+    }
+    return g_mock_nvs_set_blob_ret;
+}
+
+template <typename T>
+static esp_err_t mock_get_typed(const char* type, const char* key, T* out)
+{
+    if (g_mock_nvs_store_enabled) {
+        auto it = s_store.find(key);
+        if (it == s_store.end()) return ESP_ERR_NVS_NOT_FOUND;
+        if (it->second.type != type) return ESP_ERR_NVS_TYPE_MISMATCH;
+        memcpy(out, it->second.data.data(), sizeof(T));
+        return ESP_OK;
+    }
+    if (g_mock_nvs_get_blob_ok_calls > 0) {
+        g_mock_nvs_get_blob_ok_calls--;
+        memcpy(out, g_mock_nvs_get_blob_data, sizeof(T));
+        return ESP_OK;
+    }
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+#define MOCK_NVS_TYPED(suffix, ctype)                                                 \
+    esp_err_t nvs_set_##suffix(nvs_handle_t /*handle*/, const char* key, ctype value) \
+    {                                                                                 \
+        return mock_set_typed(#suffix, key, value);                                   \
+    }                                                                                 \
+    esp_err_t nvs_get_##suffix(nvs_handle_t /*handle*/, const char* key, ctype* out)  \
+    {                                                                                 \
+        return mock_get_typed(#suffix, key, out);                                     \
+    }
+MOCK_NVS_TYPED(u8, uint8_t)
+MOCK_NVS_TYPED(i8, int8_t)
+MOCK_NVS_TYPED(u16, uint16_t)
+MOCK_NVS_TYPED(i16, int16_t)
+MOCK_NVS_TYPED(u32, uint32_t)
+MOCK_NVS_TYPED(i32, int32_t)
+MOCK_NVS_TYPED(u64, uint64_t)
+MOCK_NVS_TYPED(i64, int64_t)
+#undef MOCK_NVS_TYPED
+
+// Strings are stored with their terminator, as NVS does.
+esp_err_t nvs_set_str(nvs_handle_t /*handle*/, const char* key, const char* value)
 {
+    g_mock_nvs_set_blob_calls++;
+    if (g_mock_nvs_set_blob_hook) g_mock_nvs_set_blob_hook(key);
+    if (g_mock_nvs_store_enabled && g_mock_nvs_set_blob_ret == ESP_OK) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(value);
+        s_store[key] = MockNvsEntry{"str", std::vector<uint8_t>(p, p + strlen(value) + 1)};
+    }
     return g_mock_nvs_set_blob_ret;
 }
 
-esp_err_t nvs_commit(nvs_handle_t /*handle*/) { return g_mock_nvs_commit_ret; }
-esp_err_t nvs_erase_all(nvs_handle_t /*handle*/) { return ESP_OK; }
+esp_err_t nvs_get_str(nvs_handle_t /*handle*/, const char* key, char* out, size_t* length)
+{
+    if (g_mock_nvs_store_enabled) {
+        auto it = s_store.find(key);
+        if (it == s_store.end()) return ESP_ERR_NVS_NOT_FOUND;
+        if (it->second.type != "str") return ESP_ERR_NVS_TYPE_MISMATCH;
+        const std::vector<uint8_t>& data = it->second.data;
+        if (out == nullptr) {
+            *length = data.size();
+            return ESP_OK;
+        }
+        if (*length < data.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(out, data.data(), data.size());
+        *length = data.size();
+        return ESP_OK;
+    }
+    if (g_mock_nvs_get_blob_ok_calls > 0 && *length > 0) {
+        g_mock_nvs_get_blob_ok_calls--;
+        size_t copy_len = (*length - 1 < sizeof(g_mock_nvs_get_blob_data))
+                          ? *length - 1 : sizeof(g_mock_nvs_get_blob_data);
+        memcpy(out, g_mock_nvs_get_blob_data, copy_len);
+        out[copy_len] = '\0';
+        return ESP_OK;
+    }
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_commit(nvs_handle_t /*handle*/)
+{
+    g_mock_nvs_commit_calls++;
+    return g_mock_nvs_commit_ret;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t /*handle*/, const char* key)
+{
+    return s_store.erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t /*handle*/)
+{
+    s_store.clear();
+    return ESP_OK;
+}
+
 void      nvs_close(nvs_handle_t /*handle*/) {}
 
 // ── FreeRTOS mutex (single-threaded stubs) ──
@@ -139,31 +305,99 @@ SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t /*max*/, UBaseType_t /*in
     return std::malloc(1);
 }
 
-// ── FreeRTOS timers (v4 path is never called when IDF_VERSION_MAJOR >= 5) ──
+// ── FreeRTOS tasks (created but only run by mock_run_save_task()) ──
+
+static TaskFunction_t s_save_task_fn;
+static void*          s_save_task_arg;
+static std::jmp_buf   s_save_task_exit;
+static bool           s_save_task_running;
+static bool           s_save_task_woken;
+static int            s_save_task_polls;
+static TickType_t     s_save_task_wait;
+
+/** Where the library stored each task's handle, for mock_forget_task(). */
+static struct {
+    const char*   name;
+    TaskHandle_t* handle;
+} s_task_handles[4];
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name,
+                                   uint32_t /*stack_depth*/, void* arg,
+                                   UBaseType_t /*priority*/, TaskHandle_t* out_handle,
+                                   BaseType_t /*core_id*/)
+{
+    if (g_mock_task_create_ret != pdPASS) return g_mock_task_create_ret;
+    static int s_dummy_task;
+    *out_handle = &s_dummy_task;
+    for (auto& slot : s_task_handles) {
+        if (slot.name == nullptr || strcmp(slot.name, name) == 0) {
+            slot.name   = name;
+            slot.handle = out_handle;
+            break;
+        }
+    }
+    if (strcmp(name, "nvs_cfg_save") == 0) {
+        s_save_task_fn  = fn;
+        s_save_task_arg = arg;
+    }
+    return pdPASS;
+}
+
+void mock_forget_task(const char* name)
+{
+    for (auto& slot : s_task_handles) {
+        if (slot.name != nullptr && strcmp(slot.name, name) == 0) {
+            *slot.handle = nullptr;
+        }
+    }
+}
 
-TimerHandle_t xTimerCreate(const char* /*name*/, TickType_t /*period*/,
-                           UBaseType_t /*auto_reload*/, void* /*id*/,
-                           TimerCallbackFunction_t /*cb*/)
+TickType_t mock_run_save_task(int max_polls)
 {
-    return nullptr;
+    if (s_save_task_fn == nullptr) return portMAX_DELAY;
+    s_save_task_running = true;
+    s_save_task_woken   = false;
+    s_save_task_polls   = max_polls;
+    if (setjmp(s_save_task_exit) == 0) {
+        s_save_task_fn(s_save_task_arg);  // never returns; left through longjmp
+    }
+    s_save_task_running = false;
+    return s_save_task_wait;
 }
 
-BaseType_t xTimerStart(TimerHandle_t /*timer*/, TickType_t /*ticks*/)
+/** Leave the task body and return @p wait from mock_run_save_task(). */
+[[noreturn]] static void save_task_exit(TickType_t wait)
 {
-    return pdTRUE;
+    s_save_task_wait = wait;
+    std::longjmp(s_save_task_exit, 1);
 }
 
-// ── esp_timer (v5+ path) ──
+BaseType_t xTaskNotifyGive(TaskHandle_t /*task*/)
+{
+    g_mock_task_notify_count++;
+    return pdPASS;
+}
 
-esp_err_t esp_timer_create(const esp_timer_create_args_t* /*args*/,
-                           esp_timer_handle_t* out_handle)
+uint32_t ulTaskNotifyTake(BaseType_t /*clear_on_exit*/, TickType_t ticks)
 {
-    if (g_mock_esp_timer_create_ret != ESP_OK) return g_mock_esp_timer_create_ret;
-    *out_handle = std::malloc(1);
-    return ESP_OK;
+    if (s_save_task_running) {
+        if (!s_save_task_woken) {
+            s_save_task_woken = true;  // the wake-up mock_run_save_task() stands for
+            return 1;
+        }
+        save_task_exit(ticks);
+    }
+    return 0;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    if (s_save_task_running && --s_save_task_polls < 0) {
+        save_task_exit(0);
+    }
+    return g_mock_tick_count;
 }
 
-esp_err_t esp_timer_start_periodic(esp_timer_handle_t /*timer*/, uint64_t /*period_us*/)
+void vTaskDelay(TickType_t /*ticks*/)
 {
-    return g_mock_esp_timer_start_ret;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 #include "esp_err.h"
 
 typedef uint32_t nvs_handle_t;
@@ -12,7 +13,9 @@ typedef enum {
 
 /* Error codes used by NVS */
 #define ESP_ERR_NVS_BASE            ((esp_err_t) 0x1100)
+#define ESP_ERR_NVS_INVALID_LENGTH  ((esp_err_t)(ESP_ERR_NVS_BASE + 0x0c))
 #define ESP_ERR_NVS_NOT_FOUND       ((esp_err_t)(ESP_ERR_NVS_BASE + 0x0e))
+#define ESP_ERR_NVS_TYPE_MISMATCH   ((esp_err_t)(ESP_ERR_NVS_BASE + 0x03))
 #define ESP_ERR_NVS_NO_FREE_PAGES   ((esp_err_t)(ESP_ERR_NVS_BASE + 0x0d))
 #define ESP_ERR_NVS_NEW_VERSION_FOUND ((esp_err_t)(ESP_ERR_NVS_BASE + 0x10))
 
@@ -23,7 +26,26 @@ extern "C" {
 esp_err_t nvs_open(const char* name, nvs_open_mode_t open_mode, nvs_handle_t* out_handle);
 esp_err_t nvs_get_blob(nvs_handle_t c_handle, const char* key, void* out_value, size_t* length);
 esp_err_t nvs_set_blob(nvs_handle_t c_handle, const char* key, const void* value, size_t length);
+esp_err_t nvs_set_u8 (nvs_handle_t c_handle, const char* key, uint8_t value);
+esp_err_t nvs_set_i8 (nvs_handle_t c_handle, const char* key, int8_t value);
+esp_err_t nvs_set_u16(nvs_handle_t c_handle, const char* key, uint16_t value);
+esp_err_t nvs_set_i16(nvs_handle_t c_handle, const char* key, int16_t value);
+esp_err_t nvs_set_u32(nvs_handle_t c_handle, const char* key, uint32_t value);
+esp_err_t nvs_set_i32(nvs_handle_t c_handle, const char* key, int32_t value);
+esp_err_t nvs_set_u64(nvs_handle_t c_handle, const char* key, uint64_t value);
+esp_err_t nvs_set_i64(nvs_handle_t c_handle, const char* key, int64_t value);
+esp_err_t nvs_get_u8 (nvs_handle_t c_handle, const char* key, uint8_t* out_value);
+esp_err_t nvs_get_i8 (nvs_handle_t c_handle, const char* key, int8_t* out_value);
+esp_err_t nvs_get_u16(nvs_handle_t c_handle, const char* key, uint16_t* out_value);
+esp_err_t nvs_get_i16(nvs_handle_t c_handle, const char* key, int16_t* out_value);
+esp_err_t nvs_get_u32(nvs_handle_t c_handle, const char* key, uint32_t* out_value);
+esp_err_t nvs_get_i32(nvs_handle_t c_handle, const char* key, int32_t* out_value);
+esp_err_t nvs_get_u64(nvs_handle_t c_handle, const char* key, uint64_t* out_value);
+esp_err_t nvs_get_i64(nvs_handle_t c_handle, const char* key, int64_t* out_value);
+esp_err_t nvs_set_str(nvs_handle_t c_handle, const char* key, const char* value);
+esp_err_t nvs_get_str(nvs_handle_t c_handle, const char* key, char* out_value, size_t* length);
 esp_err_t nvs_commit(nvs_handle_t c_handle);
+esp_err_t nvs_erase_key(nvs_handle_t c_handle, const char* key);
 esp_err_t nvs_erase_all(nvs_handle_t c_handle);
 void      nvs_close(nvs_handle_t c_handle);
 
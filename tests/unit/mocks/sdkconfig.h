@@ -0,0 +1,59 @@
+#pragma once
+
+/* Host-side stand-in for the sdkconfig.h that ESP-IDF generates from Kconfig.
+ * Values mirror the Kconfig defaults; builds may pre-define any of them
+ * (e.g. -DCONFIG_NVS_CONFIG_LOCKFREE_GETTERS=0) to exercise another mode. */
+
+#ifndef CONFIG_NVS_CONFIG_LOCKFREE_GETTERS
+#define CONFIG_NVS_CONFIG_LOCKFREE_GETTERS 1
+#endif
+
+#ifndef CONFIG_NVS_CONFIG_SAVE_TASK_PRIORITY
+#define CONFIG_NVS_CONFIG_SAVE_TASK_PRIORITY 1
+#endif
+#ifndef CONFIG_NVS_CONFIG_SAVE_TASK_STACK_SIZE
+#define CONFIG_NVS_CONFIG_SAVE_TASK_STACK_SIZE 4096
+#endif
+#ifndef CONFIG_NVS_CONFIG_SAVE_TASK_CORE
+#define CONFIG_NVS_CONFIG_SAVE_TASK_CORE -1
+#endif
+#ifndef CONFIG_NVS_CONFIG_SAVE_QUIET_MS
+#define CONFIG_NVS_CONFIG_SAVE_QUIET_MS 2000
+#endif
+#ifndef CONFIG_NVS_CONFIG_SAVE_MAX_LATENCY_MS
+#define CONFIG_NVS_CONFIG_SAVE_MAX_LATENCY_MS 30000
+#endif
+#ifndef CONFIG_NVS_CONFIG_SAVE_DIRTY_BYTES
+#define CONFIG_NVS_CONFIG_SAVE_DIRTY_BYTES 4096
+#endif
+
+#ifndef CONFIG_NVS_CONFIG_ARRAY_CHUNK_SIZE
+#define CONFIG_NVS_CONFIG_ARRAY_CHUNK_SIZE 256
+#endif
+
+#ifndef CONFIG_NVS_CONFIG_MAX_CALLBACKS
+#define CONFIG_NVS_CONFIG_MAX_CALLBACKS 16
+#endif
+#ifndef CONFIG_NVS_CONFIG_CALLBACK_QUEUE_LEN
+#define CONFIG_NVS_CONFIG_CALLBACK_QUEUE_LEN 16
+#endif
+#ifndef CONFIG_NVS_CONFIG_CALLBACK_COALESCE_MS
+#define CONFIG_NVS_CONFIG_CALLBACK_COALESCE_MS 50
+#endif
+#ifndef CONFIG_NVS_CONFIG_CALLBACK_TASK_PRIORITY
+#define CONFIG_NVS_CONFIG_CALLBACK_TASK_PRIORITY 2
+#endif
+#ifndef CONFIG_NVS_CONFIG_CALLBACK_TASK_STACK_SIZE
+#define CONFIG_NVS_CONFIG_CALLBACK_TASK_STACK_SIZE 4096
+#endif
+
+#ifndef CONFIG_NVS_CONFIG_TYPED_SCALARS
+#define CONFIG_NVS_CONFIG_TYPED_SCALARS 1
+#endif
+
+/* CONFIG_NVS_CONFIG_STORAGE_PACKED, CONFIG_NVS_CONFIG_ARRAY_CHUNKED,
+ * CONFIG_NVS_CONFIG_LAYOUT_SORTED and CONFIG_NVS_CONFIG_GENERIC_ENGINE default
+ * to n and are left undefined, as ESP-IDF does for disabled bool options. */
+#ifndef CONFIG_NVS_CONFIG_PACKED_CHUNK_SIZE
+#define CONFIG_NVS_CONFIG_PACKED_CHUNK_SIZE 3968
+#endif
@@ -12,6 +12,9 @@ cmake --build "$BUILD_DIR" 2>/dev/null
 
 echo "==> Running tests..."
 "$BUILD_DIR/unit_tests"
+"$BUILD_DIR/unit_tests_packed"
+"$BUILD_DIR/unit_tests_chunked"
+"$BUILD_DIR/unit_tests_generic"
 
 echo "==> Generating coverage report..."
 cmake --build "$BUILD_DIR" --target coverage 2>/dev/null
@@ -4,6 +4,7 @@
  */
 
 #include "test_helpers.hpp"
+#include <cstdint>
 #include <cstring>
 
 // ── char[16] (DeviceName) ──
@@ -146,6 +147,77 @@ TEST_F(NvsTestFixture, Uint16ArrayBoundaryValues) {
     EXPECT_EQ(got[2], (uint16_t)32768);
 }
 
+// ── Element and range access ──
+
+TEST_F(NvsTestFixture, ArraySetElementTouchesOnlyThatElement) {
+    EXPECT_OK(Param_SetElementCalibPoints(2, 42));
+    size_t len;
+    const int32_t* cp = Param_GetCalibPoints(&len);
+    EXPECT_EQ(cp[1], (int32_t)-500);
+    EXPECT_EQ(cp[2], (int32_t)42);
+    EXPECT_EQ(cp[3], (int32_t)500);
+    EXPECT_TRUE(NvsConfig_FindParam("CalibPoints")->is_dirty());
+    EXPECT_FALSE(NvsConfig_FindParam("CalibPoints")->is_default());
+}
+
+TEST_F(NvsTestFixture, ArraySetRangeGetRangeRoundTrip) {
+    const uint16_t data[2] = {7, 9};
+    EXPECT_OK(Param_SetRangeRGBColor(1, data, 2));
+    uint16_t out[3] = {0};
+    EXPECT_OK(Param_GetRangeRGBColor(0, out, 3));
+    EXPECT_EQ(out[0], (uint16_t)255);
+    EXPECT_EQ(out[1], (uint16_t)7);
+    EXPECT_EQ(out[2], (uint16_t)9);
+    EXPECT_OK(Param_GetRangeRGBColor(2, out, 1));
+    EXPECT_EQ(out[0], (uint16_t)9);
+}
+
+TEST_F(NvsTestFixture, ArrayRangeOutOfBounds) {
+    const uint8_t data[2] = {1, 2};
+    uint8_t out[2];
+    EXPECT_ERR(Param_SetElementBytePattern(8, 1), ESP_ERR_INVALID_SIZE);
+    EXPECT_ERR(Param_SetRangeBytePattern(7, data, 2), ESP_ERR_INVALID_SIZE);
+    EXPECT_ERR(Param_GetRangeBytePattern(9, out, 0), ESP_ERR_INVALID_SIZE);
+    EXPECT_ERR(Param_GetRangeBytePattern(SIZE_MAX, out, 2), ESP_ERR_INVALID_SIZE);
+    EXPECT_OK(Param_GetRangeBytePattern(8, out, 0));
+}
+
+TEST_F(NvsTestFixture, ArraySetElementSameValueNoChange) {
+    uint32_t before = NvsConfig_GetWriteCount("BytePattern");
+    EXPECT_ERR(Param_SetElementBytePattern(0, 0xDE), ESP_ERR_INVALID_ARG);
+    EXPECT_EQ(NvsConfig_GetWriteCount("BytePattern"), before);
+}
+
+TEST_F(NvsTestFixture, ArraySetElementBackToDefault) {
+    EXPECT_OK(Param_SetElementBytePattern(3, 0x00));
+    EXPECT_OK(Param_SetElementBytePattern(5, 0x00));
+    EXPECT_OK(Param_SetElementBytePattern(3, 0xEF));
+    EXPECT_FALSE(NvsConfig_FindParam("BytePattern")->is_default());
+    EXPECT_OK(Param_SetElementBytePattern(5, 0xFE));
+    EXPECT_TRUE(NvsConfig_FindParam("BytePattern")->is_default());
+}
+
+// ── In-place reads (Acquire/Release) ──
+
+TEST_F(NvsTestFixture, ArrayAcquireReadsInPlace) {
+    size_t len = 0;
+    const int32_t* cp = Param_AcquireCalibPoints(&len);
+    size_t get_len;
+    EXPECT_TRUE(cp == Param_GetCalibPoints(&get_len));
+    EXPECT_EQ(len, (size_t)6);
+    EXPECT_EQ(cp[0], (int32_t)-1000);
+    EXPECT_EQ(cp[5], (int32_t)2000);
+    Param_ReleaseCalibPoints();
+}
+
+TEST_F(NvsTestFixture, ArrayAcquireSeesLatestSet) {
+    const uint16_t data[3] = {1, 2, 3};
+    EXPECT_OK(Param_SetRGBColor(data, 3));
+    const uint16_t* got = Param_AcquireRGBColor(nullptr);
+    EXPECT_MEMEQ(got, data, sizeof(data));
+    Param_ReleaseRGBColor();
+}
+
 // ── Error handling ──
 
 TEST_F(NvsTestFixture, ArrayOversizedLength) {
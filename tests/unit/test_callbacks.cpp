@@ -4,6 +4,8 @@
  */
 
 #include "test_helpers.hpp"
+#include "mock_control.h"
+#include "sdkconfig.h"
 #include <cstring>
 
 // ── Test state ──
@@ -100,3 +102,306 @@ TEST_F(CallbackFixture, GlobalAndPerParamBothFire) {
     EXPECT_EQ(s_global_cb_count, 1);
     EXPECT_EQ(s_per_param_count, 1);
 }
+
+TEST_F(CallbackFixture, RegisterByIndexFires) {
+    EXPECT_OK(NvsConfig_RegisterOnChangeByIndex(PARAM_INDEX_Brightness, per_param_callback, nullptr));
+    Param_SetLetter('Z');
+    EXPECT_EQ(s_per_param_count, 0);
+    Param_SetBrightness(42);
+    EXPECT_EQ(s_per_param_count, 1);
+    EXPECT_STREQ(s_last_cb_name, "Brightness");
+}
+
+TEST_F(CallbackFixture, RegisterByIndexRejectsOutOfRange) {
+    EXPECT_ERR(NvsConfig_RegisterOnChangeByIndex(PARAM_INDEX_COUNT, per_param_callback, nullptr),
+               ESP_ERR_INVALID_ARG);
+}
+
+TEST_F(CallbackFixture, RegisterUnknownNameFails) {
+    EXPECT_ERR(NvsConfig_RegisterOnChange("NonExistent", per_param_callback, nullptr), ESP_ERR_NOT_FOUND);
+    Param_SetBrightness(42);
+    EXPECT_EQ(s_per_param_count, 0);
+}
+
+static char s_order[8];
+static size_t s_order_len = 0;
+static void order_a(const char*, void*) { s_order[s_order_len++] = 'a'; }
+static void order_b(const char*, void*) { s_order[s_order_len++] = 'b'; }
+static void order_g(const char*, void*) { s_order[s_order_len++] = 'g'; }
+
+TEST_F(CallbackFixture, PerParamRunBeforeGlobalInRegistrationOrder) {
+    s_order_len = 0;
+    memset(s_order, 0, sizeof(s_order));
+    EXPECT_OK(NvsConfig_RegisterGlobalOnChange(order_g, nullptr));
+    EXPECT_OK(NvsConfig_RegisterOnChange("Brightness", order_a, nullptr));
+    EXPECT_OK(NvsConfig_RegisterOnChange("Letter", per_param_callback, nullptr));
+    EXPECT_OK(NvsConfig_RegisterOnChange("Brightness", order_b, nullptr));
+    Param_SetBrightness(42);
+    EXPECT_STREQ(s_order, "abg");
+    EXPECT_EQ(s_per_param_count, 0);
+}
+
+// ── Async delivery ──
+
+TEST_F(CallbackFixture, AsyncCallbackDeferredUntilDispatch) {
+    EXPECT_OK(NvsConfig_RegisterOnChangeAsync("Brightness", per_param_callback, nullptr));
+    Param_SetBrightness(42);
+    EXPECT_EQ(s_per_param_count, 0);
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_per_param_count, 1);
+    EXPECT_STREQ(s_last_cb_name, "Brightness");
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_per_param_count, 1);
+}
+
+TEST_F(CallbackFixture, AsyncBurstCoalescesToOneCall) {
+    EXPECT_OK(NvsConfig_RegisterOnChangeAsync("Brightness", per_param_callback, nullptr));
+    Param_SetBrightness(1);
+    Param_SetBrightness(2);
+    Param_SetBrightness(3);
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_per_param_count, 1);
+}
+
+TEST_F(CallbackFixture, SyncAndAsyncSubscribersMix) {
+    EXPECT_OK(NvsConfig_RegisterOnChange("Brightness", per_param_callback, nullptr));
+    EXPECT_OK(NvsConfig_RegisterOnChangeAsync(nullptr, global_callback, nullptr));
+    Param_SetBrightness(42);
+    EXPECT_EQ(s_per_param_count, 1);
+    EXPECT_EQ(s_global_cb_count, 0);
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_per_param_count, 1);
+    EXPECT_EQ(s_global_cb_count, 1);
+}
+
+TEST_F(CallbackFixture, AsyncQueueOverflowIsCounted) {
+    EXPECT_OK(NvsConfig_RegisterOnChangeAsync(nullptr, global_callback, nullptr));
+    // Change every parameter once; the test table has more parameters than queue slots.
+    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
+        const NvsConfigParamEntry_t* e = &g_nvsconfig_params[i];
+        uint8_t buf[64];
+        const size_t size = e->element_size * e->element_count;
+        EXPECT_OK(e->get(buf, size));
+        buf[0] ^= 1;
+        EXPECT_OK(e->set(buf, size));
+    }
+    const size_t queued = CONFIG_NVS_CONFIG_CALLBACK_QUEUE_LEN;
+    EXPECT_EQ(NvsConfig_GetCallbackOverflowCount(), (uint32_t)(g_nvsconfig_param_count - queued));
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_global_cb_count, (int)queued);
+}
+
+TEST_F(CallbackFixture, AsyncRegisterFailsWithoutDispatcher) {
+    mock_forget_task("nvs_cfg_cb");
+    g_mock_task_create_ret = pdFAIL;
+    EXPECT_ERR(NvsConfig_RegisterOnChangeAsync("Brightness", per_param_callback, nullptr), ESP_FAIL);
+    g_mock_task_create_ret = pdPASS;
+
+    Param_SetBrightness(42);
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_per_param_count, 0);
+    // The failed registration took none of the 16 slots
+    for (int i = 0; i < 16; i++) {
+        EXPECT_OK(NvsConfig_RegisterOnChange(nullptr, second_callback, nullptr));
+    }
+    EXPECT_ERR(NvsConfig_RegisterOnChange(nullptr, second_callback, nullptr), ESP_ERR_NO_MEM);
+
+    NvsConfig_ClearCallbacks();
+    EXPECT_OK(NvsConfig_RegisterOnChangeAsync("Brightness", per_param_callback, nullptr));
+    Param_SetBrightness(43);
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_per_param_count, 1);
+}
+
+TEST_F(CallbackFixture, ClearCallbacksDropsQueuedNotifications) {
+    EXPECT_OK(NvsConfig_RegisterOnChangeAsync("Brightness", per_param_callback, nullptr));
+    Param_SetBrightness(42);
+    NvsConfig_ClearCallbacks();
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_per_param_count, 0);
+}
+
+// ── Subscriptions ──
+
+TEST_F(CallbackFixture, UnsubscribeStopsCallback) {
+    NvsConfigSubscription_t sub = NVS_CONFIG_SUBSCRIPTION_NONE;
+    EXPECT_OK(NvsConfig_Subscribe("Brightness", per_param_callback, nullptr, 0, &sub));
+    EXPECT_TRUE(sub != NVS_CONFIG_SUBSCRIPTION_NONE);
+    Param_SetBrightness(1);
+    EXPECT_OK(NvsConfig_Unsubscribe(sub));
+    Param_SetBrightness(2);
+    EXPECT_EQ(s_per_param_count, 1);
+}
+
+TEST_F(CallbackFixture, UnsubscribeTwiceOrBadHandleFails) {
+    NvsConfigSubscription_t sub = NVS_CONFIG_SUBSCRIPTION_NONE;
+    EXPECT_OK(NvsConfig_Subscribe(nullptr, global_callback, nullptr, 0, &sub));
+    EXPECT_OK(NvsConfig_Unsubscribe(sub));
+    EXPECT_ERR(NvsConfig_Unsubscribe(sub), ESP_ERR_NOT_FOUND);
+    EXPECT_ERR(NvsConfig_Unsubscribe(NVS_CONFIG_SUBSCRIPTION_NONE), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_Subscribe(nullptr, nullptr, nullptr, 0, &sub), ESP_ERR_INVALID_ARG);
+}
+
+TEST_F(CallbackFixture, UnsubscribedSlotIsReused) {
+    NvsConfigSubscription_t subs[CONFIG_NVS_CONFIG_MAX_CALLBACKS];
+    for (int i = 0; i < CONFIG_NVS_CONFIG_MAX_CALLBACKS; i++) {
+        EXPECT_OK(NvsConfig_Subscribe(nullptr, second_callback, nullptr, 0, &subs[i]));
+    }
+    EXPECT_ERR(NvsConfig_RegisterGlobalOnChange(global_callback, nullptr), ESP_ERR_NO_MEM);
+
+    EXPECT_OK(NvsConfig_Unsubscribe(subs[3]));
+    NvsConfigSubscription_t again = NVS_CONFIG_SUBSCRIPTION_NONE;
+    EXPECT_OK(NvsConfig_Subscribe(nullptr, global_callback, nullptr, 0, &again));
+    // Same slot, new handle: the stale one must not remove the new subscription
+    EXPECT_TRUE(again != subs[3]);
+    EXPECT_ERR(NvsConfig_Unsubscribe(subs[3]), ESP_ERR_NOT_FOUND);
+
+    Param_SetLetter('Z');
+    EXPECT_EQ(s_global_cb_count, 1);
+    EXPECT_EQ(s_second_cb_count, CONFIG_NVS_CONFIG_MAX_CALLBACKS - 1);
+}
+
+static NvsConfigSubscription_t s_self_sub;
+static NvsConfigSubscription_t s_victim_sub;
+
+static void unsubscribing_callback(const char*, void*) {
+    s_global_cb_count++;
+    NvsConfig_Unsubscribe(s_self_sub);
+    NvsConfig_Unsubscribe(s_victim_sub);
+}
+
+TEST_F(CallbackFixture, UnsubscribeFromInsideCallback) {
+    EXPECT_OK(NvsConfig_Subscribe("Brightness", unsubscribing_callback, nullptr, 0, &s_self_sub));
+    EXPECT_OK(NvsConfig_Subscribe("Brightness", per_param_callback, nullptr, 0, &s_victim_sub));
+    EXPECT_OK(NvsConfig_RegisterGlobalOnChange(second_callback, nullptr));
+    Param_SetBrightness(1);
+    // The victim was removed before the walk reached it; the walk still finished
+    EXPECT_EQ(s_global_cb_count, 1);
+    EXPECT_EQ(s_per_param_count, 0);
+    EXPECT_EQ(s_second_cb_count, 1);
+    Param_SetBrightness(2);
+    EXPECT_EQ(s_global_cb_count, 1);
+    EXPECT_EQ(s_second_cb_count, 2);
+}
+
+TEST_F(CallbackFixture, SubscribeAsyncFlag) {
+    EXPECT_OK(NvsConfig_Subscribe("Brightness", per_param_callback, nullptr, NVS_CONFIG_SUBSCRIBE_ASYNC, nullptr));
+    Param_SetBrightness(42);
+    EXPECT_EQ(s_per_param_count, 0);
+    NvsConfig_DispatchPending();
+    EXPECT_EQ(s_per_param_count, 1);
+}
+
+// ── Value subscribers ──
+
+static NvsConfigChange_t s_change;
+static uint8_t s_change_old[64];
+static uint8_t s_change_new[64];
+static int s_value_cb_count = 0;
+
+static void value_callback(const NvsConfigChange_t* change, void*) {
+    s_value_cb_count++;
+    s_change = *change;
+    if (change->old_value != nullptr) {
+        memcpy(s_change_old, change->old_value, change->count * change->element_size);
+        memcpy(s_change_new, change->new_value, change->count * change->element_size);
+    }
+}
+
+static void subscribe_values_callback(const char*, void*) {
+    NvsConfig_SubscribeValues("CalibPoints", value_callback, nullptr, nullptr);
+}
+
+TEST_F(CallbackFixture, ValueCallbackCarriesOldAndNewScalar) {
+    s_value_cb_count = 0;
+    EXPECT_OK(NvsConfig_SubscribeValues("CalibOffset", value_callback, nullptr, nullptr));
+    const int32_t before = Param_GetCalibOffset();
+    Param_SetCalibOffset(1234);
+    EXPECT_EQ(s_value_cb_count, 1);
+    EXPECT_EQ(s_change.index, PARAM_INDEX_CalibOffset);
+    EXPECT_STREQ(s_change.name, "CalibOffset");
+    EXPECT_EQ(s_change.first, (size_t)0);
+    EXPECT_EQ(s_change.count, (size_t)1);
+    int32_t old_v, new_v;
+    memcpy(&old_v, s_change_old, sizeof(old_v));
+    memcpy(&new_v, s_change_new, sizeof(new_v));
+    EXPECT_EQ(old_v, before);
+    EXPECT_EQ(new_v, 1234);
+}
+
+TEST_F(CallbackFixture, ValueCallbackReportsChangedArrayRange) {
+    s_value_cb_count = 0;
+    EXPECT_OK(NvsConfig_SubscribeValues("CalibPoints", value_callback, nullptr, nullptr));
+    // Default: {-1000, -500, 0, 500, 1000, 2000}; change elements 1 and 3
+    const int32_t pts[6] = {-1000, -400, 0, 600, 1000, 2000};
+    EXPECT_OK(Param_SetCalibPoints(pts, 6));
+    EXPECT_EQ(s_value_cb_count, 1);
+    EXPECT_EQ(s_change.first, (size_t)1);
+    EXPECT_EQ(s_change.count, (size_t)3);
+    EXPECT_EQ(s_change.element_size, sizeof(int32_t));
+    const int32_t* o = reinterpret_cast<const int32_t*>(s_change_old);
+    const int32_t* n = reinterpret_cast<const int32_t*>(s_change_new);
+    EXPECT_EQ(o[0], -500);
+    EXPECT_EQ(o[2], 500);
+    EXPECT_EQ(n[0], -400);
+    EXPECT_EQ(n[2], 600);
+}
+
+TEST_F(CallbackFixture, ValueCallbackReportsSetElementIndex) {
+    s_value_cb_count = 0;
+    EXPECT_OK(NvsConfig_SubscribeValues("CalibPoints", value_callback, nullptr, nullptr));
+    EXPECT_OK(Param_SetElementCalibPoints(4, 1111));
+    EXPECT_EQ(s_value_cb_count, 1);
+    EXPECT_EQ(s_change.first, (size_t)4);
+    EXPECT_EQ(s_change.count, (size_t)1);
+    EXPECT_EQ(reinterpret_cast<const int32_t*>(s_change_old)[0], 1000);
+    EXPECT_EQ(reinterpret_cast<const int32_t*>(s_change_new)[0], 1111);
+}
+
+TEST_F(CallbackFixture, ValueCallbackLargeRangeAndTransaction) {
+    s_value_cb_count = 0;
+    EXPECT_OK(NvsConfig_SubscribeValues(nullptr, value_callback, nullptr, nullptr));
+    const int32_t pts[6] = {1, 2, 3, 4, 5, 6};  // 24 bytes: exceeds the inline buffer
+    const uint8_t level = 7;
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "CalibPoints", pts, sizeof(pts)));
+    EXPECT_OK(NvsConfig_TxnSet(txn, "Brightness", &level, sizeof(level)));
+    EXPECT_OK(NvsConfig_Commit(txn));
+    EXPECT_EQ(s_value_cb_count, 2);
+    // Last notification is CalibPoints (higher index than Brightness)
+    EXPECT_EQ(s_change.index, PARAM_INDEX_CalibPoints);
+    EXPECT_EQ(s_change.first, (size_t)0);
+    EXPECT_EQ(s_change.count, (size_t)6);
+    EXPECT_EQ(reinterpret_cast<const int32_t*>(s_change_old)[5], 2000);
+    EXPECT_EQ(reinterpret_cast<const int32_t*>(s_change_new)[5], 6);
+}
+
+TEST_F(CallbackFixture, ValueAndNameSubscribersCoexist) {
+    s_value_cb_count = 0;
+    EXPECT_OK(NvsConfig_RegisterOnChange("Brightness", per_param_callback, nullptr));
+    NvsConfigSubscription_t sub = NVS_CONFIG_SUBSCRIPTION_NONE;
+    EXPECT_OK(NvsConfig_SubscribeValues("Brightness", value_callback, nullptr, &sub));
+    Param_SetBrightness(9);
+    EXPECT_EQ(s_per_param_count, 1);
+    EXPECT_EQ(s_value_cb_count, 1);
+    EXPECT_OK(NvsConfig_Unsubscribe(sub));
+    Param_SetBrightness(10);
+    EXPECT_EQ(s_per_param_count, 2);
+    EXPECT_EQ(s_value_cb_count, 1);
+    EXPECT_ERR(NvsConfig_SubscribeValues("NonExistent", value_callback, nullptr, nullptr), ESP_ERR_NOT_FOUND);
+}
+
+/** A change made before its value subscriber registered is still delivered, without values. */
+TEST_F(CallbackFixture, ValueCallbackWithoutCaptureGetsWholeParameter) {
+    s_value_cb_count = 0;
+    EXPECT_OK(NvsConfig_RegisterOnChange("CalibPoints", subscribe_values_callback, nullptr));
+    const int32_t pts[6] = {1, 2, 7, 4, 5, 6};
+    EXPECT_OK(Param_SetCalibPoints(pts, 6));
+    EXPECT_EQ(s_value_cb_count, 1);
+    EXPECT_EQ(s_change.index, PARAM_INDEX_CalibPoints);
+    EXPECT_EQ(s_change.first, (size_t)0);
+    EXPECT_EQ(s_change.count, (size_t)6);
+    EXPECT_EQ(s_change.element_size, sizeof(int32_t));
+    EXPECT_TRUE(s_change.old_value == nullptr);
+    EXPECT_TRUE(s_change.new_value == nullptr);
+}
@@ -0,0 +1,145 @@
+/**
+ * @file test_chunked_storage.cpp
+ * @brief Tests for chunked storage of large arrays
+ *        (CONFIG_NVS_CONFIG_ARRAY_CHUNKED).
+ *
+ * Built into the separate unit_tests_chunked binary with an 8-byte chunk
+ * size, so CalibPoints (int32_t[6], 24 bytes) is stored as three chunks while
+ * BytePattern (8 bytes) keeps its single per-key blob.
+ */
+
+#include "test_helpers.hpp"
+#include "mock_control.h"
+#include "nvs.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+/* Mirrors the chunk key scheme in nvs_config.c */
+static const char* chunk_key(const char* name, unsigned chunk)
+{
+    static char key[16];
+    uint32_t h = 2166136261u;
+    for (const char* p = name; *p != '\0'; p++) {
+        h = (h ^ (uint8_t)*p) * 16777619u;
+    }
+    snprintf(key, sizeof(key), "_c%08" PRIx32 "%u", h, chunk);
+    return key;
+}
+
+static void erase_blob(const char* key)
+{
+    nvs_handle_t h;
+    nvs_open("param_storage", NVS_READWRITE, &h);
+    nvs_erase_key(h, key);
+    nvs_close(h);
+}
+
+TEST_GROUP(ChunkedStorageFixture)
+{
+    void setup()
+    {
+        nvs_store_setup();
+        NvsConfig_SecureLevelChange(1);
+    }
+    void teardown()
+    {
+        nvs_store_teardown();
+    }
+};
+
+/** Large arrays are stored as chunks, small ones under their name. */
+TEST(ChunkedStorageFixture, FirstSaveWritesChunks)
+{
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(mock_nvs_store_size("CalibPoints"), (size_t)0);
+    EXPECT_EQ(mock_nvs_store_size(chunk_key("CalibPoints", 0)), (size_t)8);
+    EXPECT_EQ(mock_nvs_store_size(chunk_key("CalibPoints", 2)), (size_t)8);
+    EXPECT_EQ(mock_nvs_store_size(chunk_key("CalibPoints", 3)), (size_t)0);
+    EXPECT_EQ(mock_nvs_store_size("BytePattern"), (size_t)8);
+}
+
+/** Changing one element rewrites only the chunk that holds it. */
+TEST(ChunkedStorageFixture, SetElementRewritesOneChunk)
+{
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_OK(Param_SetElementCalibPoints(4, 4444));
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 1);
+    EXPECT_FALSE(NvsConfig_FindParam("CalibPoints")->is_dirty());
+}
+
+/** Chunks are reassembled by the next Init. */
+TEST(ChunkedStorageFixture, ValuesSurviveReboot)
+{
+    const int32_t pts[6] = {1, 2, 3, 4, 5, 6};
+    EXPECT_OK(Param_SetCalibPoints(pts, 6));
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_OK(Param_SetElementCalibPoints(5, 66));
+    NvsConfig_SaveDirtyParameters();
+
+    g_nvsconfig_controller.CalibPoints.value[0] = 0;
+    EXPECT_OK(NvsConfig_Init());
+
+    int32_t out[6];
+    EXPECT_OK(Param_GetRangeCalibPoints(0, out, 6));
+    EXPECT_EQ(out[0], (int32_t)1);
+    EXPECT_EQ(out[4], (int32_t)5);
+    EXPECT_EQ(out[5], (int32_t)66);
+    EXPECT_FALSE(NvsConfig_FindParam("CalibPoints")->is_dirty());
+}
+
+/** A whole-array blob from firmware without chunking is read and rewritten in chunks. */
+TEST(ChunkedStorageFixture, MigratesWholeBlob)
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+    const int32_t pts[6] = {-6, -5, -4, -3, -2, -1};
+    store_blob("CalibPoints", pts, sizeof(pts));
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetCalibPoints(nullptr)[3], (int32_t)-3);
+    EXPECT_TRUE(NvsConfig_FindParam("CalibPoints")->is_dirty());
+
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(mock_nvs_store_size("CalibPoints"), (size_t)0);
+    EXPECT_EQ(mock_nvs_store_size(chunk_key("CalibPoints", 1)), (size_t)8);
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetCalibPoints(nullptr)[3], (int32_t)-3);
+}
+
+/** A missing chunk resets the array to its default and rewrites it. */
+TEST(ChunkedStorageFixture, MissingChunkUsesDefaults)
+{
+    EXPECT_OK(Param_SetElementCalibPoints(0, 7));
+    NvsConfig_SaveDirtyParameters();
+    erase_blob(chunk_key("CalibPoints", 1));
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetCalibPoints(nullptr)[0], (int32_t)-1000);
+    EXPECT_TRUE(NvsConfig_FindParam("CalibPoints")->is_dirty());
+
+    /* Dirty as a whole: a later element change must not narrow the rewrite */
+    EXPECT_OK(Param_SetElementCalibPoints(5, 9));
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(mock_nvs_store_size(chunk_key("CalibPoints", 1)), (size_t)8);
+}
+
+/** A chunk that fails to write leaves the array dirty until a save succeeds. */
+TEST(ChunkedStorageFixture, FailedChunkWriteKeepsDirty)
+{
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_OK(Param_SetElementCalibPoints(2, 22));
+    g_mock_nvs_set_blob_ret = ESP_FAIL;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_TRUE(NvsConfig_FindParam("CalibPoints")->is_dirty());
+
+    g_mock_nvs_set_blob_ret = ESP_OK;
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 1);
+    EXPECT_FALSE(NvsConfig_FindParam("CalibPoints")->is_dirty());
+}
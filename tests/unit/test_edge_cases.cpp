@@ -65,21 +65,21 @@ TEST_F(NvsTestFixture, ExplicitSave) {
     Param_SetBrightness(42);
     NvsConfig_SaveDirtyParameters();
     // After save, dirty flags should be cleared
-    EXPECT_FALSE(g_nvsconfig_controller.Letter.is_dirty);
-    EXPECT_FALSE(g_nvsconfig_controller.Brightness.is_dirty);
+    EXPECT_FALSE(NvsConfig_FindParam("Letter")->is_dirty());
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
 }
 
 TEST_F(NvsTestFixture, DirtyFlagSetOnChange) {
     Param_SetLetter('Z');
-    EXPECT_TRUE(g_nvsconfig_controller.Letter.is_dirty);
-    EXPECT_FALSE(g_nvsconfig_controller.Letter.is_default);
+    EXPECT_TRUE(NvsConfig_FindParam("Letter")->is_dirty());
+    EXPECT_FALSE(NvsConfig_FindParam("Letter")->is_default());
 }
 
 TEST_F(NvsTestFixture, IsDefaultFlagOnReset) {
     Param_SetLetter('Z');
-    EXPECT_FALSE(g_nvsconfig_controller.Letter.is_default);
+    EXPECT_FALSE(NvsConfig_FindParam("Letter")->is_default());
     Param_ResetLetter();
-    EXPECT_TRUE(g_nvsconfig_controller.Letter.is_default);
+    EXPECT_TRUE(NvsConfig_FindParam("Letter")->is_default());
 }
 
 // ── Array edge cases ──
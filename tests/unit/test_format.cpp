@@ -0,0 +1,171 @@
+/**
+ * @file test_format.cpp
+ * @brief Tests for the number formatters behind Param_Print* (nvs_format.c).
+ *
+ * Integers are compared with printf(); float and double output must read
+ * back to the same bits and be no longer than the shortest "%.*e" that does.
+ */
+
+#include "test_helpers.hpp"
+#include "nvs_format.h"
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+/** Significant digits in a "%g"-style number, trailing zeros of an integer excluded. */
+static int significant_digits(const char* s)
+{
+    if (*s == '-') s++;
+    const char* e = strchr(s, 'e');
+    const size_t end = e ? (size_t)(e - s) : strlen(s);
+    int count = 0, zeros = 0;
+    bool started = false;
+    for (size_t i = 0; i < end; i++) {
+        if (s[i] == '.') continue;
+        if (s[i] != '0') started = true;
+        if (!started) continue;
+        count++;
+        zeros = (s[i] == '0') ? zeros + 1 : 0;
+    }
+    return count - zeros;
+}
+
+/** Digits of the shortest "%.*e" that reads back to @p v. */
+template <typename T>
+static int shortest_digits(T v)
+{
+    char buf[40];
+    const int max = std::numeric_limits<T>::max_digits10;
+    for (int p = 1; p < max; p++) {
+        snprintf(buf, sizeof(buf), "%.*e", p - 1, (double)v);
+        const T back = sizeof(T) == sizeof(float) ? (T)strtof(buf, nullptr) : (T)strtod(buf, nullptr);
+        if (back == v) {
+            return p;
+        }
+    }
+    return max;
+}
+
+static uint64_t s_rng = 0x9E3779B97F4A7C15ull;
+
+static uint64_t next_random()
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 7;
+    s_rng ^= s_rng << 17;
+    return s_rng;
+}
+
+TEST_GROUP(FormatFixture)
+{
+};
+
+/** Integer formatters match printf at the limits of every width. */
+TEST(FormatFixture, IntegersMatchPrintf)
+{
+    char buf[32], ref[32];
+    const int64_t i64[] = {INT64_MIN, INT64_MIN + 1, -4294967296LL, -1, 0, 9, 10, 99, 100,
+                           4294967295LL, 4294967296LL, 1000000000000000000LL, INT64_MAX};
+    for (int64_t v : i64) {
+        snprintf(ref, sizeof(ref), "%" PRId64, v);
+        EXPECT_EQ(_nvsconfig_format_i64(v, buf, sizeof(buf)), (int)strlen(ref));
+        EXPECT_STREQ(buf, ref);
+    }
+    _nvsconfig_format_u64(UINT64_MAX, buf, sizeof(buf));
+    EXPECT_STREQ(buf, "18446744073709551615");
+    _nvsconfig_format_i32(INT32_MIN, buf, sizeof(buf));
+    EXPECT_STREQ(buf, "-2147483648");
+    _nvsconfig_format_u32(UINT32_MAX, buf, sizeof(buf));
+    EXPECT_STREQ(buf, "4294967295");
+
+    for (int i = 0; i < 10000; i++) {
+        const uint64_t v = next_random() >> (next_random() % 64);
+        snprintf(ref, sizeof(ref), "%" PRIu64, v);
+        _nvsconfig_format_u64(v, buf, sizeof(buf));
+        EXPECT_STREQ(buf, ref);
+    }
+}
+
+/** Short buffers are truncated and terminated; the full length is returned. */
+TEST(FormatFixture, TruncatesLikeSnprintf)
+{
+    char buf[4];
+    EXPECT_EQ(_nvsconfig_format_i32(-123456, buf, sizeof(buf)), 7);
+    EXPECT_STREQ(buf, "-12");
+    EXPECT_EQ(_nvsconfig_format_double(-122.419418, buf, sizeof(buf)), 11);
+    EXPECT_STREQ(buf, "-12");
+    EXPECT_EQ(_nvsconfig_format_char('A', buf, 1), 1);
+    EXPECT_EQ(buf[0], '\0');
+    EXPECT_EQ(_nvsconfig_format_u32(42, nullptr, 0), 2);
+}
+
+/** Known values print as the shortest digits, in "%g" notation. */
+TEST(FormatFixture, FloatAndDoubleDigits)
+{
+    const struct { float v; const char* s; } floats[] = {
+        {-40.5f, "-40.5"}, {0.1f, "0.1"}, {1.0f / 3, "0.33333334"}, {100.0f, "100"},
+        {9999.99f, "9999.99"}, {16777216.0f, "16777216"}, {1e9f, "1e+09"},
+        {1e-4f, "0.0001"}, {1e-5f, "1e-05"}, {3.4028235e38f, "3.4028235e+38"},
+        {1.4e-45f, "1e-45"}, {0.0f, "0"}, {-0.0f, "-0"},
+    };
+    char buf[32];
+    for (const auto& f : floats) {
+        _nvsconfig_format_float(f.v, buf, sizeof(buf));
+        EXPECT_STREQ(buf, f.s);
+    }
+
+    const struct { double v; const char* s; } doubles[] = {
+        {-122.419418, "-122.419418"}, {0.1, "0.1"}, {1e16, "10000000000000000"},
+        {1e17, "1e+17"}, {5e-324, "5e-324"},
+        {-2.2250738585072014e-308, "-2.2250738585072014e-308"},
+    };
+    for (const auto& d : doubles) {
+        EXPECT_EQ(_nvsconfig_format_double(d.v, buf, sizeof(buf)), (int)strlen(d.s));
+        EXPECT_STREQ(buf, d.s);
+    }
+    EXPECT_GE((size_t)NVS_FORMAT_MAX_LEN, strlen("-2.2250738585072014e-308"));
+}
+
+TEST(FormatFixture, NonFiniteValues)
+{
+    char buf[8];
+    _nvsconfig_format_float(std::numeric_limits<float>::infinity(), buf, sizeof(buf));
+    EXPECT_STREQ(buf, "inf");
+    _nvsconfig_format_double(-std::numeric_limits<double>::infinity(), buf, sizeof(buf));
+    EXPECT_STREQ(buf, "-inf");
+    _nvsconfig_format_float(std::nanf(""), buf, sizeof(buf));
+    EXPECT_STREQ(buf, "nan");
+}
+
+/** Random bit patterns read back exactly; float is always the shortest string. */
+TEST(FormatFixture, RandomValuesRoundTrip)
+{
+    char buf[32];
+    int longer = 0;
+    for (int i = 0; i < 20000; i++) {
+        const uint32_t fbits = (uint32_t)next_random();
+        float f;
+        memcpy(&f, &fbits, sizeof(f));
+        if (std::isfinite(f) && f != 0.0f) {
+            _nvsconfig_format_float(f, buf, sizeof(buf));
+            const float f_back = strtof(buf, nullptr);
+            EXPECT_EQ(memcmp(&f, &f_back, sizeof(f)), 0);
+            EXPECT_EQ(significant_digits(buf), shortest_digits(f));
+        }
+
+        const uint64_t dbits = next_random();
+        double d;
+        memcpy(&d, &dbits, sizeof(d));
+        if (std::isfinite(d) && d != 0.0) {
+            _nvsconfig_format_double(d, buf, sizeof(buf));
+            const double d_back = strtod(buf, nullptr);
+            EXPECT_EQ(memcmp(&d, &d_back, sizeof(d)), 0);
+            longer += significant_digits(buf) > shortest_digits(d);
+        }
+    }
+    /* Grisu2 misses the shortest double for about 0.1% of values */
+    EXPECT_GT(100, longer);
+}
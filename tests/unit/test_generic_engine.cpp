@@ -0,0 +1,218 @@
+/**
+ * @file test_generic_engine.cpp
+ * @brief Tests for the table-driven getters and setters
+ *        (CONFIG_NVS_CONFIG_GENERIC_ENGINE).
+ *
+ * Built into the separate unit_tests_generic binary, together with the
+ * scalar, print, security, snapshot and versioning tests, which run
+ * unchanged against the inline Param_* wrappers. The tests here cover
+ * arrays, strings and the *ByIndex functions, which replace the registry
+ * function pointers in this mode.
+ */
+
+#include "test_helpers.hpp"
+#include "mock_control.h"
+#include <cstring>
+#include <string>
+
+static int s_cb_count;
+static size_t s_cb_first;
+static size_t s_cb_count_elems;
+
+static void range_callback(const NvsConfigChange_t* change, void* /*user_data*/)
+{
+    s_cb_count++;
+    s_cb_first = change->first;
+    s_cb_count_elems = change->count;
+}
+
+TEST_GROUP(GenericEngineFixture)
+{
+    void setup()
+    {
+        nvs_store_setup();
+    }
+    void teardown()
+    {
+        nvs_store_teardown();
+    }
+};
+
+/** Whole-array set reports unchanged values and tracks the default state. */
+TEST(GenericEngineFixture, ArraySetAndReset)
+{
+    const uint16_t color[3] = {1, 2, 3};
+    EXPECT_OK(Param_SetRGBColor(color, 3));
+    EXPECT_ERR(Param_SetRGBColor(color, 3), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(Param_SetRGBColor(color, 4), ESP_ERR_INVALID_SIZE);
+    EXPECT_FALSE(NvsConfig_IsDefaultByIndex(PARAM_INDEX_RGBColor));
+    EXPECT_TRUE(NvsConfig_IsDirtyByIndex(PARAM_INDEX_RGBColor));
+
+    size_t len = 0;
+    const uint16_t* value = Param_GetRGBColor(&len);
+    EXPECT_EQ(len, (size_t)3);
+    EXPECT_EQ(value[2], (uint16_t)3);
+
+    EXPECT_OK(Param_ResetRGBColor());
+    EXPECT_ERR(Param_ResetRGBColor(), ESP_FAIL);
+    EXPECT_TRUE(NvsConfig_IsDefaultByIndex(PARAM_INDEX_RGBColor));
+    EXPECT_EQ(Param_GetRGBColor(nullptr)[0], (uint16_t)255);
+}
+
+/** Range and element writes check bounds and report the changed elements. */
+TEST(GenericEngineFixture, RangeWritesAndReads)
+{
+    NvsConfigSubscription_t sub;
+    s_cb_count = 0;
+    EXPECT_OK(NvsConfig_SubscribeValues("CalibPoints", range_callback, nullptr, &sub));
+
+    const int32_t pts[2] = {7, 8};
+    EXPECT_OK(Param_SetRangeCalibPoints(3, pts, 2));
+    EXPECT_EQ(s_cb_count, 1);
+    EXPECT_EQ(s_cb_first, (size_t)3);
+    EXPECT_EQ(s_cb_count_elems, (size_t)2);
+    EXPECT_ERR(Param_SetRangeCalibPoints(5, pts, 2), ESP_ERR_INVALID_SIZE);
+    EXPECT_ERR(Param_SetElementCalibPoints(3, 7), ESP_ERR_INVALID_ARG);
+
+    int32_t out[3];
+    EXPECT_OK(Param_GetRangeCalibPoints(2, out, 3));
+    EXPECT_EQ(out[0], (int32_t)0);
+    EXPECT_EQ(out[1], (int32_t)7);
+    EXPECT_EQ(out[2], (int32_t)8);
+    EXPECT_ERR(Param_GetRangeCalibPoints(4, out, 3), ESP_ERR_INVALID_SIZE);
+
+    /* Writing the defaults back makes the array default again */
+    const int32_t defaults[2] = {500, 1000};
+    EXPECT_OK(Param_SetRangeCalibPoints(3, defaults, 2));
+    EXPECT_TRUE(NvsConfig_IsDefaultByIndex(PARAM_INDEX_CalibPoints));
+    EXPECT_OK(NvsConfig_Unsubscribe(sub));
+}
+
+/** Copy needs the whole array; Acquire holds the value until Release. */
+TEST(GenericEngineFixture, CopyAndAcquire)
+{
+    uint8_t buf[8];
+    EXPECT_ERR(Param_CopyBytePattern(buf, 7), ESP_ERR_INVALID_SIZE);
+    EXPECT_OK(Param_CopyBytePattern(buf, sizeof(buf)));
+    EXPECT_EQ(buf[0], (uint8_t)0xDE);
+
+    size_t len = 0;
+    const uint8_t* p = Param_AcquireBytePattern(&len);
+    EXPECT_EQ(len, (size_t)8);
+    EXPECT_EQ(p[7], (uint8_t)0xBE);
+    Param_ReleaseBytePattern();
+}
+
+/** Strings keep their length, read in place under Acquire, and print without a format string. */
+TEST(GenericEngineFixture, StringSetGetPrint)
+{
+    EXPECT_ERR(Param_SetHostname("nvs-node"), ESP_ERR_INVALID_ARG);
+    EXPECT_OK(Param_SetHostname("edge"));
+    size_t len = 0;
+    EXPECT_STREQ(Param_GetHostname(&len), "edge");
+    EXPECT_EQ(len, (size_t)4);
+    EXPECT_ERR(Param_SetHostname(std::string(32, 'x').c_str()), ESP_ERR_INVALID_SIZE);
+
+    const char* p = Param_AcquireHostname(&len);
+    EXPECT_STREQ(p, "edge");
+    EXPECT_EQ(len, (size_t)4);
+    Param_ReleaseHostname();
+
+    char buf[8];
+    EXPECT_ERR(Param_CopyHostname(buf, 4), ESP_ERR_INVALID_SIZE);
+    EXPECT_OK(Param_CopyHostname(buf, 5));
+    EXPECT_EQ(Param_PrintHostname(buf, 3), 4);
+    EXPECT_STREQ(buf, "ed");
+
+    EXPECT_OK(Param_ResetHostname());
+    EXPECT_STREQ(Param_GetHostname(&len), "nvs-node");
+    EXPECT_EQ(len, (size_t)8);
+}
+
+/** Array print matches the generated code, truncation included. */
+TEST(GenericEngineFixture, ArrayPrint)
+{
+    char buf[64];
+    EXPECT_EQ(Param_PrintRGBColor(buf, sizeof(buf)), 11);
+    EXPECT_STREQ(buf, "[255,128,0]");
+    EXPECT_EQ(Param_PrintRGBColor(buf, 6), 6);
+    EXPECT_STREQ(buf, "[255,");
+    EXPECT_EQ(NvsConfig_PrintByIndex(PARAM_INDEX_COUNT, buf, sizeof(buf)), -1);
+}
+
+/** ByIndex set and get follow the registry size rules for every kind. */
+TEST(GenericEngineFixture, ByIndexSizeRules)
+{
+    const uint32_t serial = 7;
+    EXPECT_OK(NvsConfig_SetByIndex(PARAM_INDEX_SerialNum, &serial, sizeof(serial)));
+    EXPECT_ERR(NvsConfig_SetByIndex(PARAM_INDEX_SerialNum, &serial, 2), ESP_ERR_INVALID_SIZE);
+    uint32_t serial_out = 0;
+    EXPECT_OK(NvsConfig_GetByIndex(PARAM_INDEX_SerialNum, &serial_out, sizeof(serial_out)));
+    EXPECT_EQ(serial_out, (uint32_t)7);
+
+    /* Partial array write zero-fills the rest and warns */
+    const uint16_t two[2] = {9, 9};
+    EXPECT_ERR(NvsConfig_SetByIndex(PARAM_INDEX_RGBColor, two, sizeof(two)), ESP_ERR_INVALID_SIZE);
+    EXPECT_EQ(Param_GetRGBColor(nullptr)[2], (uint16_t)0);
+    uint16_t one = 0;
+    EXPECT_ERR(NvsConfig_GetByIndex(PARAM_INDEX_RGBColor, &one, sizeof(one)), ESP_ERR_INVALID_SIZE);
+    EXPECT_EQ(one, (uint16_t)9);
+
+    /* Strings stop at the first NUL and truncate on read */
+    EXPECT_OK(NvsConfig_SetByIndex(PARAM_INDEX_Hostname, "gw\0ignored", 10));
+    EXPECT_STREQ(Param_GetHostname(nullptr), "gw");
+    char small[2];
+    EXPECT_ERR(NvsConfig_GetByIndex(PARAM_INDEX_Hostname, small, sizeof(small)), ESP_ERR_INVALID_SIZE);
+    EXPECT_STREQ(small, "g");
+
+    EXPECT_ERR(NvsConfig_SetByIndex(PARAM_INDEX_COUNT, &serial, sizeof(serial)), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_ResetByIndex(PARAM_INDEX_COUNT), ESP_ERR_INVALID_ARG);
+    EXPECT_FALSE(NvsConfig_IsDirtyByIndex(PARAM_INDEX_COUNT));
+    EXPECT_FALSE(NvsConfig_IsDefaultByIndex(PARAM_INDEX_COUNT));
+}
+
+/** Typed ByIndex accessors check the entry's type tag before the shared scalar path. */
+TEST(GenericEngineFixture, TypedByIndex)
+{
+    EXPECT_EQ(g_nvsconfig_params[PARAM_INDEX_Thresholds].type, NVS_CONFIG_TYPE_float);
+    EXPECT_OK(NvsConfig_SetI64ByIndex(PARAM_INDEX_BigTimestamp, -1));
+    int64_t ts = 0;
+    EXPECT_OK(NvsConfig_GetI64ByIndex(PARAM_INDEX_BigTimestamp, &ts));
+    EXPECT_EQ(ts, (int64_t)-1);
+    EXPECT_EQ(Param_GetBigTimestamp(), (int64_t)-1);
+
+    float f = 0.0f;
+    EXPECT_ERR(NvsConfig_GetFloatByIndex(PARAM_INDEX_Thresholds, &f), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_SetU32ByIndex(PARAM_INDEX_BigTimestamp, 1), ESP_ERR_INVALID_ARG);
+}
+
+/** The secure level of each entry gates array and string writes too. */
+TEST(GenericEngineFixture, SecureLevelChecked)
+{
+    NvsConfig_SecureLevelChange(2);
+    const int32_t pts[6] = {0};
+    EXPECT_ERR(Param_SetCalibPoints(pts, 6), ESP_ERR_INVALID_STATE);
+    EXPECT_ERR(Param_SetElementCalibPoints(0, 1), ESP_ERR_INVALID_STATE);
+    EXPECT_ERR(Param_SetHostname("x"), ESP_ERR_INVALID_STATE);
+    EXPECT_OK(Param_SetApiUrl("http://x"));
+    NvsConfig_SecureLevelChange(0);
+}
+
+/** Values saved through the generic paths load back on the next Init. */
+TEST(GenericEngineFixture, ValuesSurviveReboot)
+{
+    EXPECT_OK(Param_SetTempReading(21.5f));
+    EXPECT_OK(Param_SetElementThresholds(1, 2.5f));
+    EXPECT_OK(Param_SetApiUrl("https://example.com"));
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_FALSE(NvsConfig_IsDirtyByIndex(PARAM_INDEX_Thresholds));
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetTempReading(), 21.5f);
+    EXPECT_EQ(Param_GetThresholds(nullptr)[1], 2.5f);
+    size_t len = 0;
+    EXPECT_STREQ(Param_GetApiUrl(&len), "https://example.com");
+    EXPECT_EQ(len, (size_t)19);
+    EXPECT_FALSE(NvsConfig_IsDefaultByIndex(PARAM_INDEX_ApiUrl));
+    EXPECT_TRUE(NvsConfig_IsDefaultByIndex(PARAM_INDEX_Hostname));
+}
@@ -5,6 +5,9 @@
  * Defines:
  *  - nvs_reset_all_params(): resets every parameter to its default value;
  *    used by all TEST_GROUP setup() functions.
+ *  - nvs_store_setup() / nvs_store_teardown(): setup and teardown of the
+ *    fixtures that run against the mock's in-memory NVS store, and
+ *    store_blob() to place an entry in it directly.
  *  - TEST_GROUP_CppUTestGroupNvsTestFixture: the base fixture class, written
  *    directly (not via the TEST_GROUP macro) so the class definition can live
  *    in this header while the mandatory `int externTestGroupNvsTestFixture`
@@ -21,6 +24,8 @@
 #include <CppUTest/TestHarness.h>
 #include "cpputest_compat.hpp"
 #include "nvs_config.h"
+#include "mock_control.h"
+#include "nvs.h"
 
 #include <cstring>
 
@@ -53,6 +58,37 @@ inline void nvs_reset_all_params()
     Param_ResetThresholds();
     Param_ResetFeatureFlags();
     Param_ResetRGBColor();
+    Param_ResetHostname();
+    Param_ResetApiUrl();
+}
+
+/**
+ * Switch the mock to its in-memory NVS store and reboot onto it with every
+ * parameter at its default.  Values saved by a test can then be read back by
+ * a second NvsConfig_Init() ("reboot").
+ */
+inline void nvs_store_setup()
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+    NvsConfig_Init();
+    nvs_reset_all_params();
+}
+
+/** Leave the in-memory store and reboot onto the default mock stubs. */
+inline void nvs_store_teardown()
+{
+    mock_reset_controls();
+    NvsConfig_Init();
+}
+
+/** Write a blob straight into the mock's NVS store, as older firmware would have. */
+inline void store_blob(const char* key, const void* data, size_t len)
+{
+    nvs_handle_t h;
+    nvs_open("param_storage", NVS_READWRITE, &h);
+    nvs_set_blob(h, key, data, len);
+    nvs_close(h);
 }
 
 /**
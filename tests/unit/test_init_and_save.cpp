@@ -4,13 +4,14 @@
  *        schema versioning migration, and callback registration limits.
  *
  * These tests exercise branches that the other test files cannot reach because
- * they require specific NVS/timer/mutex failure modes or a second Init() call.
+ * they require specific NVS/task/mutex failure modes or a second Init() call.
  * Mock control knobs from mock_control.h are used and reset in teardown().
  */
 
 #include "test_helpers.hpp"
 #include "mock_control.h"
 #include "nvs.h"
+#include "sdkconfig.h"
 #include <cstring>
 #include <cstdint>
 
@@ -42,7 +43,7 @@ TEST(InitAndSaveFixture, RegisterMigrationReturnsOk)
 
 // ── NvsConfig_SaveDirtyParameters ─────────────────────────────────────────────
 
-/** All 19 parameters are dirty after reset; SaveDirty should commit them. */
+/** All 21 parameters are dirty after reset; SaveDirty should commit them. */
 TEST(InitAndSaveFixture, SaveDirtyParametersSuccess)
 {
     // Mark something dirty so parametersChanged > 0
@@ -74,11 +75,169 @@ TEST(InitAndSaveFixture, SaveDirtyParametersNvsCommitFails)
     NvsConfig_SaveDirtyParameters();
 }
 
+/** A successful save clears the dirty flag. */
+TEST(InitAndSaveFixture, SaveClearsDirtyFlag)
+{
+    Param_SetBrightness(100);
+    EXPECT_TRUE(NvsConfig_FindParam("Brightness")->is_dirty());
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
+/** Nothing dirty: the save returns without touching flash. */
+TEST(InitAndSaveFixture, SaveWithNothingDirtySkipsFlash)
+{
+    NvsConfig_SaveDirtyParameters();
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 0);
+}
+
+/** A failed nvs_set_blob leaves the parameter dirty for the next save. */
+TEST(InitAndSaveFixture, SaveKeepsDirtyOnSetBlobFailure)
+{
+    Param_SetBrightness(100);
+    g_mock_nvs_set_blob_ret = ESP_FAIL;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_TRUE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
+/** A failed nvs_commit leaves the parameter dirty for the next save. */
+TEST(InitAndSaveFixture, SaveKeepsDirtyOnCommitFailure)
+{
+    Param_SetBrightness(100);
+    g_mock_nvs_commit_ret = ESP_FAIL;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_TRUE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
+/**
+ * A set that lands while the save is writing to flash (simulated from inside
+ * nvs_set_blob) must stay dirty so the newer value is written next time.
+ */
+TEST(InitAndSaveFixture, SetDuringSaveIsNotLost)
+{
+    Param_SetBrightness(100);
+    g_mock_nvs_set_blob_hook = [](const char* key) {
+        if (strcmp(key, "Brightness") == 0) Param_SetBrightness(200);
+    };
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(Param_GetBrightness(), (uint8_t)200);
+    EXPECT_TRUE(NvsConfig_FindParam("Brightness")->is_dirty());
+
+    g_mock_nvs_set_blob_hook = nullptr;
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 1);
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
+// ── Background save scheduling ───────────────────────────────────────────────
+
+/** Only the clean → dirty transition wakes the save task. */
+TEST(InitAndSaveFixture, FirstDirtyMarkWakesSaveTask)
+{
+    NvsConfig_SaveDirtyParameters();
+    g_mock_task_notify_count = 0;
+
+    Param_SetBrightness(100);
+    EXPECT_EQ(g_mock_task_notify_count, 1);
+    Param_SetBrightness(101);
+    Param_SetAltitude(5);
+    EXPECT_EQ(g_mock_task_notify_count, 1);
+}
+
+/** After a save has cleaned everything, the next change wakes the task again. */
+TEST(InitAndSaveFixture, SetAfterSaveWakesSaveTaskAgain)
+{
+    NvsConfig_SaveDirtyParameters();
+    g_mock_task_notify_count = 0;
+
+    Param_SetBrightness(100);
+    NvsConfig_SaveDirtyParameters();
+    Param_SetBrightness(101);
+    EXPECT_EQ(g_mock_task_notify_count, 2);
+}
+
+/** A set that does not change the value leaves the task asleep. */
+TEST(InitAndSaveFixture, UnchangedSetDoesNotWakeSaveTask)
+{
+    Param_SetBrightness(100);
+    NvsConfig_SaveDirtyParameters();
+    g_mock_task_notify_count = 0;
+
+    Param_SetBrightness(100);
+    EXPECT_EQ(g_mock_task_notify_count, 0);
+}
+
+/** A failed save keeps the task armed, so a further set does not re-wake it. */
+TEST(InitAndSaveFixture, FailedSaveStaysArmed)
+{
+    NvsConfig_SaveDirtyParameters();
+    Param_SetBrightness(100);
+    g_mock_nvs_commit_ret = ESP_FAIL;
+    NvsConfig_SaveDirtyParameters();
+    g_mock_task_notify_count = 0;
+
+    Param_SetBrightness(101);
+    EXPECT_EQ(g_mock_task_notify_count, 0);
+}
+
+/**
+ * A failed save over the dirty-byte threshold waits one quiet period before
+ * retrying instead of saving again at once; a new change or a successful save
+ * ends the back-off.
+ */
+TEST(InitAndSaveFixture, FailedSaveOverThresholdBacksOff)
+{
+    const TickType_t quiet = pdMS_TO_TICKS(CONFIG_NVS_CONFIG_SAVE_QUIET_MS);
+    NvsConfig_SaveDirtyParameters();
+    const char name[16] = "over threshold";
+    const uint8_t pattern[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    const int32_t points[6] = {1, 2, 3, 4, 5, 6};
+    const float thresholds[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    EXPECT_OK(Param_SetDeviceName(name, 16));
+    EXPECT_OK(Param_SetBytePattern(pattern, 8));
+    EXPECT_OK(Param_SetCalibPoints(points, 6));
+    EXPECT_OK(Param_SetThresholds(thresholds, 4));  // 64 bytes: at the threshold
+    g_mock_nvs_commit_ret = ESP_FAIL;
+    g_mock_nvs_commit_calls = 0;
+
+    EXPECT_EQ(mock_run_save_task(100), quiet);
+    EXPECT_EQ(g_mock_nvs_commit_calls, 1);
+
+    EXPECT_OK(Param_SetBrightness(100));
+    EXPECT_EQ(mock_run_save_task(100), quiet);
+    EXPECT_EQ(g_mock_nvs_commit_calls, 2);
+
+    g_mock_nvs_commit_ret = ESP_OK;
+    g_mock_tick_count += quiet;
+    EXPECT_EQ(mock_run_save_task(100), portMAX_DELAY);
+    EXPECT_EQ(g_mock_nvs_commit_calls, 3);
+    EXPECT_FALSE(NvsConfig_FindParam("Thresholds")->is_dirty());
+}
+
+/** After a failed save, a dirty string counts its length toward the threshold, not its capacity. */
+TEST(InitAndSaveFixture, FailedSaveCountsStringLength)
+{
+    const TickType_t quiet = pdMS_TO_TICKS(CONFIG_NVS_CONFIG_SAVE_QUIET_MS);
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_OK(Param_SetApiUrl("abc"));
+    g_mock_nvs_commit_ret = ESP_FAIL;
+    NvsConfig_SaveDirtyParameters();
+    g_mock_nvs_commit_calls = 0;
+
+    EXPECT_OK(Param_SetBrightness(100));  // 4 + 1 bytes dirty: far below the threshold
+    EXPECT_EQ(mock_run_save_task(100), quiet);
+    EXPECT_EQ(g_mock_nvs_commit_calls, 0);
+}
+
 // ── NvsConfig_Init error paths ────────────────────────────────────────────────
 
 /**
  * Second Init() call: mutex is already non-NULL so xSemaphoreCreateMutex is
- * skipped.  The rest of Init (flash, NVS open, timer) runs again.
+ * skipped.  The rest of Init (flash, NVS open, load) runs again; the save
+ * task already exists and is not created twice.
  */
 TEST(InitAndSaveFixture, InitAlreadyInitialized)
 {
@@ -95,18 +254,24 @@ TEST(InitAndSaveFixture, InitNvsFlashInitNoFreePages)
     EXPECT_OK(NvsConfig_Init());  // erase path exercised; second flash_init → OK
 }
 
-/** esp_timer_create failure → Init returns ESP_FAIL. */
-TEST(InitAndSaveFixture, InitTimerCreateFails)
+/**
+ * xTaskCreatePinnedToCore failure → Init returns ESP_FAIL and keeps no task
+ * handle, so changes wake nothing and the next Init creates the task.
+ */
+TEST(InitAndSaveFixture, InitSaveTaskCreateFails)
 {
-    g_mock_esp_timer_create_ret = ESP_FAIL;
+    mock_forget_task("nvs_cfg_save");
+    g_mock_task_create_ret = pdFAIL;
     EXPECT_ERR(NvsConfig_Init(), ESP_FAIL);
-}
 
-/** esp_timer_start_periodic failure → Init returns the error code. */
-TEST(InitAndSaveFixture, InitTimerStartFails)
-{
-    g_mock_esp_timer_start_ret = ESP_FAIL;
-    EXPECT_ERR(NvsConfig_Init(), ESP_FAIL);
+    NvsConfig_SaveDirtyParameters();
+    g_mock_task_notify_count = 0;
+    EXPECT_OK(Param_SetBrightness(100));
+    EXPECT_EQ(g_mock_task_notify_count, 0);
+
+    g_mock_task_create_ret = pdPASS;
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(g_mock_task_notify_count, 1);  // still dirty: Init wakes the new task
 }
 
 // ── NVS load-from-flash paths in Init ────────────────────────────────────────
@@ -126,8 +291,8 @@ TEST(InitAndSaveFixture, InitLoadsParametersFromNvs)
     // Set mock data to the current schema version so no mismatch occurs
     uint32_t current = NVS_CONFIG_SCHEMA_VERSION;
     memcpy(g_mock_nvs_get_blob_data, &current, sizeof(current));
-    // 1 (schema) + 13 scalars + 6 arrays = 20 successful reads
-    g_mock_nvs_get_blob_ok_calls = 20;
+    // 1 (schema) + 13 scalars + 6 arrays + 2 strings = 22 successful reads
+    g_mock_nvs_get_blob_ok_calls = 22;
     EXPECT_OK(NvsConfig_Init());
 }
 
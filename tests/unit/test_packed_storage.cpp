@@ -0,0 +1,235 @@
+/**
+ * @file test_packed_storage.cpp
+ * @brief Tests for the packed single-blob storage mode
+ *        (CONFIG_NVS_CONFIG_STORAGE_PACKED).
+ *
+ * Built into the separate unit_tests_packed binary, together with
+ * CONFIG_NVS_CONFIG_LAYOUT_SORTED so the packed image follows the size-sorted
+ * value layout.
+ */
+
+#include "test_helpers.hpp"
+#include "mock_control.h"
+#include "nvs.h"
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+
+/* Mirrors the on-flash header written by nvs_config.c */
+struct PackedHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t layout_hash;
+    uint32_t field_count;
+    uint32_t image_size;
+    uint32_t chunk_size;
+};
+
+struct PackedField {
+    char key[16];
+    uint32_t offset;
+    uint32_t size;
+};
+
+TEST_GROUP(PackedStorageFixture)
+{
+    void setup()
+    {
+        nvs_store_setup();
+    }
+    void teardown()
+    {
+        nvs_store_teardown();
+    }
+};
+
+/** The first save writes one chunk plus the header and layout descriptor. */
+TEST(PackedStorageFixture, FirstSaveWritesChunkAndLayout)
+{
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 3);
+    EXPECT_EQ(mock_nvs_store_size("_pk_hdr"), sizeof(PackedHeader));
+    EXPECT_EQ(mock_nvs_store_size("_pk_desc"), 21 * sizeof(PackedField));
+    EXPECT_EQ(mock_nvs_store_size("Brightness"), (size_t)0);
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
+/** Values written in packed form are restored by the next Init. */
+TEST(PackedStorageFixture, ValuesSurviveReboot)
+{
+    const float thresholds[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    Param_SetBrightness(42);
+    Param_SetThresholds(thresholds, 4);
+    NvsConfig_SaveDirtyParameters();
+
+    g_nvsconfig_controller.Brightness.value = 7;
+    g_nvsconfig_controller.Thresholds.value[2] = 0.0f;
+    EXPECT_OK(NvsConfig_Init());
+
+    EXPECT_EQ(Param_GetBrightness(), (uint8_t)42);
+    EXPECT_EQ(Param_GetThresholds(nullptr)[2], 3.0f);
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_default());
+    EXPECT_TRUE(NvsConfig_FindParam("Altitude")->is_default());
+}
+
+/** Once the layout is stored, a single change rewrites a single chunk. */
+TEST(PackedStorageFixture, SingleChangeRewritesOneChunk)
+{
+    NvsConfig_SaveDirtyParameters();
+    Param_SetBrightness(42);
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 1);
+}
+
+/** Per-key blobs from a device that ran without packed mode are migrated. */
+TEST(PackedStorageFixture, MigratesPerKeyBlobs)
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+    const int16_t altitude = 1234;
+    store_blob("Altitude", &altitude, sizeof(altitude));
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetAltitude(), (int16_t)1234);
+    EXPECT_TRUE(NvsConfig_FindParam("Altitude")->is_dirty());
+
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(mock_nvs_store_size("Altitude"), (size_t)0);
+    EXPECT_FALSE(NvsConfig_FindParam("Altitude")->is_dirty());
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetAltitude(), (int16_t)1234);
+}
+
+/** Typed per-key entries are migrated as well. */
+TEST(PackedStorageFixture, MigratesTypedPerKeyEntries)
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+    const float temp = 36.5f;
+    uint32_t bits;
+    memcpy(&bits, &temp, sizeof(bits));
+    nvs_handle_t h;
+    nvs_open("param_storage", NVS_READWRITE, &h);
+    nvs_set_i16(h, "Altitude", -321);
+    nvs_set_u32(h, "TempReading", bits);
+    nvs_close(h);
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetAltitude(), (int16_t)-321);
+    EXPECT_EQ(Param_GetTempReading(), 36.5f);
+
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(mock_nvs_store_type("Altitude"), (const char*)nullptr);
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetAltitude(), (int16_t)-321);
+}
+
+/** A per-key str entry is migrated; strings then round-trip through the image. */
+TEST(PackedStorageFixture, StringsMigrateAndRoundTrip)
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+    nvs_handle_t h;
+    nvs_open("param_storage", NVS_READWRITE, &h);
+    nvs_set_str(h, "Hostname", "per-key");
+    nvs_close(h);
+
+    EXPECT_OK(NvsConfig_Init());
+    size_t len;
+    EXPECT_STREQ(Param_GetHostname(&len), "per-key");
+    EXPECT_EQ(len, (size_t)7);
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(mock_nvs_store_type("Hostname"), (const char*)nullptr);
+
+    EXPECT_OK(Param_SetHostname("packed"));
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_STREQ(Param_GetHostname(&len), "packed");
+    EXPECT_EQ(len, (size_t)6);
+    EXPECT_FALSE(NvsConfig_FindParam("Hostname")->is_dirty());
+}
+
+/**
+ * Data written by firmware with a different parameter table is matched by key
+ * and size; unknown or resized entries fall back to defaults.
+ */
+TEST(PackedStorageFixture, LayoutChangeMatchesByKey)
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+
+    const PackedField fields[3] = {
+        {"Removed", 0, 4},
+        {"Altitude", 4, 2},
+        {"Brightness", 6, 2},  // was 16-bit in the old table
+    };
+    uint8_t image[8] = {};
+    const int16_t altitude = -77;
+    memcpy(&image[4], &altitude, sizeof(altitude));
+    image[6] = 9;
+    const PackedHeader hdr = {0x4E564350u, 1, 0, 0x12345678u, 3, sizeof(image), 64};
+    store_blob("_pk_desc", fields, sizeof(fields));
+    store_blob("_pk_hdr", &hdr, sizeof(hdr));
+    store_blob("_p123456780", image, sizeof(image));
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetAltitude(), (int16_t)-77);
+    EXPECT_EQ(Param_GetBrightness(), (uint8_t)255);
+
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(mock_nvs_store_size("_p123456780"), (size_t)0);
+    EXPECT_EQ(mock_nvs_store_size("_pk_desc"), 21 * sizeof(PackedField));
+}
+
+/** A chunk that fails to write leaves its parameters dirty. */
+TEST(PackedStorageFixture, FailedChunkWriteKeepsDirty)
+{
+    NvsConfig_SaveDirtyParameters();
+    Param_SetBrightness(42);
+    g_mock_nvs_set_blob_ret = ESP_FAIL;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_TRUE(NvsConfig_FindParam("Brightness")->is_dirty());
+
+    g_mock_nvs_set_blob_ret = ESP_OK;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
+/** A value put back to what the stored image holds does not rewrite its chunk, even after a reboot. */
+TEST(PackedStorageFixture, RestoredValueSkipsChunkWrite)
+{
+    Param_SetBrightness(42);
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_OK(NvsConfig_Init());
+
+    Param_SetBrightness(7);
+    Param_SetBrightness(42);
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 0);
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
+/** Scalars come first by size, then arrays by element size, with no gaps between values. */
+TEST(PackedStorageFixture, SortedLayoutLeavesNoGaps)
+{
+    EXPECT_EQ(offsetof(NvsConfigValues_t, BigTimestamp), (size_t)0);
+    EXPECT_TRUE(offsetof(NvsConfigValues_t, GpsLongitude) < offsetof(NvsConfigValues_t, CalibOffset));
+    EXPECT_TRUE(offsetof(NvsConfigValues_t, TempReading) < offsetof(NvsConfigValues_t, Altitude));
+    EXPECT_TRUE(offsetof(NvsConfigValues_t, SampleRate) < offsetof(NvsConfigValues_t, Letter));
+    EXPECT_TRUE(offsetof(NvsConfigValues_t, Brightness) < offsetof(NvsConfigValues_t, CalibPoints));
+    EXPECT_TRUE(offsetof(NvsConfigValues_t, RGBColor) < offsetof(NvsConfigValues_t, DeviceName));
+
+    /* The values themselves, rounded up to the struct's 8-byte alignment */
+    size_t used = 0;
+    for (size_t i = 0; i < PARAM_INDEX_COUNT; i++) {
+        used += g_nvsconfig_params[i].element_size * g_nvsconfig_params[i].element_count;
+    }
+    EXPECT_EQ(sizeof(NvsConfigValues_t), (used + 7) & ~(size_t)7);
+    EXPECT_EQ(sizeof(g_nvsconfig_controller), sizeof(NvsConfigValues_t));
+}
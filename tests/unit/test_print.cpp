@@ -89,7 +89,7 @@ TEST_F(NvsTestFixture, PrintDouble) {
     char buf[32];
     int n = Param_PrintGpsLongitude(buf, sizeof(buf));
     EXPECT_GT(n, 0);
-    EXPECT_STREQ(buf, "-122.419");
+    EXPECT_STREQ(buf, "-122.419418");
 }
 
 // ── Array print tests ──
@@ -115,6 +115,13 @@ TEST_F(NvsTestFixture, PrintUint16Array) {
     EXPECT_STREQ(buf, "[255,128,0]");
 }
 
+TEST_F(NvsTestFixture, PrintFloatArray) {
+    char buf[64];
+    int n = Param_PrintThresholds(buf, sizeof(buf));
+    EXPECT_EQ(n, 21);
+    EXPECT_STREQ(buf, "[0.001,1,100,9999.99]");
+}
+
 // ── Truncation safety ──
 
 TEST_F(NvsTestFixture, PrintTruncation) {
@@ -4,13 +4,14 @@
  */
 
 #include "test_helpers.hpp"
+#include <cmath>
 #include <cstring>
 
 // ── Registry metadata ──
 
 TEST_F(NvsTestFixture, RegistryCountMatchesExpected) {
-    // 13 scalars + 6 arrays = 19 params in test param_table.inc
-    EXPECT_EQ(g_nvsconfig_param_count, (size_t)19);
+    // 13 scalars + 6 arrays + 2 strings = 21 params in test param_table.inc
+    EXPECT_EQ(g_nvsconfig_param_count, (size_t)21);
 }
 
 TEST_F(NvsTestFixture, RegistryFirstParamIsLetter) {
@@ -48,6 +49,53 @@ TEST_F(NvsTestFixture, FindParamNotFound) {
     EXPECT_TRUE(NvsConfig_FindParam("NonExistent") == nullptr);
 }
 
+TEST_F(NvsTestFixture, FindParamResolvesEveryName) {
+    for (size_t i = 0; i < g_nvsconfig_param_count; i++) {
+        EXPECT_TRUE(NvsConfig_FindParam(g_nvsconfig_params[i].name) == &g_nvsconfig_params[i]);
+    }
+}
+
+TEST_F(NvsTestFixture, FindParamRejectsNearMisses) {
+    EXPECT_TRUE(NvsConfig_FindParam("brightness") == nullptr);   // case differs
+    EXPECT_TRUE(NvsConfig_FindParam("Brightnes") == nullptr);    // prefix
+    EXPECT_TRUE(NvsConfig_FindParam("BrightnessX") == nullptr);  // extension
+    EXPECT_TRUE(NvsConfig_FindParam("") == nullptr);
+    EXPECT_TRUE(NvsConfig_FindParam(nullptr) == nullptr);
+}
+
+// ── Resolve / index handles ──
+
+TEST_F(NvsTestFixture, ResolveMatchesGeneratedIndex) {
+    EXPECT_EQ(NvsConfig_Resolve("Letter"), PARAM_INDEX_Letter);
+    EXPECT_EQ(NvsConfig_Resolve("RGBColor"), PARAM_INDEX_RGBColor);
+    EXPECT_EQ((size_t)PARAM_INDEX_COUNT, g_nvsconfig_param_count);
+    EXPECT_STREQ(g_nvsconfig_params[PARAM_INDEX_Brightness].name, "Brightness");
+}
+
+TEST_F(NvsTestFixture, ResolveUnknownReturnsCount) {
+    EXPECT_EQ(NvsConfig_Resolve("NonExistent"), PARAM_INDEX_COUNT);
+    EXPECT_EQ(NvsConfig_Resolve(nullptr), PARAM_INDEX_COUNT);
+}
+
+TEST_F(NvsTestFixture, SetAndGetByIndex) {
+    const NvsConfigParamIndex_t idx = NvsConfig_Resolve("CalibOffset");
+    const int32_t value = -12345;
+    EXPECT_OK(NvsConfig_SetByIndex(idx, &value, sizeof(value)));
+    EXPECT_EQ(Param_GetCalibOffset(), value);
+
+    int32_t out = 0;
+    EXPECT_OK(NvsConfig_GetByIndex(idx, &out, sizeof(out)));
+    EXPECT_EQ(out, value);
+    EXPECT_ERR(NvsConfig_GetByIndex(idx, &out, sizeof(uint8_t)), ESP_ERR_INVALID_SIZE);
+}
+
+TEST_F(NvsTestFixture, ByIndexRejectsOutOfRange) {
+    uint8_t v = 1;
+    EXPECT_ERR(NvsConfig_SetByIndex(PARAM_INDEX_COUNT, &v, sizeof(v)), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_GetByIndex(PARAM_INDEX_COUNT, &v, sizeof(v)), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_SetByIndex(PARAM_INDEX_Brightness, nullptr, 1), ESP_ERR_INVALID_ARG);
+}
+
 // ── Vtable accessors ──
 
 TEST_F(NvsTestFixture, RegistryIsDirtyReflectsState) {
@@ -70,6 +118,45 @@ TEST_F(NvsTestFixture, RegistryIsDefaultReflectsState) {
     EXPECT_TRUE(e->is_default());
 }
 
+// ── Bitset iterators ──
+
+TEST_F(NvsTestFixture, NextDirtyVisitsOnlyDirtyParams) {
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(NvsConfig_NextDirty(0), g_nvsconfig_param_count);
+
+    Param_SetBrightness(42);
+    const uint16_t rgb[3] = {1, 2, 3};
+    EXPECT_OK(Param_SetRGBColor(rgb, 3));
+
+    size_t visited = 0;
+    for (size_t i = NvsConfig_NextDirty(0); i < g_nvsconfig_param_count; i = NvsConfig_NextDirty(i + 1)) {
+        EXPECT_TRUE(g_nvsconfig_params[i].is_dirty());
+        visited++;
+    }
+    EXPECT_EQ(visited, (size_t)2);
+
+    const size_t first = NvsConfig_NextDirty(0);
+    EXPECT_STREQ(g_nvsconfig_params[first].name, "Brightness");
+    EXPECT_STREQ(g_nvsconfig_params[NvsConfig_NextDirty(first + 1)].name, "RGBColor");
+}
+
+TEST_F(NvsTestFixture, NextNonDefaultVisitsOnlyChangedParams) {
+    EXPECT_EQ(NvsConfig_NextNonDefault(0), g_nvsconfig_param_count);
+
+    Param_SetLetter('Z');
+    const size_t i = NvsConfig_NextNonDefault(0);
+    EXPECT_STREQ(g_nvsconfig_params[i].name, "Letter");
+    EXPECT_EQ(NvsConfig_NextNonDefault(i + 1), g_nvsconfig_param_count);
+
+    Param_ResetLetter();
+    EXPECT_EQ(NvsConfig_NextNonDefault(0), g_nvsconfig_param_count);
+}
+
+TEST_F(NvsTestFixture, NextDirtyPastEndReturnsCount) {
+    EXPECT_EQ(NvsConfig_NextDirty(g_nvsconfig_param_count), g_nvsconfig_param_count);
+    EXPECT_EQ(NvsConfig_NextNonDefault(g_nvsconfig_param_count + 5), g_nvsconfig_param_count);
+}
+
 // ── Vtable operations ──
 
 TEST_F(NvsTestFixture, RegistryResetViaVtable) {
@@ -223,6 +310,73 @@ TEST_F(NvsTestFixture, RegistryElementSizeAndCount) {
     EXPECT_EQ(array->element_count, (size_t)3);
 }
 
+TEST_F(NvsTestFixture, RegistryTypeTagMatchesTable) {
+    EXPECT_EQ(NvsConfig_FindParam("Letter")->type, NVS_CONFIG_TYPE_char);
+    EXPECT_EQ(NvsConfig_FindParam("AdminLock")->type, NVS_CONFIG_TYPE_bool);
+    EXPECT_EQ(NvsConfig_FindParam("TinyOffset")->type, NVS_CONFIG_TYPE_int8_t);
+    EXPECT_EQ(NvsConfig_FindParam("GpsLongitude")->type, NVS_CONFIG_TYPE_double);
+    EXPECT_EQ(NvsConfig_FindParam("CalibPoints")->type, NVS_CONFIG_TYPE_int32_t);
+    EXPECT_EQ(NvsConfig_FindParam("Hostname")->type, NVS_CONFIG_TYPE_char);
+}
+
+// ── Typed ByIndex accessors ──
+
+TEST_F(NvsTestFixture, TypedByIndexRoundTrip) {
+    EXPECT_OK(NvsConfig_SetFloatByIndex(PARAM_INDEX_TempReading, 1.5f));
+    float f = 0.0f;
+    EXPECT_OK(NvsConfig_GetFloatByIndex(PARAM_INDEX_TempReading, &f));
+    EXPECT_EQ(f, 1.5f);
+    EXPECT_EQ(Param_GetTempReading(), 1.5f);
+
+    EXPECT_OK(NvsConfig_SetU64ByIndex(PARAM_INDEX_DeviceUID, UINT64_MAX));
+    uint64_t uid = 0;
+    EXPECT_OK(NvsConfig_GetU64ByIndex(PARAM_INDEX_DeviceUID, &uid));
+    EXPECT_EQ(uid, UINT64_MAX);
+
+    EXPECT_OK(NvsConfig_SetBoolByIndex(PARAM_INDEX_AdminLock, true));
+    EXPECT_TRUE(Param_GetAdminLock());
+    EXPECT_TRUE(NvsConfig_FindParam("AdminLock")->is_dirty());
+}
+
+TEST_F(NvsTestFixture, TypedByIndexUnchangedReturnsFail) {
+    EXPECT_ERR(NvsConfig_SetCharByIndex(PARAM_INDEX_Letter, 'A'), ESP_FAIL);
+    EXPECT_OK(NvsConfig_SetCharByIndex(PARAM_INDEX_Letter, 'B'));
+    EXPECT_ERR(NvsConfig_SetCharByIndex(PARAM_INDEX_Letter, 'B'), ESP_FAIL);
+}
+
+TEST_F(NvsTestFixture, TypedByIndexComparesLikeParamSet) {
+    EXPECT_OK(Param_SetTempReading(0.0f));
+    EXPECT_ERR(NvsConfig_SetFloatByIndex(PARAM_INDEX_TempReading, -0.0f), ESP_FAIL);
+    EXPECT_OK(NvsConfig_SetFloatByIndex(PARAM_INDEX_TempReading, NAN));
+    EXPECT_OK(NvsConfig_SetFloatByIndex(PARAM_INDEX_TempReading, NAN));
+
+    const double zero = -0.0;
+    EXPECT_OK(Param_SetGpsLongitude(0.0));
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "GpsLongitude", &zero, sizeof(zero)));
+    EXPECT_OK(NvsConfig_Commit(txn));
+    EXPECT_FALSE(std::signbit(Param_GetGpsLongitude()));  // unchanged, like Param_Set
+}
+
+TEST_F(NvsTestFixture, TypedByIndexRejectsWrongTypeOrKind) {
+    int32_t i = 0;
+    EXPECT_ERR(NvsConfig_SetI32ByIndex(PARAM_INDEX_SerialNum, 1), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_GetI32ByIndex(PARAM_INDEX_SerialNum, &i), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_GetI32ByIndex(PARAM_INDEX_CalibPoints, &i), ESP_ERR_INVALID_ARG);
+    char c = 0;
+    EXPECT_ERR(NvsConfig_GetCharByIndex(PARAM_INDEX_Hostname, &c), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_GetI32ByIndex(PARAM_INDEX_CalibOffset, nullptr), ESP_ERR_INVALID_ARG);
+    EXPECT_ERR(NvsConfig_SetI32ByIndex(PARAM_INDEX_COUNT, 1), ESP_ERR_INVALID_ARG);
+    EXPECT_EQ(Param_GetSerialNum(), (uint32_t)4000000000U);
+}
+
+TEST_F(NvsTestFixture, TypedByIndexChecksSecureLevel) {
+    NvsConfig_SecureLevelChange(2);
+    EXPECT_ERR(NvsConfig_SetI16ByIndex(PARAM_INDEX_Altitude, 100), ESP_ERR_INVALID_STATE);
+    EXPECT_OK(NvsConfig_SetDoubleByIndex(PARAM_INDEX_GpsLongitude, 1.0));
+    NvsConfig_SecureLevelChange(0);
+}
+
 // ── Bulk operations ──
 
 TEST_F(NvsTestFixture, ResetAllResetsEverything) {
@@ -4,6 +4,7 @@
  */
 
 #include "test_helpers.hpp"
+#include <cmath>
 
 // ── char ──
 
@@ -198,6 +199,13 @@ TEST_F(NvsTestFixture, FloatReset) {
     EXPECT_EQ(Param_GetTempReading(), -40.5f);
 }
 
+TEST_F(NvsTestFixture, FloatComparedByValue) {
+    EXPECT_OK(Param_SetTempReading(0.0f));
+    EXPECT_ERR(Param_SetTempReading(-0.0f), ESP_FAIL);  // == treats -0.0 as 0.0
+    EXPECT_OK(Param_SetTempReading(NAN));
+    EXPECT_OK(Param_SetTempReading(NAN));  // NaN never equals itself
+}
+
 // ── double ──
 
 TEST_F(NvsTestFixture, DoubleDefault) {
@@ -0,0 +1,141 @@
+/**
+ * @file test_snapshot.cpp
+ * @brief Unit tests for whole-configuration snapshots and generation polling.
+ */
+
+#include "test_helpers.hpp"
+#include <cstddef>
+#include <cstring>
+
+// ── Snapshot ──
+
+TEST_F(NvsTestFixture, SnapshotCopiesEveryValue) {
+    Param_SetBrightness(17);
+    Param_SetTempReading(3.5f);
+    const int32_t pts[6] = {1, 2, 3, 4, 5, 6};
+    EXPECT_OK(Param_SetCalibPoints(pts, 6));
+
+    NvsConfigValues_t snap;
+    memset(&snap, 0, sizeof(snap));
+    NvsConfig_Snapshot(&snap);
+    EXPECT_EQ(snap.Brightness, (uint8_t)17);
+    EXPECT_EQ(snap.TempReading, 3.5f);
+    EXPECT_EQ(snap.Letter, 'A');
+    EXPECT_EQ(snap.CalibPoints[5], 6);
+    EXPECT_STREQ(snap.DeviceName, "Stress");
+}
+
+TEST_F(NvsTestFixture, SnapshotIsControllerImage) {
+    EXPECT_OK(Param_SetHostname("snap"));
+    Param_SetGpsLongitude(1.25);
+
+    EXPECT_EQ(sizeof(NvsConfigValues_t), sizeof(g_nvsconfig_controller));
+    EXPECT_EQ(offsetof(NvsConfigValues_t, Hostname),
+              offsetof(NvsConfigMasterController_t, Hostname));
+    NvsConfigValues_t snap;
+    NvsConfig_Snapshot(&snap);
+    EXPECT_EQ(memcmp(&snap, &g_nvsconfig_controller, sizeof(snap)), 0);
+}
+
+TEST_F(NvsTestFixture, DefaultsTableMatchesResetValues) {
+    EXPECT_EQ(g_nvsconfig_defaults.Brightness, (uint8_t)255);
+    EXPECT_EQ(g_nvsconfig_defaults.CalibPoints[0], -1000);
+    EXPECT_STREQ(g_nvsconfig_defaults.Hostname, "nvs-node");
+
+    Param_SetBrightness(17);
+    NvsConfig_ResetAll();
+    NvsConfigValues_t snap;
+    memset(&snap, 0, sizeof(snap));  // padding is not copied
+    NvsConfig_Snapshot(&snap);
+    EXPECT_EQ(memcmp(&snap, &g_nvsconfig_defaults, sizeof(snap)), 0);
+}
+
+TEST_F(NvsTestFixture, SnapshotGenerationAdvancesOnlyOnChange) {
+    NvsConfigValues_t snap;
+    const uint32_t g1 = NvsConfig_Snapshot(&snap);
+    EXPECT_EQ(NvsConfig_Snapshot(&snap), g1);
+
+    Param_SetBrightness(Param_GetBrightness() + 1);
+    const uint32_t g2 = NvsConfig_Snapshot(&snap);
+    EXPECT_TRUE(g2 != g1);
+
+    Param_SetBrightness(Param_GetBrightness());  // same value: no change
+    EXPECT_EQ(NvsConfig_Snapshot(&snap), g2);
+}
+
+TEST_F(NvsTestFixture, SnapshotSinceCopiesOnlyChangedFields) {
+    NvsConfigValues_t snap;
+    const uint32_t g1 = NvsConfig_Snapshot(&snap);
+
+    Param_SetSampleRate(1234);
+    const float th[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+    EXPECT_OK(Param_SetThresholds(th, 4));
+
+    // Poison the snapshot: only the changed fields may be overwritten
+    NvsConfigValues_t inc;
+    memset(&inc, 0xA5, sizeof(inc));
+    const uint32_t g2 = NvsConfig_SnapshotSince(&inc, g1);
+    EXPECT_TRUE(g2 != g1);
+    EXPECT_EQ(inc.SampleRate, (uint16_t)1234);
+    EXPECT_EQ(inc.Thresholds[3], 4.0f);
+    EXPECT_EQ(inc.Brightness, (uint8_t)0xA5);
+
+    // Nothing changed since g2: nothing is copied
+    memset(&inc, 0xA5, sizeof(inc));
+    EXPECT_EQ(NvsConfig_SnapshotSince(&inc, g2), g2);
+    EXPECT_EQ(inc.SampleRate, (uint16_t)0xA5A5);
+}
+
+TEST_F(NvsTestFixture, SnapshotSinceMatchesFullSnapshot) {
+    // Zeroed so the padding compares equal too
+    NvsConfigValues_t inc, full;
+    memset(&inc, 0, sizeof(inc));
+    memset(&full, 0, sizeof(full));
+    const uint32_t g1 = NvsConfig_Snapshot(&inc);
+    Param_SetLetter('Q');
+    Param_ResetLetter();
+    Param_SetAltitude(-5);
+    const uint8_t level = 9;
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "Brightness", &level, sizeof(level)));
+    EXPECT_OK(NvsConfig_Commit(txn));
+
+    const uint32_t g_full = NvsConfig_Snapshot(&full);
+    EXPECT_EQ(NvsConfig_SnapshotSince(&inc, g1), g_full);
+    EXPECT_EQ(memcmp(&inc, &full, sizeof(full)), 0);
+}
+
+// ── Generations ──
+
+TEST_F(NvsTestFixture, ChangedSinceTracksOneParameter) {
+    const uint32_t seen = NvsConfig_Epoch();
+    EXPECT_FALSE(NvsConfig_ChangedSince(PARAM_INDEX_Altitude, seen));
+    Param_SetAltitude(-7);
+    EXPECT_TRUE(NvsConfig_ChangedSince(PARAM_INDEX_Altitude, seen));
+    EXPECT_FALSE(NvsConfig_ChangedSince(PARAM_INDEX_Letter, seen));
+    EXPECT_EQ(NvsConfig_GetGeneration(PARAM_INDEX_Altitude), NvsConfig_Epoch());
+    EXPECT_FALSE(NvsConfig_ChangedSince(PARAM_INDEX_Altitude, NvsConfig_Epoch()));
+}
+
+TEST_F(NvsTestFixture, EpochMatchesSnapshotGeneration) {
+    NvsConfigValues_t snap;
+    Param_SetSerialNum(99);
+    EXPECT_EQ(NvsConfig_Snapshot(&snap), NvsConfig_Epoch());
+}
+
+TEST_F(NvsTestFixture, AnyChangedSinceOverASet) {
+    static const NvsConfigParamIndex_t deps[] = {PARAM_INDEX_SampleRate, PARAM_INDEX_RGBColor};
+    const uint32_t seen = NvsConfig_Epoch();
+    EXPECT_FALSE(NvsConfig_AnyChangedSince(deps, 2, seen));
+    Param_SetLetter('K');  // not in the set
+    EXPECT_FALSE(NvsConfig_AnyChangedSince(deps, 2, seen));
+    const uint16_t rgb[3] = {1, 2, 3};
+    EXPECT_OK(Param_SetRGBColor(rgb, 3));
+    EXPECT_TRUE(NvsConfig_AnyChangedSince(deps, 2, seen));
+    EXPECT_FALSE(NvsConfig_AnyChangedSince(deps, 2, NvsConfig_Epoch()));
+}
+
+TEST_F(NvsTestFixture, GenerationOutOfRangeIsZero) {
+    EXPECT_EQ(NvsConfig_GetGeneration(PARAM_INDEX_COUNT), 0U);
+    EXPECT_FALSE(NvsConfig_ChangedSince(PARAM_INDEX_COUNT, 0));
+}
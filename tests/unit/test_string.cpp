@@ -0,0 +1,264 @@
+/**
+ * @file test_string.cpp
+ * @brief Tests for STRING parameters: setters and getters, the registry and
+ *        transaction paths, and nvs_set_str() storage.
+ *
+ * Hostname (maxlen 31, default "nvs-node") and ApiUrl (maxlen 63, empty
+ * default) come from the test param_table.inc.
+ */
+
+#include "test_helpers.hpp"
+#include "mock_control.h"
+#include "nvs.h"
+#include <cstring>
+#include <string>
+
+/** True when every byte of @p s after its terminator is zero. */
+static bool tail_is_zero(const char* s, size_t size)
+{
+    for (size_t i = strlen(s); i < size; i++) {
+        if (s[i] != '\0') return false;
+    }
+    return true;
+}
+
+static int s_cb_count;
+static size_t s_cb_first;
+static std::string s_cb_old;
+static std::string s_cb_new;
+
+static void string_callback(const NvsConfigChange_t* change, void* /*user_data*/)
+{
+    s_cb_count++;
+    s_cb_first = change->first;
+    s_cb_old.assign(static_cast<const char*>(change->old_value), change->count);
+    s_cb_new.assign(static_cast<const char*>(change->new_value), change->count);
+}
+
+TEST_GROUP(StringFixture)
+{
+    void setup()
+    {
+        nvs_store_setup();
+    }
+    void teardown()
+    {
+        nvs_store_teardown();
+    }
+};
+
+/** The default is loaded with its length; set and get track the new length. */
+TEST(StringFixture, SetAndGetTrackLength)
+{
+    size_t len = 0;
+    EXPECT_STREQ(Param_GetHostname(&len), "nvs-node");
+    EXPECT_EQ(len, (size_t)8);
+    EXPECT_TRUE(NvsConfig_FindParam("Hostname")->is_default());
+
+    EXPECT_OK(Param_SetHostname("sensor-17.local"));
+    EXPECT_STREQ(Param_GetHostname(&len), "sensor-17.local");
+    EXPECT_EQ(len, (size_t)15);
+    EXPECT_FALSE(NvsConfig_FindParam("Hostname")->is_default());
+    EXPECT_TRUE(NvsConfig_FindParam("Hostname")->is_dirty());
+}
+
+/** maxlen characters fit; one more is rejected without a write. */
+TEST(StringFixture, LongerThanMaxlenRejected)
+{
+    const std::string max(31, 'x');
+    EXPECT_OK(Param_SetHostname(max.c_str()));
+    EXPECT_EQ(strlen(Param_GetHostname(nullptr)), (size_t)31);
+
+    const std::string too_long(32, 'y');
+    EXPECT_ERR(Param_SetHostname(too_long.c_str()), ESP_ERR_INVALID_SIZE);
+    EXPECT_STREQ(Param_GetHostname(nullptr), max.c_str());
+}
+
+/** Setting the current value again is reported like an unchanged array. */
+TEST(StringFixture, UnchangedValueReturnsInvalidArg)
+{
+    EXPECT_ERR(Param_SetHostname("nvs-node"), ESP_ERR_INVALID_ARG);
+    EXPECT_OK(Param_SetHostname("nvs"));
+    EXPECT_ERR(Param_SetHostname("nvs"), ESP_ERR_INVALID_ARG);
+}
+
+/** A shorter string clears the rest of the old one. */
+TEST(StringFixture, ShorterStringClearsTail)
+{
+    const NvsConfigParamEntry_t* e = NvsConfig_FindParam("Hostname");
+    EXPECT_OK(Param_SetHostname("a-rather-long-hostname"));
+    EXPECT_OK(Param_SetHostname("ab"));
+    EXPECT_TRUE(tail_is_zero(g_nvsconfig_controller.Hostname.value, e->element_count));
+
+    /* Back to the default by value counts as default again */
+    EXPECT_OK(Param_SetHostname("nvs-node"));
+    EXPECT_TRUE(e->is_default());
+}
+
+/** Reset restores the default and clears the tail of a longer value. */
+TEST(StringFixture, ResetRestoresDefault)
+{
+    EXPECT_ERR(Param_ResetHostname(), ESP_FAIL);
+    EXPECT_OK(Param_SetHostname("a-rather-long-hostname"));
+    EXPECT_OK(Param_ResetHostname());
+    size_t len;
+    EXPECT_STREQ(Param_GetHostname(&len), "nvs-node");
+    EXPECT_EQ(len, (size_t)8);
+    EXPECT_TRUE(tail_is_zero(g_nvsconfig_controller.Hostname.value, sizeof(g_nvsconfig_controller.Hostname.value)));
+}
+
+/** Copy needs room for the terminator; Print copies and reports the full length. */
+TEST(StringFixture, CopyAndPrint)
+{
+    char buf[16];
+    EXPECT_OK(Param_CopyHostname(buf, 9));
+    EXPECT_STREQ(buf, "nvs-node");
+    EXPECT_ERR(Param_CopyHostname(buf, 8), ESP_ERR_INVALID_SIZE);
+
+    EXPECT_EQ(Param_PrintHostname(buf, sizeof(buf)), 8);
+    EXPECT_STREQ(buf, "nvs-node");
+    EXPECT_EQ(Param_PrintHostname(buf, 4), 8);
+    EXPECT_STREQ(buf, "nvs");
+    EXPECT_EQ(Param_PrintApiUrl(buf, sizeof(buf)), 0);
+    EXPECT_STREQ(buf, "");
+}
+
+/** Acquire returns the live string and its length until Release. */
+TEST(StringFixture, AcquireAndRelease)
+{
+    EXPECT_OK(Param_SetHostname("edge"));
+    size_t len = 0;
+    const char* p = Param_AcquireHostname(&len);
+    EXPECT_STREQ(p, "edge");
+    EXPECT_EQ(len, (size_t)4);
+    EXPECT_TRUE(p == g_nvsconfig_controller.Hostname.value);
+    Param_ReleaseHostname();
+
+    EXPECT_STREQ(Param_AcquireApiUrl(nullptr), "");
+    Param_ReleaseApiUrl();
+}
+
+/** Registry set stops at the first NUL; get truncates with a warning. */
+TEST(StringFixture, RegistrySetAndGet)
+{
+    const NvsConfigParamEntry_t* e = NvsConfig_FindParam("Hostname");
+    EXPECT_TRUE(e->is_string);
+    EXPECT_FALSE(e->is_array);
+    EXPECT_EQ(e->element_size, (size_t)1);
+    EXPECT_EQ(e->element_count, (size_t)32);
+
+    EXPECT_OK(e->set("gateway", 7));
+    EXPECT_STREQ(Param_GetHostname(nullptr), "gateway");
+    EXPECT_OK(e->set("gw\0ignored", 10));
+    EXPECT_STREQ(Param_GetHostname(nullptr), "gw");
+    const std::string too_long(32, 'z');
+    EXPECT_ERR(e->set(too_long.data(), too_long.size()), ESP_ERR_INVALID_SIZE);
+
+    char buf[8];
+    EXPECT_OK(e->get(buf, sizeof(buf)));
+    EXPECT_STREQ(buf, "gw");
+    EXPECT_OK(e->set("gateway-2", 9));
+    EXPECT_ERR(e->get(buf, 4), ESP_ERR_INVALID_SIZE);
+    EXPECT_STREQ(buf, "gat");
+}
+
+/** A staged string is applied on commit with its length. */
+TEST(StringFixture, TransactionSetsString)
+{
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "ApiUrl", "https://example.com/api", 23));
+    const std::string too_long(64, 'u');
+    EXPECT_ERR(NvsConfig_TxnSet(txn, "ApiUrl", too_long.data(), too_long.size()), ESP_ERR_INVALID_SIZE);
+    EXPECT_OK(NvsConfig_Commit(txn));
+
+    size_t len;
+    EXPECT_STREQ(Param_GetApiUrl(&len), "https://example.com/api");
+    EXPECT_EQ(len, (size_t)23);
+    EXPECT_FALSE(NvsConfig_FindParam("ApiUrl")->is_default());
+}
+
+/** Strings are saved with nvs_set_str(), terminator included, and survive a reboot. */
+TEST(StringFixture, StoredAsStrAndSurvivesReboot)
+{
+    EXPECT_OK(Param_SetHostname("edge-42"));
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_STREQ(mock_nvs_store_type("Hostname"), "str");
+    EXPECT_EQ(mock_nvs_store_size("Hostname"), (size_t)8);
+    EXPECT_EQ(mock_nvs_store_size("ApiUrl"), (size_t)1);
+
+    memset(g_nvsconfig_controller.Hostname.value, 0, sizeof(g_nvsconfig_controller.Hostname.value));
+    EXPECT_OK(NvsConfig_Init());
+    size_t len;
+    EXPECT_STREQ(Param_GetHostname(&len), "edge-42");
+    EXPECT_EQ(len, (size_t)7);
+    EXPECT_FALSE(NvsConfig_FindParam("Hostname")->is_dirty());
+}
+
+/** A char array blob left by an ARRAY of the same name is read and rewritten as a string. */
+TEST(StringFixture, MigratesCharArrayBlob)
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+    char old[32] = "from-array";
+    store_blob("Hostname", old, sizeof(old));
+
+    EXPECT_OK(NvsConfig_Init());
+    size_t len;
+    EXPECT_STREQ(Param_GetHostname(&len), "from-array");
+    EXPECT_EQ(len, (size_t)10);
+    EXPECT_TRUE(NvsConfig_FindParam("Hostname")->is_dirty());
+
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_STREQ(mock_nvs_store_type("Hostname"), "str");
+    EXPECT_EQ(mock_nvs_store_size("Hostname"), (size_t)11);
+}
+
+/** Value subscribers see the old and new characters, padded to the longer string. */
+TEST(StringFixture, ValueCallbackSeesStrings)
+{
+    NvsConfigSubscription_t sub;
+    s_cb_count = 0;
+    EXPECT_OK(NvsConfig_SubscribeValues("Hostname", string_callback, nullptr, &sub));
+    EXPECT_OK(Param_SetHostname("nvs-nodes"));
+    EXPECT_EQ(s_cb_count, 1);
+    EXPECT_STREQ(s_cb_old.c_str(), "");
+    EXPECT_STREQ(s_cb_new.c_str(), "s");
+
+    EXPECT_OK(Param_SetHostname("x"));
+    EXPECT_EQ(s_cb_count, 2);
+    EXPECT_TRUE(s_cb_old == std::string("nvs-nodes", 9));
+    EXPECT_TRUE(s_cb_new == std::string("x\0\0\0\0\0\0\0\0", 9));
+    EXPECT_OK(NvsConfig_Unsubscribe(sub));
+}
+
+/**
+ * Changes longer than the inline capture are delivered too, and a commit
+ * reports the same span as the setter: the characters that differ up to the
+ * longer string's terminator.
+ */
+TEST(StringFixture, ValueCallbackSpanMatchesOnCommit)
+{
+    NvsConfigSubscription_t sub;
+    s_cb_count = 0;
+    EXPECT_OK(NvsConfig_SubscribeValues("ApiUrl", string_callback, nullptr, &sub));
+    EXPECT_OK(Param_SetApiUrl("https://example.com/api"));
+    EXPECT_EQ(s_cb_count, 1);
+    EXPECT_EQ(s_cb_first, (size_t)0);
+    EXPECT_TRUE(s_cb_old == std::string(23, '\0'));
+    EXPECT_STREQ(s_cb_new.c_str(), "https://example.com/api");
+
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "ApiUrl", "https://example.com/x", 21));
+    EXPECT_OK(NvsConfig_Commit(txn));
+    EXPECT_EQ(s_cb_count, 2);
+    EXPECT_EQ(s_cb_first, (size_t)20);
+    EXPECT_STREQ(s_cb_old.c_str(), "api");
+    EXPECT_TRUE(s_cb_new == std::string("x\0\0", 3));
+
+    EXPECT_OK(Param_SetApiUrl("https://example.com/api"));
+    EXPECT_EQ(s_cb_count, 3);
+    EXPECT_EQ(s_cb_first, (size_t)20);
+    EXPECT_TRUE(s_cb_old == std::string("x\0\0", 3));
+    EXPECT_STREQ(s_cb_new.c_str(), "api");
+    EXPECT_OK(NvsConfig_Unsubscribe(sub));
+}
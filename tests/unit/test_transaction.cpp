@@ -0,0 +1,152 @@
+/**
+ * @file test_transaction.cpp
+ * @brief Unit tests for multi-parameter transactions (Begin/TxnSet/Commit/Abort).
+ */
+
+#include "test_helpers.hpp"
+#include "mock_control.h"
+#include <cstring>
+
+// ── Test state ──
+
+static int s_cb_count = 0;
+static int s_cb_calib_points = 0;
+static int32_t s_seen_offset = 0;
+
+static void count_callback(const char* name, void* /*user_data*/) {
+    s_cb_count++;
+    if (strcmp(name, "CalibPoints") == 0) {
+        s_cb_calib_points++;
+        // The rest of the group is already applied when the first callback runs
+        s_seen_offset = Param_GetCalibOffset();
+    }
+}
+
+// ── Fixture ──
+
+TEST_GROUP(TransactionFixture)
+{
+    void setup() {
+        mock_reset_controls();
+        nvs_reset_all_params();
+        NvsConfig_SaveDirtyParameters();
+        NvsConfig_ClearCallbacks();
+        NvsConfig_ResetWriteCounts();
+        s_cb_count = 0;
+        s_cb_calib_points = 0;
+        s_seen_offset = 0;
+    }
+    void teardown() {
+        NvsConfig_ClearCallbacks();
+        NvsConfig_SecureLevelChange(0);
+        mock_reset_controls();
+    }
+};
+
+// ── Tests ──
+
+TEST_F(TransactionFixture, StagedWritesInvisibleUntilCommit) {
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_TRUE(txn != nullptr);
+    const uint8_t brightness = 42;
+    EXPECT_OK(NvsConfig_TxnSet(txn, "Brightness", &brightness, sizeof(brightness)));
+    EXPECT_EQ(Param_GetBrightness(), (uint8_t)255);
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+
+    EXPECT_OK(NvsConfig_Commit(txn));
+    EXPECT_EQ(Param_GetBrightness(), (uint8_t)42);
+    EXPECT_TRUE(NvsConfig_FindParam("Brightness")->is_dirty());
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_default());
+    EXPECT_EQ(NvsConfig_GetWriteCount("Brightness"), 1U);
+}
+
+TEST_F(TransactionFixture, CallbacksFireOnceAfterWholeGroupApplied) {
+    NvsConfig_RegisterGlobalOnChange(count_callback, nullptr);
+    const int32_t points[6] = {1, 2, 3, 4, 5, 6};
+    const int32_t offset = 1234;
+
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "CalibPoints", points, sizeof(points)));
+    EXPECT_OK(NvsConfig_TxnSet(txn, "CalibOffset", &offset, sizeof(offset)));
+    EXPECT_OK(NvsConfig_TxnSet(txn, "CalibPoints", points, sizeof(points)));
+    EXPECT_EQ(s_cb_count, 0);
+
+    EXPECT_OK(NvsConfig_Commit(txn));
+    EXPECT_EQ(s_cb_count, 2);
+    EXPECT_EQ(s_cb_calib_points, 1);
+    EXPECT_EQ(s_seen_offset, 1234);
+}
+
+TEST_F(TransactionFixture, UnchangedValuesAreSkipped) {
+    NvsConfig_RegisterGlobalOnChange(count_callback, nullptr);
+    const uint8_t brightness = 255;  // already the current value
+
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "Brightness", &brightness, sizeof(brightness)));
+    EXPECT_OK(NvsConfig_Commit(txn));
+    EXPECT_EQ(s_cb_count, 0);
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+}
+
+TEST_F(TransactionFixture, AbortDiscardsEverything) {
+    NvsConfig_RegisterGlobalOnChange(count_callback, nullptr);
+    const char letter = 'Z';
+
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "Letter", &letter, sizeof(letter)));
+    NvsConfig_Abort(txn);
+    EXPECT_EQ(Param_GetLetter(), 'A');
+    EXPECT_EQ(s_cb_count, 0);
+}
+
+TEST_F(TransactionFixture, GroupIsSavedInOneCommit) {
+    const int32_t points[6] = {1, 2, 3, 4, 5, 6};
+    const int32_t offset = 1234;
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    NvsConfig_TxnSet(txn, "CalibPoints", points, sizeof(points));
+    NvsConfig_TxnSet(txn, "CalibOffset", &offset, sizeof(offset));
+    EXPECT_OK(NvsConfig_Commit(txn));
+
+    g_mock_nvs_set_blob_calls = 0;
+    g_mock_nvs_commit_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 2);
+    EXPECT_EQ(g_mock_nvs_commit_calls, 1);
+}
+
+TEST_F(TransactionFixture, SizeRulesMatchRegistrySet) {
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    const uint16_t wide = 1;
+    EXPECT_ERR(NvsConfig_TxnSet(txn, "Brightness", &wide, sizeof(wide)), ESP_ERR_INVALID_SIZE);
+    const uint16_t too_big[4] = {1, 2, 3, 4};
+    EXPECT_ERR(NvsConfig_TxnSet(txn, "RGBColor", too_big, sizeof(too_big)), ESP_ERR_INVALID_SIZE);
+    const uint16_t partial[2] = {7, 8};
+    EXPECT_ERR(NvsConfig_TxnSet(txn, "RGBColor", partial, sizeof(partial)), ESP_ERR_INVALID_SIZE);
+    EXPECT_ERR(NvsConfig_TxnSet(txn, "NonExistent", partial, sizeof(partial)), ESP_ERR_NOT_FOUND);
+    EXPECT_OK(NvsConfig_Commit(txn));
+
+    const uint16_t* rgb = Param_GetRGBColor(nullptr);
+    EXPECT_EQ(rgb[0], (uint16_t)7);
+    EXPECT_EQ(rgb[1], (uint16_t)8);
+    EXPECT_EQ(rgb[2], (uint16_t)0);  // zero-filled
+    EXPECT_EQ(Param_GetBrightness(), (uint8_t)255);
+}
+
+TEST_F(TransactionFixture, SecurityLevelCheckedOnStageAndCommit) {
+    const uint8_t brightness = 42;  // level 0
+    const int16_t altitude = 5;     // level 1
+
+    NvsConfig_SecureLevelChange(1);
+    NvsConfigTxn_t* txn = NvsConfig_Begin();
+    EXPECT_ERR(NvsConfig_TxnSet(txn, "Brightness", &brightness, sizeof(brightness)), ESP_ERR_INVALID_STATE);
+    NvsConfig_Abort(txn);
+
+    NvsConfig_SecureLevelChange(0);
+    txn = NvsConfig_Begin();
+    EXPECT_OK(NvsConfig_TxnSet(txn, "Altitude", &altitude, sizeof(altitude)));
+    EXPECT_OK(NvsConfig_TxnSet(txn, "Brightness", &brightness, sizeof(brightness)));
+    NvsConfig_SecureLevelChange(1);
+    EXPECT_ERR(NvsConfig_Commit(txn), ESP_ERR_INVALID_STATE);
+    EXPECT_EQ(Param_GetAltitude(), (int16_t)-32000);  // nothing applied
+    EXPECT_EQ(Param_GetBrightness(), (uint8_t)255);
+}
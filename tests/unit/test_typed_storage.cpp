@@ -0,0 +1,125 @@
+/**
+ * @file test_typed_storage.cpp
+ * @brief Tests for typed NVS entries for scalar parameters
+ *        (CONFIG_NVS_CONFIG_TYPED_SCALARS, on in the default build).
+ *
+ * The mock's NVS store records the NVS type of each entry, so the tests can
+ * check which nvs_set_*() call wrote it.
+ */
+
+#include "test_helpers.hpp"
+#include "mock_control.h"
+#include "nvs.h"
+#include <cstring>
+#include <cstdint>
+
+TEST_GROUP(TypedStorageFixture)
+{
+    void setup()
+    {
+        nvs_store_setup();
+    }
+    void teardown()
+    {
+        nvs_store_teardown();
+    }
+};
+
+/** Each scalar type is written with its native nvs_set_*() call; arrays stay blobs. */
+TEST(TypedStorageFixture, SaveUsesNativeTypes)
+{
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_STREQ(mock_nvs_store_type("Letter"), "u8");
+    EXPECT_STREQ(mock_nvs_store_type("AdminLock"), "u8");
+    EXPECT_STREQ(mock_nvs_store_type("TinyOffset"), "i8");
+    EXPECT_STREQ(mock_nvs_store_type("Altitude"), "i16");
+    EXPECT_STREQ(mock_nvs_store_type("SampleRate"), "u16");
+    EXPECT_STREQ(mock_nvs_store_type("CalibOffset"), "i32");
+    EXPECT_STREQ(mock_nvs_store_type("BigTimestamp"), "i64");
+    EXPECT_STREQ(mock_nvs_store_type("DeviceUID"), "u64");
+    EXPECT_STREQ(mock_nvs_store_type("TempReading"), "u32");
+    EXPECT_STREQ(mock_nvs_store_type("GpsLongitude"), "u64");
+    EXPECT_STREQ(mock_nvs_store_type("CalibPoints"), "blob");
+}
+
+/** Typed entries, including float bit patterns, are restored by the next Init. */
+TEST(TypedStorageFixture, ValuesSurviveReboot)
+{
+    EXPECT_OK(Param_SetTinyOffset(-5));
+    EXPECT_OK(Param_SetBigTimestamp(-1234567890123LL));
+    EXPECT_OK(Param_SetTempReading(21.25f));
+    EXPECT_OK(Param_SetGpsLongitude(-0.125));
+    EXPECT_OK(Param_SetLetter('z'));
+    NvsConfig_SaveDirtyParameters();
+
+    g_nvsconfig_controller.TempReading.value = 0.0f;
+    EXPECT_OK(NvsConfig_Init());
+
+    EXPECT_EQ(Param_GetTinyOffset(), (int8_t)-5);
+    EXPECT_EQ(Param_GetBigTimestamp(), (int64_t)-1234567890123LL);
+    EXPECT_EQ(Param_GetTempReading(), 21.25f);
+    EXPECT_EQ(Param_GetGpsLongitude(), -0.125);
+    EXPECT_EQ(Param_GetLetter(), 'z');
+    EXPECT_FALSE(NvsConfig_FindParam("TempReading")->is_dirty());
+    EXPECT_FALSE(NvsConfig_FindParam("TempReading")->is_default());
+}
+
+/** A scalar blob from earlier firmware is read, then replaced by a typed entry. */
+TEST(TypedStorageFixture, MigratesBlobOnFirstBoot)
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+    const int32_t offset = -77;
+    const double lon = 8.5;
+    store_blob("CalibOffset", &offset, sizeof(offset));
+    store_blob("GpsLongitude", &lon, sizeof(lon));
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetCalibOffset(), (int32_t)-77);
+    EXPECT_EQ(Param_GetGpsLongitude(), 8.5);
+    EXPECT_TRUE(NvsConfig_FindParam("CalibOffset")->is_dirty());
+
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_STREQ(mock_nvs_store_type("CalibOffset"), "i32");
+    EXPECT_STREQ(mock_nvs_store_type("GpsLongitude"), "u64");
+    EXPECT_FALSE(NvsConfig_FindParam("CalibOffset")->is_dirty());
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetCalibOffset(), (int32_t)-77);
+    EXPECT_EQ(Param_GetGpsLongitude(), 8.5);
+    EXPECT_FALSE(NvsConfig_FindParam("CalibOffset")->is_dirty());
+}
+
+/** An entry of the wrong type (e.g. the parameter's type changed) falls back to the default. */
+TEST(TypedStorageFixture, TypeMismatchUsesDefault)
+{
+    mock_reset_controls();
+    g_mock_nvs_store_enabled = 1;
+    nvs_handle_t h;
+    nvs_open("param_storage", NVS_READWRITE, &h);
+    nvs_set_u8(h, "SerialNum", 9);
+    nvs_close(h);
+
+    EXPECT_OK(NvsConfig_Init());
+    EXPECT_EQ(Param_GetSerialNum(), (uint32_t)4000000000U);
+    EXPECT_TRUE(NvsConfig_FindParam("SerialNum")->is_dirty());
+
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_STREQ(mock_nvs_store_type("SerialNum"), "u32");
+}
+
+/** A failed typed write leaves the parameter dirty until a save succeeds. */
+TEST(TypedStorageFixture, FailedWriteKeepsDirty)
+{
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_OK(Param_SetSampleRate(1234));
+    g_mock_nvs_set_blob_ret = ESP_FAIL;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_TRUE(NvsConfig_FindParam("SampleRate")->is_dirty());
+
+    g_mock_nvs_set_blob_ret = ESP_OK;
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 1);
+    EXPECT_FALSE(NvsConfig_FindParam("SampleRate")->is_dirty());
+}
@@ -4,16 +4,21 @@
  */
 
 #include "test_helpers.hpp"
+#include "mock_control.h"
 
 // ── Fixture ──
 
 TEST_GROUP(WearLevelFixture)
 {
     void setup() {
+        mock_reset_controls();
         nvs_reset_all_params();
+        NvsConfig_SaveDirtyParameters();
         NvsConfig_ResetWriteCounts();
     }
-    void teardown() {}
+    void teardown() {
+        mock_reset_controls();
+    }
 };
 
 // ── Tests ──
@@ -58,3 +63,82 @@ TEST_F(WearLevelFixture, ArrayWritesCounted) {
 TEST_F(WearLevelFixture, UnknownParamReturnsZero) {
     EXPECT_EQ(NvsConfig_GetWriteCount("NonExistent"), 0U);
 }
+
+TEST_F(WearLevelFixture, CountByIndexMatchesByName) {
+    Param_SetSampleRate(100);
+    Param_SetSampleRate(200);
+    EXPECT_EQ(NvsConfig_GetWriteCountByIndex(PARAM_INDEX_SampleRate), 2U);
+    EXPECT_EQ(NvsConfig_GetWriteCountByIndex(PARAM_INDEX_SampleRate), NvsConfig_GetWriteCount("SampleRate"));
+    EXPECT_EQ(NvsConfig_GetWriteCountByIndex(PARAM_INDEX_COUNT), 0U);
+}
+
+// ── Suppressed flash writes ──
+
+TEST_F(WearLevelFixture, ValueRestoredBeforeSaveIsNotRewritten) {
+    Param_SetBrightness(42);
+    NvsConfig_SaveDirtyParameters();
+    Param_SetBrightness(7);
+    Param_SetBrightness(42);
+    EXPECT_TRUE(NvsConfig_FindParam("Brightness")->is_dirty());
+
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 0);
+    EXPECT_FALSE(NvsConfig_FindParam("Brightness")->is_dirty());
+    EXPECT_EQ(NvsConfig_GetSuppressedWriteCount("Brightness"), 1U);
+    EXPECT_EQ(NvsConfig_GetTotalSuppressedWriteCount(), 1U);
+}
+
+TEST_F(WearLevelFixture, ResetToStoredDefaultIsNotRewritten) {
+    Param_SetBrightness(42);
+    NvsConfig_SaveDirtyParameters();
+    Param_ResetBrightness();
+    NvsConfig_SaveDirtyParameters();  // flash now holds the default
+    Param_SetBrightness(7);
+    Param_ResetBrightness();
+
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 0);
+    EXPECT_EQ(NvsConfig_GetSuppressedWriteCount("Brightness"), 1U);
+}
+
+TEST_F(WearLevelFixture, RealChangeIsStillWritten) {
+    Param_SetBrightness(42);
+    NvsConfig_SaveDirtyParameters();
+    Param_SetBrightness(43);
+
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 1);
+    EXPECT_EQ(NvsConfig_GetSuppressedWriteCount("Brightness"), 0U);
+}
+
+TEST_F(WearLevelFixture, FailedCommitForgetsStoredValue) {
+    Param_SetBrightness(42);
+    NvsConfig_SaveDirtyParameters();
+    Param_SetBrightness(7);
+    g_mock_nvs_commit_ret = ESP_FAIL;
+    NvsConfig_SaveDirtyParameters();  // flash may now hold 42 or 7
+    g_mock_nvs_commit_ret = ESP_OK;
+    Param_SetBrightness(42);
+
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 1);
+    EXPECT_EQ(NvsConfig_GetSuppressedWriteCount("Brightness"), 0U);
+}
+
+TEST_F(WearLevelFixture, ArrayRestoredBeforeSaveIsNotRewritten) {
+    const int32_t a[6] = {1, 2, 3, 4, 5, 6};
+    const int32_t b[6] = {1, 2, 3, 4, 5, 7};
+    Param_SetCalibPoints(a, 6);
+    NvsConfig_SaveDirtyParameters();
+    Param_SetCalibPoints(b, 6);
+    Param_SetCalibPoints(a, 6);
+
+    g_mock_nvs_set_blob_calls = 0;
+    NvsConfig_SaveDirtyParameters();
+    EXPECT_EQ(g_mock_nvs_set_blob_calls, 0);
+    EXPECT_EQ(NvsConfig_GetSuppressedWriteCount("CalibPoints"), 1U);
+}